@@ -20,14 +20,14 @@
 
 #include "PathSearchUtility.h"
 #include "PathSearchApp.h"
+#include "../SearchLibrary/SolutionValidator.h"
+#include "../SearchLibrary/Tracer.h"
 
 #ifdef _MSC_VER
 #include <io.h>
 #include <fcntl.h>
 #endif
 
-std::vector<fullsail_ai::Tile const*> tempSolution;
-
 PathSearchGlobals* PathSearchGlobals::instance_ = 0;
 
 PathSearchGlobals::PathSearchGlobals() : min_radius_(4.0), flags_(0)
@@ -120,13 +120,27 @@ void drawGrid(TileMap const& tile_map, POINT const& offset, int grid_width, int
 	);
 	hexagon[0].y = -(hexagon[3].y = hexagon[2].y << 1);
 
-	for (unsigned int i = 0; i < 6; ++i)
+	int corner_count = 6;
+
+	if ((tile_map.getTopology() == SQUARE_FOUR) || (tile_map.getTopology() == SQUARE_EIGHT))
+	{
+		// Square tiles sit as far apart as rows of hexagons, so they are drawn that tall.
+		LONG const half_height = static_cast<LONG>(radius * sqrt(3.0) / 2.0);
+
+		hexagon[0].x = hexagon[3].x = hexagon[1].x;
+		hexagon[1].x = hexagon[2].x = hexagon[4].x;
+		hexagon[0].y = hexagon[1].y = -half_height;
+		hexagon[2].y = hexagon[3].y = half_height;
+		corner_count = 4;
+	}
+
+	for (int i = 0; i < corner_count; ++i)
 	{
 		hexagon[i].x += offset.x;
 		hexagon[i].y += offset.y;
 	}
 
-	if (HRGN hex_region = CreatePolygonRgn(hexagon, 6, WINDING))
+	if (HRGN hex_region = CreatePolygonRgn(hexagon, corner_count, WINDING))
 	{
 		int row_start;
 		int row_end;
@@ -291,9 +305,9 @@ void PathSearchInterface::endRedrawSearchProgress(POINT const& offset, int width
 }
 
 GroundUpPathSearch::GroundUpPathSearch(TileMap& tiles)
-	: search_(), tile_map_(tiles), start_tile_(0), goal_tile_(0), frequency_(), elapsed_time_(0.0)
+	: search_(), counting_search_(), tile_map_(tiles), start_tile_(0), goal_tile_(0), frequency_(), elapsed_time_(0.0)
 	, iteration_count_(0), start_row_(0), start_column_(0), goal_row_(0), goal_column_(0), myTimeStep(0), myFastTimeStep(5000), myNumberofRounds(1)
-	, is_initializable_(true)
+	, myExpansionStep(0), is_initializable_(true)
 {
 	QueryPerformanceFrequency(&frequency_);
 }
@@ -308,12 +322,14 @@ void GroundUpPathSearch::resetParameters()
 	start_row_ = start_column_ = goal_row_ = goal_column_ = myTimeStep = 0;
 	myFastTimeStep = 5000;
 	myNumberofRounds = 1;
+	myExpansionStep = 0;
 	start_tile_ = goal_tile_ = 0;
 }
 
 void GroundUpPathSearch::shutdownSearch()
 {
 	search_.shutdown();
+	counting_search_.shutdown();
 }
 
 bool GroundUpPathSearch::read(basic_ifstream<TCHAR>& input_stream)
@@ -337,11 +353,12 @@ bool GroundUpPathSearch::read(basic_ifstream<TCHAR>& input_stream)
 void GroundUpPathSearch::initialize()
 {
 	search_.initialize(&tile_map_);
+	counting_search_.initialize(&tile_map_);
 }
 
 int GroundUpPathSearch::getInputCount() const
 {
-	return 7;
+	return 8;
 }
 
 void GroundUpPathSearch::displayInput(NMLVDISPINFO* list_view_display_info) const
@@ -447,6 +464,20 @@ void GroundUpPathSearch::displayInput(NMLVDISPINFO* list_view_display_info) cons
 
 			break;
 		}
+
+		case 7:
+		{
+			if (item.iSubItem)
+			{
+				_stprintf(item.pszText, _T("%s"), _T("Regular Run Expansions (0 = use time)"));
+			}
+			else
+			{
+				_stprintf(item.pszText, _T("%i"), myExpansionStep);
+			}
+
+			break;
+		}
 	}
 }
 
@@ -589,6 +620,12 @@ bool GroundUpPathSearch::updateInput(NMLVDISPINFO const* list_view_display_info)
 				_stscanf(item.pszText, _T("%i"), &myNumberofRounds);
 				break;
 			}
+
+		case 7:
+			{
+				_stscanf(item.pszText, _T("%i"), &myExpansionStep);
+				break;
+			}
 	}
 
 	return false;
@@ -599,8 +636,6 @@ void GroundUpPathSearch::resetSearch()
 	if(mybHasEntered)
 		search_.exit();
 
-		tempSolution.clear();
-
 	tile_map_.resetTileDrawing();
 	elapsed_time_ = 0.0;
 	iteration_count_ = 0;
@@ -635,8 +670,28 @@ void GroundUpPathSearch::runSearch(void/*long long timeslice*/)
 {
 	if(!search_.isDone())
 	{
-		search_.update(static_cast<long>(myTimeStep/*timeslice*/));
+		// A fixed number of expansions per frame makes every run step through the same states.
+		if (myExpansionStep)
+		{
+			search_.updateExpansions(myExpansionStep);
+		}
+		else
+		{
+			search_.update(static_cast<long>(myTimeStep/*timeslice*/));
+		}
+
 		++iteration_count_;
+
+		if (search_.isDone())
+		{
+			fullsail_ai::algorithms::Histogram const& overruns = search_.getOverrunHistogram();
+
+			std::cout << "slices: " << search_.getSliceExpansionHistogram().getCount()
+			          << ", overrun p50/p99/max (us): " << overruns.getValueAtPercentile(50.0) / 1e3
+			          << '/' << overruns.getValueAtPercentile(99.0) / 1e3 << '/'
+			          << overruns.getMaximum() / 1e3 << ", poll interval: "
+			          << search_.getPollInterval() << std::endl;
+		}
 	}
 }
 
@@ -654,6 +709,54 @@ BOOL GroundUpPathSearch::shouldEnableTimeRun() const
 	return isReady() ? TRUE : FALSE;
 }
 
+// Validates the solution of a finished search and reports the first problem found, if any.
+static void showSolutionErrors(HWND window_handle, TileMap const& tile_map,
+                               PathView solution, Tile const* start_tile,
+                               Tile const* goal_tile)
+{
+	// The smallest budget still keeps the one reference field this check needs.
+	SolutionValidator validator(tile_map, 1);
+	SolutionReport const report = validator.validate(solution, start_tile->getRow(),
+	                                                 start_tile->getColumn(), goal_tile->getRow(),
+	                                                 goal_tile->getColumn());
+	TCHAR const* message = 0;
+
+	switch (report.error)
+	{
+	case SolutionReport::VALID:
+		return;
+	case SolutionReport::MISSING_PATH:
+		message = _T("isDone() returned true and getSolution() returned a vector size 0");
+		break;
+	case SolutionReport::UNEXPECTED_PATH:
+		message = _T("getSolution() returned a path although the goal is unreachable!");
+		break;
+	case SolutionReport::WRONG_START:
+		message = _T("The first tile is not the start!");
+		break;
+	case SolutionReport::WRONG_GOAL:
+		message = _T("The last tile is not the goal!");
+		break;
+	case SolutionReport::FOREIGN_TILE:
+		message = _T("A node is not a tile of this map!");
+		break;
+	case SolutionReport::IMPASSABLE_TILE:
+		message = _T("A node is impassable!");
+		break;
+	case SolutionReport::NOT_ADJACENT:
+		message = _T("A node is not next to its parent!");
+		break;
+	case SolutionReport::SUBOPTIMAL:
+		message = _T("The path costs more than the shortest path!");
+		break;
+	case SolutionReport::BELOW_OPTIMAL:
+		message = _T("The path costs less than the shortest path!");
+		break;
+	}
+
+	MessageBox(window_handle, message, _T("Solution Checker"), MB_OK);
+}
+
 using namespace std::placeholders;
 void GroundUpPathSearch::timeSearch()
 {
@@ -664,14 +767,12 @@ void GroundUpPathSearch::timeSearch()
 
 	initializeSearch();
 
-	tempSolution.clear();
 	mybHasEntered = true;
 	QueryPerformanceCounter(&time_start);
 	for(unsigned int i = 0; i < myNumberofRounds; i++)
 	{
 		search_.enter(start_row_, start_column_, goal_row_, goal_column_);
 		search_.update(myFastTimeStep);//Run for this long or else
-		tempSolution = search_.getSolution();//don't like this but it solves functionality
 		search_.exit();
 	}
 
@@ -683,56 +784,24 @@ void GroundUpPathSearch::timeSearch()
 		) / frequency_.QuadPart;
 	std::cout << "average elapsed time: " << elapsed_time_/(double)myNumberofRounds << std::endl;
 
-	if(search_.isDone())
-	{
-		if(tempSolution.size())
-		{
-			if (tempSolution.back() != start_tile_)
-			{
-				MessageBox(NULL,
-					_T("The first tile is not the start!"),
-					_T("Solution Checker"), MB_OK);
-			}
+	// The timed rounds run the engine without counters; one more untimed round counts.
+	counting_search_.enter(start_row_, start_column_, goal_row_, goal_column_);
+	counting_search_.update(myFastTimeStep);
 
-			if (tempSolution.front() != goal_tile_)
-			{
-				MessageBox(NULL, _T("The last tile is not the goal!"),
-					_T("Solution Checker"), MB_OK);
-			}
+	fullsail_ai::algorithms::SearchCounters const counters = counting_search_.getCounters();
 
-			deque<double> v1, v2;
-			std::size_t i = tempSolution.size();
-			double dare = tile_map_.getTileRadius() * (1 << 1);
-			double down = dare * dare;
+	counting_search_.exit();
 
-			dare = down + 0.00001;
-			down -= 0.00001;
+	std::cout << "expanded: " << counters.expanded_count << ", generated: "
+	          << counters.generated_count << ", reopened: " << counters.reopened_count
+	          << ", open peak: " << counters.open_peak_size << ", heap push/pop/remove: "
+	          << counters.push_count << '/' << counters.pop_count << '/' << counters.remove_count
+	          << std::endl;
 
-			while (--i)
-			{
-				v1.clear();
-				v2.clear();
-				v1.push_back(tempSolution[i - 1]->getYCoordinate());
-				v2.push_front(tempSolution[i]->getXCoordinate());
-				v1.push_back(tempSolution[i - 1]->getXCoordinate());
-				v2.push_front(tempSolution[i]->getYCoordinate());
-				transform(v1.begin(), v1.end(), v2.begin(), v1.begin(), minus<double>());
-				transform(v1.begin(), v1.end(), v2.begin(), [](double input) -> double { return pow(input, 2); });
-				v1.back() = v2.back() + v2.front();
-
-				if (dare < v1.back() || v1.back() < down)
-				{
-					MessageBox(NULL, _T("A node is not next to its parent!"),
-						_T("Solution Checker"), MB_OK);
-				}
-			}
-		}
-		else/* if(!mybTimeSearch) *///!done
-		{
-			MessageBox(NULL,
-				_T("isDone() returned true and getSolution() returned a vector size 0"),
-				_T("Solution Checker"), MB_OK);
-		}
+	if(search_.isDone())
+	{
+		// The last round's path stays with the engine until the next enter(); nothing is copied.
+		showSolutionErrors(NULL, tile_map_, search_.getSolutionView(), start_tile_, goal_tile_);
 	}
 	else
 	{
@@ -748,55 +817,8 @@ void GroundUpPathSearch::checkSolution(HWND window_handle) const
 {
 	if (search_.isDone())
 	{
-		tempSolution = search_.getSolution();
-		if(tempSolution.size())
-		{
-			if (tempSolution.back() != start_tile_)
-			{
-				MessageBox(window_handle,
-					_T("The first tile is not the start!"),
-					_T("Solution Checker"), MB_OK);
-			}
-
-			if (tempSolution.front() != goal_tile_)
-			{
-				MessageBox(window_handle, _T("The last tile is not the goal!"),
-					_T("Solution Checker"), MB_OK);
-			}
-
-			deque<double> v1, v2;
-			std::size_t i = tempSolution.size();
-			double dare = tile_map_.getTileRadius() * (1 << 1);
-			double down = dare * dare;
-
-			dare = down + 0.00001;
-			down -= 0.00001;
-
-			while (--i)
-			{
-				v1.clear();
-				v2.clear();
-				v1.push_back(tempSolution[i - 1]->getYCoordinate());
-				v2.push_front(tempSolution[i]->getXCoordinate());
-				v1.push_back(tempSolution[i - 1]->getXCoordinate());
-				v2.push_front(tempSolution[i]->getYCoordinate());
-				transform(v1.begin(), v1.end(), v2.begin(), v1.begin(), minus<double>());
-				transform(v1.begin(), v1.end(), v2.begin(), [](double input) -> double { return pow(input, 2); });
-				v1.back() = v2.back() + v2.front();
-
-				if (dare < v1.back() || v1.back() < down)
-				{
-					MessageBox(NULL, _T("A node is not next to its parent!"),
-						_T("Solution Checker"), MB_OK);
-				}
-			}
-		}
-		else/* if(!mybTimeSearch) *///!done
-		{
-			MessageBox(NULL,
-				_T("isDone() returned true and getSolution() returned a vector size 0"),
-				_T("Solution Checker"), MB_OK);
-		}
+		showSolutionErrors(window_handle, tile_map_, search_.getSolutionView(), start_tile_,
+		                   goal_tile_);
 	}
 	
 }
@@ -880,9 +902,10 @@ void GroundUpPathSearch::displaySearchProgress(POINT const& offset, int width, i
 		}
 	}
 
-	if (/*!path.empty()*/search_.isDone())
+	// A reset search still reports the outcome of the one it exited; draw only the current one.
+	if (!is_initializable_ && search_.isDone())
 	{
-		vector<Tile const*> const& path = tempSolution;
+		PathView const path = search_.getSolutionView();
 		if(path.size())
 		{
 			RECT rectangle;
@@ -1403,9 +1426,14 @@ void PathSearchApp::openFile_(HWND window_handle, TCHAR* file_name)
 		planner_sync_.acquire();
 		PathSearchGlobals::getInstance()->turnOff(PathSearchGlobals::SHOW_SEARCH_RUNNING);
 		current_planner_->resetSearch();
-		tempSolution.clear();
 
-		bool has_read = load(input_file_stream, ground_up_tile_map_);
+		bool has_read;
+
+		{
+			TraceScope scope("load");
+
+			has_read = load(input_file_stream, ground_up_tile_map_);
+		}
 
 		if (has_read)
 		{
@@ -1903,6 +1931,8 @@ BOOL PathSearchApp::initializeApplication(HINSTANCE application_handle, int n_cm
 
 void PathSearchApp::renderFull_()
 {
+	TraceScope scope("render");
+
 	BitBlt(
 	    tile_grid_buffer_context_handle_
 	  , 0
@@ -2648,7 +2678,13 @@ void PathSearchApp::paintTileGrid(HDC device_context_handle) const
 	);
 
 	planner_sync_.acquire();
-	paintAllTileGrid_(device_context_handle, buffer_context_handle);
+
+	{
+		TraceScope scope("render");
+
+		paintAllTileGrid_(device_context_handle, buffer_context_handle);
+	}
+
 	planner_sync_.release();
 	SelectObject(buffer_context_handle, old_bitmap_handle);
 	DeleteObject(buffer_bitmap_handle);
@@ -2689,6 +2725,14 @@ int APIENTRY _tWinMain(HINSTANCE application_handle,
 	ios::sync_with_stdio();
 //#endif
 
+	// Set PATHSEARCH_TRACE to a file name to record a Chrome trace of the session.
+	char const* trace_file = getenv("PATHSEARCH_TRACE");
+
+	if (trace_file && *trace_file)
+	{
+		Tracer::enable();
+	}
+
 	// Perform application initialization:
 	if (!PathSearchApp::getInstance()->initializeApplication(application_handle, n_cmd_show))
 	{
@@ -2715,6 +2759,15 @@ int APIENTRY _tWinMain(HINSTANCE application_handle,
 
 	PathSearchApp::deleteInstance();
 	PathSearchGlobals::deleteInstance();
+
+	if (Tracer::isEnabled())
+	{
+		ofstream trace_output(trace_file);
+
+		Tracer::disable();
+		Tracer::write(trace_output);
+	}
+
 	return static_cast<int>(msg.wParam);
 }
 
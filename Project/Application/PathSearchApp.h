@@ -224,6 +224,7 @@ struct PathSearchInterface
 class GroundUpPathSearch : public PathSearchInterface
 {
 	fullsail_ai::algorithms::PathSearch search_;
+	fullsail_ai::algorithms::InstrumentedPathSearch counting_search_;
 	fullsail_ai::TileMap&               tile_map_;
 	fullsail_ai::Tile const*            start_tile_;
 	fullsail_ai::Tile const*            goal_tile_;
@@ -237,6 +238,7 @@ class GroundUpPathSearch : public PathSearchInterface
 	unsigned int						myTimeStep;
 	unsigned int						myFastTimeStep;
 	unsigned int						myNumberofRounds;
+	unsigned int						myExpansionStep;
 	bool                                is_initializable_;	
 	std::vector<fullsail_ai::Tile const*> path2; 
 
@@ -3,20 +3,74 @@
 // Updated by Jeremiah Blanchard, 2016
 #pragma once
 
+#include <algorithm>
 #include <istream>
+#include <locale>
+#include <string>
 #include "../TileLibrary/TileMap.h"
 
+//! \brief The name of each <code>fullsail_ai::TileTopology</code> in a map file, in
+//! enumeration order.
+static char const* const TOPOLOGY_NAMES[] = { "hex-odd-r", "hex-even-r", "square-4", "square-8" };
+
+//! \brief Returns the name of the specified topology in a map file.
+inline char const* getTopologyName(fullsail_ai::TileTopology topology)
+{
+	return TOPOLOGY_NAMES[topology];
+}
+
+//! \brief Sets <code>topology</code> to the topology with the specified name and returns
+//! <code>true</code>, or returns <code>false</code> if no topology has that name.
+template <typename CharT, typename CharTraits, typename Allocator>
+bool parseTopology(std::basic_string<CharT,CharTraits,Allocator> const& name,
+                   fullsail_ai::TileTopology& topology)
+{
+	for (int i = 0; i < static_cast<int>(sizeof(TOPOLOGY_NAMES) / sizeof(TOPOLOGY_NAMES[0])); ++i)
+	{
+		std::string const candidate(TOPOLOGY_NAMES[i]);
+
+		if ((name.size() == candidate.size())
+		 && std::equal(candidate.begin(), candidate.end(), name.begin()))
+		{
+			topology = static_cast<fullsail_ai::TileTopology>(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 //! \brief Loads a tile map from the specified input stream.
+//!
+//! The map may start with the name of its topology (see <code>getTopologyName()</code>);
+//! maps that do not are laid out in <code>fullsail_ai::HEX_ODD_ROWS</code>.
 template <typename CharT, typename CharTraits>
 bool load(std::basic_istream<CharT,CharTraits>& input_stream, fullsail_ai::TileMap& tile_map)
 {
 	tile_map.reset();
 
+	fullsail_ai::TileTopology topology = fullsail_ai::HEX_ODD_ROWS;
 	int row_count = 0;
 	int column_count = 0;
 
+	typename CharTraits::int_type const first = (input_stream >> std::ws).peek();
+
+	// Maps written before other topologies were supported start with the row count.
+	if (!CharTraits::eq_int_type(first, CharTraits::eof())
+	 && std::isalpha(CharTraits::to_char_type(first), input_stream.getloc()))
+	{
+		std::basic_string<CharT,CharTraits> name;
+
+		if (!(input_stream >> name) || !parseTopology(name, topology))
+		{
+			return false;
+		}
+	}
+
 	if (!input_stream.eof() && (input_stream >> row_count) && (input_stream >> column_count))
 	{
+		// Set before the tiles exist, so that each one is placed once, as it is added.
+		tile_map.setTopology(topology);
 		tile_map.createTileArray(row_count, column_count);
 
 		int row;
@@ -40,7 +94,6 @@ bool load(std::basic_istream<CharT,CharTraits>& input_stream, fullsail_ai::TileM
 			}
 		}
 
-		tile_map.computeWeightSumSquared();
 		return true;
 	}
 
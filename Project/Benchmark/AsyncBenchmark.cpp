@@ -0,0 +1,145 @@
+// Runs the scenarios of one map through AsyncPathSearch and reports throughput, latency and
+// worker utilisation, cancelling a share of the queries to mimic agents that die or retarget.
+//
+// usage: AsyncBenchmark [--workers N] [--repeat N] [--cancel-every N] [scenario file]
+//
+// With --cancel-every N, every Nth query is cancelled right after it is submitted.  Every path
+// that is found is checked against the optimal cost in the scenario file.
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "../SearchLibrary/AsyncPathSearch.h"
+#include "../SearchLibrary/Scenario.h"
+#include "../SearchLibrary/SolutionValidator.h"
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+typedef chrono::high_resolution_clock Clock;
+
+int main(int argc, char* argv[])
+{
+	size_t worker_count = thread::hardware_concurrency() ? thread::hardware_concurrency() : 4;
+	int repeat_count = 20;
+	size_t cancel_every = 0;
+	string scenario_file = "./Data/hex113x083.txt.scen";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--workers") && (i + 1 < argc))
+		{
+			worker_count = static_cast<size_t>(atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--repeat") && (i + 1 < argc))
+		{
+			repeat_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--cancel-every") && (i + 1 < argc))
+		{
+			cancel_every = static_cast<size_t>(atoi(argv[++i]));
+		}
+		else
+		{
+			scenario_file = argv[i];
+		}
+	}
+
+	ifstream scenario_input(scenario_file.c_str());
+	vector<Scenario> scenarios;
+
+	if (!loadScenarios(scenario_input, scenarios) || scenarios.empty())
+	{
+		cerr << "Could not read " << scenario_file << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Only the scenarios on the first map are run.
+	size_t const slash = scenario_file.find_last_of("/\\");
+	string const map_file = ((slash == string::npos) ? string() : scenario_file.substr(0, slash + 1))
+	                      + scenarios[0].map_name;
+	ifstream map_input(map_file.c_str());
+	TileMap tile_map;
+
+	if (!load(map_input, tile_map))
+	{
+		cerr << "Could not load " << map_file << endl;
+		return EXIT_FAILURE;
+	}
+
+	vector<Scenario const*> queries;
+	vector<shared_future<AsyncPathSearch::Result> > futures;
+	atomic<unsigned long long> callback_count(0);
+	AsyncPathSearch pool(tile_map, worker_count);
+	Clock::time_point const start = Clock::now();
+
+	for (int round = 0; round < repeat_count; ++round)
+	{
+		for (size_t i = 0; i < scenarios.size(); ++i)
+		{
+			Scenario const& scenario = scenarios[i];
+
+			if (scenario.map_name != scenarios[0].map_name)
+			{
+				continue;
+			}
+
+			AsyncPathSearch::CancellationToken token;
+
+			queries.push_back(&scenario);
+			futures.push_back(pool.submit(
+				scenario.start_row
+			  , scenario.start_column
+			  , scenario.goal_row
+			  , scenario.goal_column
+			  , token
+			  , [&callback_count](AsyncPathSearch::Result const&) { ++callback_count; }
+			));
+
+			if (cancel_every && !(queries.size() % cancel_every))
+			{
+				token.cancel();
+			}
+		}
+	}
+
+	SolutionValidator validator(tile_map, 0);
+	size_t wrong_count = 0;
+
+	for (size_t i = 0; i < futures.size(); ++i)
+	{
+		AsyncPathSearch::Result const& result = futures[i].get();
+
+		if ((result.status != AsyncPathSearch::Result::CANCELLED)
+		 && (validator.validate(result.solution, *queries[i]).error != SolutionReport::VALID))
+		{
+			++wrong_count;
+		}
+	}
+
+	double const seconds = chrono::duration<double>(Clock::now() - start).count();
+	AsyncPathSearch::Statistics const statistics = pool.getStatistics();
+	Histogram const& latency = statistics.latency_nanoseconds;
+
+	cout << scenarios[0].map_name << ": " << pool.getWorkerCount() << " workers, "
+	     << statistics.submitted_count << " submitted, " << statistics.completed_count
+	     << " completed, " << statistics.cancelled_count << " cancelled, " << callback_count
+	     << " callbacks, " << wrong_count << " wrong paths" << endl
+	     << fixed << setprecision(0) << "throughput " << futures.size() / seconds
+	     << " queries/s, utilisation " << setprecision(1) << statistics.utilization * 100.0
+	     << "%, latency p50/p95/p99/max " << setprecision(3)
+	     << latency.getValueAtPercentile(50.0) / 1e6 << '/'
+	     << latency.getValueAtPercentile(95.0) / 1e6 << '/'
+	     << latency.getValueAtPercentile(99.0) / 1e6 << '/' << latency.getMaximum() / 1e6
+	     << " ms" << endl;
+	return wrong_count ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+// Measures how parallel delta-stepping scales with the number of threads on a large generated
+// map, against the sequential Dijkstra search that builds a flow field.
+//
+// usage: DeltaSteppingBenchmark [--rows N] [--columns N] [--width N] [--threads N] [--sources N]
+//
+// Thread counts double from 1 up to --threads, 32 by default.  Every distance map is checked
+// against the flow field of the same source.
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../TileLibrary/TileMap.h"
+#include "../SearchLibrary/DeltaStepping.h"
+#include "../SearchLibrary/FlowField.h"
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+typedef chrono::high_resolution_clock Clock;
+
+static double millisecondsSince(Clock::time_point const& start)
+{
+	return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+	int row_count = 2048;
+	int column_count = 2048;
+	unsigned int bucket_width = DeltaStepping::DEFAULT_BUCKET_WIDTH;
+	size_t max_thread_count = 32;
+	int source_count = 3;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "--rows"))
+		{
+			row_count = atoi(argv[i + 1]);
+		}
+		else if (!strcmp(argv[i], "--columns"))
+		{
+			column_count = atoi(argv[i + 1]);
+		}
+		else if (!strcmp(argv[i], "--width"))
+		{
+			bucket_width = static_cast<unsigned int>(atoi(argv[i + 1]));
+		}
+		else if (!strcmp(argv[i], "--threads"))
+		{
+			max_thread_count = static_cast<size_t>(atoi(argv[i + 1]));
+		}
+		else if (!strcmp(argv[i], "--sources"))
+		{
+			source_count = atoi(argv[i + 1]);
+		}
+	}
+
+	mt19937 generator(2016);
+	uniform_int_distribution<int> weight_distribution(0, 9);
+	TileMap tile_map;
+
+	tile_map.setRadius(1.0);
+	tile_map.createTileArray(row_count, column_count);
+
+	for (int row = 0; row < row_count; ++row)
+	{
+		for (int column = 0; column < column_count; ++column)
+		{
+			// Roughly one tile in ten is an obstacle.
+			tile_map.addTile(row, column, static_cast<unsigned char>(weight_distribution(generator)));
+		}
+	}
+
+	uniform_int_distribution<int> row_distribution(0, row_count - 1);
+	uniform_int_distribution<int> column_distribution(0, column_count - 1);
+	vector<int> source_rows, source_columns;
+
+	while (static_cast<int>(source_rows.size()) < source_count)
+	{
+		int const row = row_distribution(generator);
+		int const column = column_distribution(generator);
+
+		if (tile_map.getTile(row, column)->getWeight())
+		{
+			source_rows.push_back(row);
+			source_columns.push_back(column);
+		}
+	}
+
+	vector<FlowField> fields(source_rows.size());
+	Clock::time_point const start = Clock::now();
+
+	for (size_t i = 0; i < fields.size(); ++i)
+	{
+		fields[i].build(tile_map, source_rows[i], source_columns[i]);
+	}
+
+	double const dijkstra_time = millisecondsSince(start) / fields.size();
+	vector<unsigned int> distances(static_cast<size_t>(row_count) * column_count);
+	bool is_wrong = false;
+
+	cout << "map: " << row_count << 'x' << column_count << ", bucket width " << bucket_width
+	     << endl << fixed << setprecision(1) << "dijkstra: " << dijkstra_time << " ms" << endl;
+
+	for (size_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2)
+	{
+		DeltaStepping solver(thread_count, bucket_width);
+		double time = 0.0;
+		size_t wrong_count = 0;
+
+		for (size_t i = 0; i < fields.size(); ++i)
+		{
+			Clock::time_point const begin = Clock::now();
+
+			solver.compute(tile_map, source_rows[i], source_columns[i], &distances[0],
+			               DeltaStepping::TO_SOURCE);
+			time += millisecondsSince(begin);
+
+			for (int row = 0; row < row_count; ++row)
+			{
+				for (int column = 0; column < column_count; ++column)
+				{
+					if (distances[row * column_count + column] != fields[i].getCost(row, column))
+					{
+						++wrong_count;
+					}
+				}
+			}
+		}
+
+		time /= fields.size();
+		is_wrong = is_wrong || wrong_count;
+		cout << setw(2) << thread_count << " threads: " << setw(8) << time << " ms, speed-up "
+		     << setprecision(2) << dijkstra_time / time << setprecision(1) << ", "
+		     << solver.getBucketCount() << " buckets, " << solver.getStepCount() << " steps, "
+		     << wrong_count << " wrong distances" << endl;
+	}
+
+	return is_wrong ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,235 @@
+// Compares the runtime and peak memory of the A*, Fringe Search, IDA* and SMA* engines on the
+// shipped maps and on larger generated maps.
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "../SearchLibrary/PathSearch.h"
+#include "../SearchLibrary/FringeSearch.h"
+#include "../SearchLibrary/IDAStarSearch.h"
+#include "../SearchLibrary/SMAStarSearch.h"
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+typedef chrono::high_resolution_clock Clock;
+
+struct Query
+{
+	int start_row, start_column, goal_row, goal_column;
+};
+
+struct Result
+{
+	double milliseconds;
+	size_t peak_memory;
+	unsigned int cost;
+	bool timed_out;
+};
+
+// IDA* re-searches the map once per distinct f-cost, which takes far too long on large maps with
+// many different weights, so every query gets at most this long.
+static double const QUERY_TIME_LIMIT = 2000.0;
+
+// SMA* gets a fixed 1 MB, as it would inside a fixed-size worker.
+static size_t const SMA_STAR_BYTE_BUDGET = 1 << 20;
+
+static unsigned int getCost(PathView path)
+{
+	unsigned int cost = 0;
+
+	for (size_t i = 0; i + 1 < path.size(); ++i)
+	{
+		cost += path[i]->getWeight();
+	}
+
+	return cost;
+}
+
+template <typename Engine>
+static Result run(Engine& engine, Query const& query)
+{
+	Result result;
+	Clock::time_point const start = Clock::now();
+
+	engine.enter(query.start_row, query.start_column, query.goal_row, query.goal_column);
+	result.timed_out = false;
+
+	while (!engine.isDone())
+	{
+		engine.update(100);
+
+		if (QUERY_TIME_LIMIT < chrono::duration<double, milli>(Clock::now() - start).count())
+		{
+			result.timed_out = true;
+			break;
+		}
+	}
+
+	result.milliseconds = chrono::duration<double, milli>(Clock::now() - start).count();
+	result.cost = getCost(engine.getSolutionView());
+	result.peak_memory = engine.getPeakMemoryUsage();
+	engine.exit();
+	return result;
+}
+
+static void generate(TileMap& tile_map, int row_count, int column_count, mt19937& generator)
+{
+	uniform_int_distribution<int> weight_distribution(1, 5);
+	uniform_real_distribution<double> obstacle_distribution(0.0, 1.0);
+
+	tile_map.reset();
+	tile_map.setRadius(1.0);
+	tile_map.createTileArray(row_count, column_count);
+
+	for (int row = 0; row < row_count; ++row)
+	{
+		for (int column = 0; column < column_count; ++column)
+		{
+			tile_map.addTile(row, column, static_cast<unsigned char>(
+				(obstacle_distribution(generator) < 0.1) ? 0 : weight_distribution(generator)
+			));
+		}
+	}
+}
+
+static void benchmark(string const& name, TileMap& tile_map, int query_count, mt19937& generator)
+{
+	PathSearch a_star;
+	FringeSearch fringe;
+	IDAStarSearch ida_star;
+	SMAStarSearch sma_star(SMAStarSearch::getNodeBudget(SMA_STAR_BYTE_BUDGET));
+	uniform_int_distribution<int> row_distribution(0, tile_map.getRowCount() - 1);
+	uniform_int_distribution<int> column_distribution(0, tile_map.getColumnCount() - 1);
+	Result totals[4] = {};
+	size_t peaks[4] = {};
+	int timeouts[4] = {};
+	int out_of_memory = 0;
+	int mismatches = 0;
+	int solved = 0;
+
+	a_star.initialize(&tile_map);
+	fringe.initialize(&tile_map);
+	ida_star.initialize(&tile_map);
+	sma_star.initialize(&tile_map);
+
+	for (int attempt = 0; (solved < query_count) && (attempt < query_count * 20); ++attempt)
+	{
+		Query query;
+
+		query.start_row = row_distribution(generator);
+		query.start_column = column_distribution(generator);
+		query.goal_row = row_distribution(generator);
+		query.goal_column = column_distribution(generator);
+
+		if (!tile_map.getTile(query.start_row, query.start_column)->getWeight()
+		 || !tile_map.getTile(query.goal_row, query.goal_column)->getWeight())
+		{
+			continue;
+		}
+
+		Result results[4];
+
+		results[0] = run(a_star, query);
+
+		// Skip unreachable goals; they only measure how fast each engine floods a component.
+		if (results[0].timed_out || !results[0].cost)
+		{
+			continue;
+		}
+
+		results[1] = run(fringe, query);
+		results[2] = run(ida_star, query);
+		results[3] = run(sma_star, query);
+		++solved;
+
+		for (int engine = 0; engine < 4; ++engine)
+		{
+			totals[engine].milliseconds += results[engine].milliseconds;
+
+			if (peaks[engine] < results[engine].peak_memory)
+			{
+				peaks[engine] = results[engine].peak_memory;
+			}
+
+			if (results[engine].timed_out)
+			{
+				++timeouts[engine];
+			}
+			else if (!results[engine].cost)
+			{
+				// Only SMA* comes back empty-handed on a reachable goal, when it runs out of memory.
+				++out_of_memory;
+			}
+			else if (results[engine].cost != results[0].cost)
+			{
+				++mismatches;
+			}
+		}
+	}
+
+	char const* const engine_names[4] = { "A*", "Fringe", "IDA*+TT", "SMA*" };
+
+	for (int engine = 0; engine < 4; ++engine)
+	{
+		cout << left << setw(24) << name << setw(10) << engine_names[engine] << right
+		     << setw(14) << fixed << setprecision(3) << (solved ? totals[engine].milliseconds / solved : 0.0)
+		     << setw(16) << peaks[engine] << setw(10) << timeouts[engine] << endl;
+	}
+
+	if (out_of_memory)
+	{
+		cout << name << ": SMA* ran out of memory on " << out_of_memory << " queries" << endl;
+	}
+
+	if (mismatches)
+	{
+		cout << name << ": " << mismatches << " paths were not optimal!" << endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int const query_count = (1 < argc) ? atoi(argv[1]) : 20;
+	char const* const map_names[] =
+	{
+		"hex006x006", "hex014x006", "hex035x035", "hex054x045", "hex098x098", "hex113x083"
+	};
+	mt19937 generator(2016);
+	TileMap tile_map;
+
+	cout << left << setw(24) << "map" << setw(10) << "engine" << right
+	     << setw(14) << "avg ms" << setw(16) << "peak bytes" << setw(10) << "timeouts" << endl;
+
+	for (size_t i = 0; i < sizeof(map_names) / sizeof(map_names[0]); ++i)
+	{
+		ifstream input((string("./Data/") + map_names[i] + ".txt").c_str());
+
+		if (load(input, tile_map))
+		{
+			benchmark(map_names[i], tile_map, query_count, generator);
+		}
+		else
+		{
+			cerr << "Could not load ./Data/" << map_names[i] << ".txt" << endl;
+		}
+	}
+
+	int const sizes[] = { 256, 512, 1024 };
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+	{
+		generate(tile_map, sizes[i], sizes[i], generator);
+		benchmark("generated " + to_string(sizes[i]) + 'x' + to_string(sizes[i]), tile_map,
+		          query_count, generator);
+	}
+
+	return 0;
+}
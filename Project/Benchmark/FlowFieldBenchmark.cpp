@@ -0,0 +1,239 @@
+// Measures how long it takes to build and repair flow fields on large generated maps.
+//
+// The same edits are reported to a ComponentIndex, which is checked against one built from
+// scratch after every edit.  So are many more edits to a small map of every topology, with
+// nearly half its tiles impassable, where edits join and split components all the time.  A
+// mismatch fails the benchmark.
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "../TileLibrary/TileMap.h"
+#include "../SearchLibrary/ComponentIndex.h"
+#include "../SearchLibrary/FlowField.h"
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+typedef chrono::high_resolution_clock Clock;
+
+static double millisecondsSince(Clock::time_point const& start)
+{
+	return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Returns true if both indices split the tiles into the same components.  The labels are node
+// indices, and an index that was edited holds at most about twice as many nodes as tiles.
+static bool isSamePartition(ComponentIndex const& index, ComponentIndex const& fresh,
+                            int tile_count, vector<int>& forward, vector<int>& backward)
+{
+	if (index.getComponentCount() != fresh.getComponentCount())
+	{
+		return false;
+	}
+
+	forward.assign(2 * static_cast<size_t>(tile_count) + 2, -1);
+	backward.assign(2 * static_cast<size_t>(tile_count) + 2, -1);
+
+	for (int tile = 0; tile < tile_count; ++tile)
+	{
+		int const label = index.getComponent(tile);
+		int const fresh_label = fresh.getComponent(tile);
+
+		if ((label < 0) || (fresh_label < 0))
+		{
+			if (label != fresh_label)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		if (forward[label] < 0)
+		{
+			forward[label] = fresh_label;
+		}
+
+		if (backward[fresh_label] < 0)
+		{
+			backward[fresh_label] = label;
+		}
+
+		if ((forward[label] != fresh_label) || (backward[fresh_label] != label))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Toggles random tiles of a small map between impassable and passable, reports each edit to a
+// component index, and returns the number of edits after which it disagreed with a fresh one.
+static int checkComponentEdits(TileTopology topology, mt19937& generator)
+{
+	int const side = 128;
+	int const edit_count = 2000;
+	uniform_int_distribution<int> weight_distribution(0, 19);
+	uniform_int_distribution<int> side_distribution(0, side - 1);
+	TileMap tile_map;
+
+	tile_map.setRadius(1.0);
+	tile_map.setTopology(topology);
+	tile_map.createTileArray(side, side);
+
+	for (int row = 0; row < side; ++row)
+	{
+		for (int column = 0; column < side; ++column)
+		{
+			int const weight = weight_distribution(generator);
+
+			// Nine tiles in twenty are obstacles, close to where the passable ones stop
+			// spanning the map.
+			tile_map.addTile(row, column, static_cast<unsigned char>((weight < 9) ? 0 : weight - 8));
+		}
+	}
+
+	ComponentIndex component_index(tile_map);
+	vector<int> forward;
+	vector<int> backward;
+	double update_time = 0.0;
+	int mismatch_count = 0;
+
+	component_index.build(1);
+
+	for (int i = 0; i < edit_count; ++i)
+	{
+		int const row = side_distribution(generator);
+		int const column = side_distribution(generator);
+		int const weight = weight_distribution(generator);
+		unsigned char const old_weight = tile_map.setTileWeight(row, column,
+			static_cast<unsigned char>((weight < 9) ? 0 : weight - 8));
+		Clock::time_point const start = Clock::now();
+
+		component_index.onTileWeightChanged(row, column, old_weight);
+		update_time += millisecondsSince(start);
+
+		ComponentIndex fresh_index(tile_map);
+
+		fresh_index.build(1);
+
+		if (!component_index.isCurrent()
+		 || !isSamePartition(component_index, fresh_index, side * side, forward, backward))
+		{
+			++mismatch_count;
+		}
+	}
+
+	cout << getTopologyName(topology) << ' ' << side << 'x' << side << ": " << edit_count
+	     << " edits, average component update time (ms): " << update_time / edit_count
+	     << ", rebuilds: " << component_index.getRebuildCount() - 1 << ", components: "
+	     << component_index.getComponentCount() << ", mismatches: " << mismatch_count << endl;
+	return mismatch_count;
+}
+
+int main(int argc, char* argv[])
+{
+	int const row_count = (1 < argc) ? atoi(argv[1]) : 1000;
+	int const column_count = (2 < argc) ? atoi(argv[2]) : 1000;
+	int const field_count = (3 < argc) ? atoi(argv[3]) : 8;
+	mt19937 generator(2016);
+	uniform_int_distribution<int> weight_distribution(0, 9);
+	TileMap tile_map;
+
+	tile_map.setRadius(1.0);
+	tile_map.createTileArray(row_count, column_count);
+
+	for (int row = 0; row < row_count; ++row)
+	{
+		for (int column = 0; column < column_count; ++column)
+		{
+			// Roughly one tile in ten is an obstacle.
+			tile_map.addTile(row, column, static_cast<unsigned char>(weight_distribution(generator)));
+		}
+	}
+
+	uniform_int_distribution<int> row_distribution(0, row_count - 1);
+	uniform_int_distribution<int> column_distribution(0, column_count - 1);
+	FlowFieldCache cache(tile_map, static_cast<size_t>(field_count) * row_count * column_count * 5);
+	ComponentIndex component_index(tile_map);
+	double build_time = 0.0;
+	double repair_time = 0.0;
+	double component_time = 0.0;
+
+	for (int i = 0; i < field_count; ++i)
+	{
+		int goal_row, goal_column;
+
+		do
+		{
+			goal_row = row_distribution(generator);
+			goal_column = column_distribution(generator);
+		}
+		while (!tile_map.getTile(goal_row, goal_column)->getWeight());
+
+		Clock::time_point const start = Clock::now();
+
+		cache.acquire(goal_row, goal_column);
+		build_time += millisecondsSince(start);
+	}
+
+	int const repair_count = 100;
+	int const tile_count = row_count * column_count;
+	int mismatch_count = 0;
+	vector<int> forward;
+	vector<int> backward;
+
+	component_index.build();
+
+	for (int i = 0; i < repair_count; ++i)
+	{
+		int const row = row_distribution(generator);
+		int const column = column_distribution(generator);
+		unsigned char const old_weight = tile_map.setTileWeight(row, column,
+			static_cast<unsigned char>(weight_distribution(generator)));
+		Clock::time_point const start = Clock::now();
+
+		cache.onTileWeightChanged(row, column, old_weight);
+		repair_time += millisecondsSince(start);
+
+		Clock::time_point const component_start = Clock::now();
+
+		component_index.onTileWeightChanged(row, column, old_weight);
+		component_time += millisecondsSince(component_start);
+
+		ComponentIndex fresh_index(tile_map);
+
+		fresh_index.build();
+
+		if (!component_index.isCurrent()
+		 || !isSamePartition(component_index, fresh_index, tile_count, forward, backward))
+		{
+			++mismatch_count;
+		}
+	}
+
+	cout << "map: " << row_count << 'x' << column_count << endl;
+	cout << "average field build time (ms): " << build_time / field_count << endl;
+	cout << "average repair time per field (ms): "
+	     << repair_time / (static_cast<double>(repair_count) * cache.getFieldCount()) << endl;
+	cout << "cache memory (bytes): " << cache.getMemoryUsage() << endl;
+	cout << "average component update time (ms): " << component_time / repair_count << endl;
+	cout << "component rebuilds: " << component_index.getRebuildCount() - 1 << " of "
+	     << repair_count << " edits, components: " << component_index.getComponentCount()
+	     << ", mismatches: " << mismatch_count << endl;
+
+	TileTopology const topologies[] = { HEX_ODD_ROWS, HEX_EVEN_ROWS, SQUARE_FOUR, SQUARE_EIGHT };
+
+	for (size_t i = 0; i < sizeof(topologies) / sizeof(topologies[0]); ++i)
+	{
+		mismatch_count += checkComponentEdits(topologies[i], generator);
+	}
+
+	return mismatch_count ? 1 : 0;
+}
@@ -0,0 +1,659 @@
+// Times the building blocks every search relies on: PriorityQueue operations, TileMap access,
+// map construction, load(), setTileWeight() and the evaluation of a tile's neighbours
+// on the maps in ./Data.  Results are written as JSON so
+// that runs from different versions or backends can be diffed side by side.
+//
+// usage: MicroBenchmark [--label NAME] [--output FILE] [--filter TEXT] [--repeat N] [--quick]
+//
+// Every result is keyed by a stable "name" of the form group/operation/variant/size.  Times are
+// nanoseconds per operation over --repeat samples; the median is the figure to compare.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "../PriorityQueue.h"
+#include "../TileLibrary/TileMap.h"
+#include "../SearchLibrary/HexNeighborKernel.h"
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+typedef chrono::high_resolution_clock Clock;
+
+// Each sample runs a case often enough to cover at least this many operations, so that small
+// sizes are not dominated by clock overhead.
+static long long const MIN_OPERATIONS_PER_SAMPLE = 200000;
+
+struct Options
+{
+	string label;
+	string output_file;
+	string filter;
+	int repeat_count;
+	bool is_quick;
+};
+
+struct Result
+{
+	string group;
+	string operation;
+	string variant;
+	long long size;
+	long long operation_count;
+	vector<double> nanoseconds_per_operation;
+	double bytes_per_operation;
+};
+
+struct QueueNode
+{
+	unsigned int cost;
+};
+
+// Keeps results alive so that the compiler cannot drop the work being timed.
+static volatile unsigned long long sink;
+
+static bool isCheaper(QueueNode* const& lhs, QueueNode* const& rhs)
+{
+	// PriorityQueue::front() returns the element that sorts last.
+	return rhs->cost < lhs->cost;
+}
+
+static string getName(Result const& result)
+{
+	ostringstream name;
+
+	name << result.group << '/' << result.operation << '/' << result.variant << '/' << result.size;
+	return name.str();
+}
+
+//! Runs setup() untimed and body() timed until a sample covers enough operations, collects
+//! --repeat samples, and records the result unless the filter excludes it.
+template <typename Setup, typename Body>
+static void measure(Options const& options, vector<Result>& results, Result result, Setup setup,
+                    Body body)
+{
+	if (getName(result).find(options.filter) == string::npos)
+	{
+		return;
+	}
+
+	long long const round_count
+		= max(1LL, MIN_OPERATIONS_PER_SAMPLE / max(1LL, result.operation_count));
+
+	for (int sample = 0; sample <= options.repeat_count; ++sample)
+	{
+		double nanoseconds = 0.0;
+
+		for (long long round = 0; round < round_count; ++round)
+		{
+			setup();
+
+			Clock::time_point const start = Clock::now();
+
+			body();
+			nanoseconds += chrono::duration<double, nano>(Clock::now() - start).count();
+		}
+
+		// The first sample warms caches and the allocator and is not kept.
+		if (sample)
+		{
+			result.nanoseconds_per_operation.push_back(nanoseconds
+			                                           / (round_count * result.operation_count));
+		}
+	}
+
+	cerr << getName(result) << endl;
+	results.push_back(result);
+}
+
+static Result makeResult(char const* group, char const* operation, string const& variant,
+                         long long size, long long operation_count)
+{
+	Result result;
+
+	result.group = group;
+	result.operation = operation;
+	result.variant = variant;
+	result.size = size;
+	result.operation_count = operation_count;
+	result.bytes_per_operation = 0.0;
+	return result;
+}
+
+static vector<unsigned int> makeCosts(string const& distribution, int size, mt19937& generator)
+{
+	vector<unsigned int> costs(size);
+
+	for (int i = 0; i < size; ++i)
+	{
+		if (distribution == "ascending")
+		{
+			costs[i] = i;
+		}
+		else if (distribution == "descending")
+		{
+			costs[i] = size - i;
+		}
+		else if (distribution == "ties")
+		{
+			// A* on uniform terrain produces long runs of equal f costs.
+			costs[i] = generator() % 8;
+		}
+		else
+		{
+			costs[i] = generator();
+		}
+	}
+
+	return costs;
+}
+
+static void benchmarkPriorityQueue(Options const& options, vector<Result>& results)
+{
+	int const sizes[] = { 64, 1024, 16384 };
+	char const* const distributions[] = { "random", "ascending", "descending", "ties" };
+	int const size_count = options.is_quick ? 2 : 3;
+	mt19937 generator(2016);
+
+	for (int s = 0; s < size_count; ++s)
+	{
+		int const size = sizes[s];
+
+		for (size_t d = 0; d < sizeof(distributions) / sizeof(distributions[0]); ++d)
+		{
+			vector<unsigned int> const costs = makeCosts(distributions[d], size, generator);
+			vector<QueueNode> nodes(size);
+			PriorityQueue<QueueNode*> queue(isCheaper);
+
+			for (int i = 0; i < size; ++i)
+			{
+				nodes[i].cost = costs[i];
+			}
+
+			measure(options, results, makeResult("priority_queue", "push", distributions[d], size, size),
+				[&]() { queue.clear(); },
+				[&]()
+				{
+					for (int i = 0; i < size; ++i)
+					{
+						queue.push(&nodes[i]);
+					}
+				});
+
+			measure(options, results, makeResult("priority_queue", "pop", distributions[d], size, size),
+				[&]()
+				{
+					queue.clear();
+
+					for (int i = 0; i < size; ++i)
+					{
+						queue.push(&nodes[i]);
+					}
+				},
+				[&]()
+				{
+					unsigned long long sum = 0;
+
+					while (!queue.empty())
+					{
+						sum += queue.front()->cost;
+						queue.pop();
+					}
+
+					sink = sum;
+				});
+
+			// Removes a sixteenth of the nodes at random, as re-opening nodes would.
+			int const remove_count = max(1, size / 16);
+			vector<QueueNode*> victims(remove_count);
+
+			for (int i = 0; i < remove_count; ++i)
+			{
+				victims[i] = &nodes[generator() % size];
+			}
+
+			measure(options, results,
+			        makeResult("priority_queue", "remove", distributions[d], size, remove_count),
+				[&]()
+				{
+					queue.clear();
+
+					for (int i = 0; i < size; ++i)
+					{
+						queue.push(&nodes[i]);
+					}
+				},
+				[&]()
+				{
+					for (int i = 0; i < remove_count; ++i)
+					{
+						queue.remove(victims[i]);
+					}
+				});
+		}
+	}
+}
+
+static void fillMap(TileMap& tile_map, int side, vector<unsigned char> const& weights)
+{
+	tile_map.createTileArray(side, side);
+
+	for (int row = 0; row < side; ++row)
+	{
+		for (int column = 0; column < side; ++column)
+		{
+			tile_map.addTile(row, column, weights[row * side + column]);
+		}
+	}
+}
+
+static void benchmarkTileMap(Options const& options, vector<Result>& results)
+{
+	int const sides[] = { 256, 1024, 2048 };
+	int const side_count = options.is_quick ? 2 : 3;
+	mt19937 generator(2016);
+
+	for (int s = 0; s < side_count; ++s)
+	{
+		int const side = sides[s];
+		long long const tile_count = static_cast<long long>(side) * side;
+		vector<unsigned char> weights(tile_count);
+		TileMap tile_map;
+
+		for (long long i = 0; i < tile_count; ++i)
+		{
+			weights[i] = static_cast<unsigned char>(generator() % 10);
+		}
+
+		measure(options, results, makeResult("tile_map", "build", "create_add", side, tile_count),
+			[&]() { tile_map.reset(); },
+			[&]() { fillMap(tile_map, side, weights); });
+
+		fillMap(tile_map, side, weights);
+
+		measure(options, results, makeResult("tile_map", "get_tile", "row_major", side, tile_count),
+			[]() {},
+			[&]()
+			{
+				unsigned long long sum = 0;
+
+				for (int row = 0; row < side; ++row)
+				{
+					for (int column = 0; column < side; ++column)
+					{
+						sum += tile_map.getTile(row, column)->getWeight();
+					}
+				}
+
+				sink = sum;
+			});
+
+		measure(options, results, makeResult("tile_map", "get_tile", "column_major", side, tile_count),
+			[]() {},
+			[&]()
+			{
+				unsigned long long sum = 0;
+
+				for (int column = 0; column < side; ++column)
+				{
+					for (int row = 0; row < side; ++row)
+					{
+						sum += tile_map.getTile(row, column)->getWeight();
+					}
+				}
+
+				sink = sum;
+			});
+
+		long long const lookup_count = min(tile_count, 1LL << 20);
+		vector<int> lookups(lookup_count * 2);
+
+		for (long long i = 0; i < lookup_count; ++i)
+		{
+			lookups[2 * i] = generator() % side;
+			lookups[2 * i + 1] = generator() % side;
+		}
+
+		measure(options, results, makeResult("tile_map", "get_tile", "random", side, lookup_count),
+			[]() {},
+			[&]()
+			{
+				unsigned long long sum = 0;
+
+				for (long long i = 0; i < lookup_count; ++i)
+				{
+					sum += tile_map.getTile(lookups[2 * i], lookups[2 * i + 1])->getWeight();
+				}
+
+				sink = sum;
+			});
+
+		// Walls a tile off and clears it again, so the map is as it was after every run.
+		measure(options, results,
+		        makeResult("tile_map", "set_tile_weight", "random", side, 2 * lookup_count),
+			[]() {},
+			[&]()
+			{
+				for (long long i = 0; i < lookup_count; ++i)
+				{
+					int const row = lookups[2 * i];
+					int const column = lookups[2 * i + 1];
+
+					tile_map.setTileWeight(row, column, tile_map.setTileWeight(row, column, 0));
+				}
+
+				sink = tile_map.getStatistics().getWeightSum();
+			});
+
+		// The text a map file of this size would hold, parsed from memory so disk speed does
+		// not enter into it.
+		ostringstream text;
+
+		text << side << ' ' << side << '\n';
+
+		for (int row = 0; row < side; ++row)
+		{
+			if (row & 1)
+			{
+				text << ' ';
+			}
+
+			for (int column = 0; column < side; ++column)
+			{
+				text << static_cast<unsigned int>(weights[row * side + column])
+				     << ((column + 1 < side) ? ' ' : '\n');
+			}
+		}
+
+		string const map_text = text.str();
+		Result load_result = makeResult("load", "parse", "text", side, tile_count);
+
+		load_result.bytes_per_operation = static_cast<double>(map_text.size()) / tile_count;
+		tile_map.reset();
+
+		measure(options, results, load_result,
+			[]() {},
+			[&]()
+			{
+				istringstream input(map_text);
+
+				sink = load(input, tile_map);
+			});
+	}
+}
+
+static void benchmarkNeighbors(Options const& options, vector<Result>& results)
+{
+	char const* const map_names[] =
+	{
+		"hex006x006", "hex014x006", "hex035x035", "hex054x045", "hex098x098", "hex113x083"
+	};
+	size_t const map_count = sizeof(map_names) / sizeof(map_names[0]);
+
+	for (size_t m = options.is_quick ? map_count - 2 : 0; m < map_count; ++m)
+	{
+		string const map_file = string("./Data/") + map_names[m] + ".txt";
+		ifstream map_input(map_file.c_str());
+		TileMap tile_map;
+
+		if (!load(map_input, tile_map))
+		{
+			cerr << "Could not load " << map_file << endl;
+			continue;
+		}
+
+		// Every passable tile is expanded once, towards the middle of the map.
+		int const goal_row = tile_map.getRowCount() / 2;
+		int const goal_column = tile_map.getColumnCount() / 2;
+		vector<int> locations;
+		HexNeighborKernel kernel;
+
+		for (int row = 0; row < tile_map.getRowCount(); ++row)
+		{
+			for (int column = 0; column < tile_map.getColumnCount(); ++column)
+			{
+				if (tile_map.getTile(row, column)->getWeight())
+				{
+					locations.push_back(row);
+					locations.push_back(column);
+				}
+			}
+		}
+
+		kernel.build(tile_map);
+		kernel.setGoal(goal_row, goal_column);
+
+		long long const tile_count = static_cast<long long>(locations.size() / 2);
+
+		measure(options, results, makeResult("neighbors", "evaluate", "get_tile", tile_count,
+		                                     tile_count),
+			[]() {},
+			[&]()
+			{
+				unsigned long long sum = 0;
+
+				for (size_t i = 0; i < locations.size(); i += 2)
+				{
+					for (int direction = 0; direction < HEX_DIRECTION_COUNT; ++direction)
+					{
+						// The exported accessor, as every search called it before TileMapView.
+						int const* offset = HEX_DIRECTION_OFFSETS[locations[i] & 1][direction];
+						Tile const* const tile = tile_map.getTile(locations[i] + offset[0],
+						                                          locations[i + 1] + offset[1]);
+
+						if (tile && tile->getWeight())
+						{
+							sum += i + tile->getWeight() + getHexDistance(tile->getRow(),
+								tile->getColumn(), goal_row, goal_column);
+						}
+					}
+				}
+
+				sink = sum;
+			});
+
+		measure(options, results, makeResult("neighbors", "evaluate", "view", tile_count,
+		                                     tile_count),
+			[]() {},
+			[&]()
+			{
+				TileMapView const view = tile_map.getView();
+				unsigned long long sum = 0;
+
+				for (size_t i = 0; i < locations.size(); i += 2)
+				{
+					for (int direction = 0; direction < HEX_DIRECTION_COUNT; ++direction)
+					{
+						Tile const* const tile
+							= getHexNeighbor(view, locations[i], locations[i + 1], direction);
+
+						if (tile && tile->getWeight())
+						{
+							sum += i + tile->getWeight() + getHexDistance(tile->getRow(),
+								tile->getColumn(), goal_row, goal_column);
+						}
+					}
+				}
+
+				sink = sum;
+			});
+
+		measure(options, results, makeResult("neighbors", "evaluate", "kernel_scalar", tile_count,
+		                                     tile_count),
+			[]() {},
+			[&]()
+			{
+				unsigned long long sum = 0;
+				HexNeighbors neighbors;
+
+				for (size_t i = 0; i < locations.size(); i += 2)
+				{
+					kernel.evaluateScalar(locations[i], locations[i + 1],
+					                      static_cast<unsigned int>(i), neighbors);
+
+					for (int n = 0; n < neighbors.count; ++n)
+					{
+						sum += neighbors.given_costs[n] + neighbors.estimates[n];
+					}
+				}
+
+				sink = sum;
+			});
+
+#ifdef PATHSEARCH_HAS_SSE2
+		measure(options, results, makeResult("neighbors", "evaluate", "kernel_sse2", tile_count,
+		                                     tile_count),
+			[]() {},
+			[&]()
+			{
+				unsigned long long sum = 0;
+				HexNeighbors neighbors;
+
+				for (size_t i = 0; i < locations.size(); i += 2)
+				{
+					kernel.evaluateSse2(locations[i], locations[i + 1],
+					                    static_cast<unsigned int>(i), neighbors);
+
+					for (int n = 0; n < neighbors.count; ++n)
+					{
+						sum += neighbors.given_costs[n] + neighbors.estimates[n];
+					}
+				}
+
+				sink = sum;
+			});
+#endif
+	}
+}
+
+static double getMedian(vector<double> samples)
+{
+	sort(samples.begin(), samples.end());
+
+	size_t const middle = samples.size() / 2;
+
+	return (samples.size() & 1) ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+}
+
+static void writeJson(ostream& output, Options const& options, vector<Result> const& results)
+{
+	output << "{\n  \"label\": \"" << options.label << "\",\n"
+	       << "  \"repeat\": " << options.repeat_count << ",\n"
+#ifdef NDEBUG
+	       << "  \"build\": \"release\",\n"
+#else
+	       << "  \"build\": \"debug\",\n"
+#endif
+	       << "  \"results\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		Result const& result = results[i];
+		double const median = getMedian(result.nanoseconds_per_operation);
+
+		output << (i ? "," : "") << "\n    { \"name\": \"" << getName(result) << "\", \"group\": \""
+		       << result.group << "\", \"operation\": \"" << result.operation
+		       << "\", \"variant\": \"" << result.variant << "\", \"size\": " << result.size
+		       << ", \"operations\": " << result.operation_count
+		       << ", \"ns_per_op_median\": " << median << ", \"ns_per_op_min\": "
+		       << *min_element(result.nanoseconds_per_operation.begin(),
+		                       result.nanoseconds_per_operation.end())
+		       << ", \"ns_per_op_max\": "
+		       << *max_element(result.nanoseconds_per_operation.begin(),
+		                       result.nanoseconds_per_operation.end());
+
+		if (result.bytes_per_operation)
+		{
+			// Bytes per nanosecond are gigabytes per second; scale to megabytes.
+			output << ", \"mb_per_s\": " << result.bytes_per_operation / median * 1000.0;
+		}
+
+		output << " }";
+	}
+
+	output << "\n  ]\n}\n";
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options)
+{
+	options.label = "baseline";
+	options.repeat_count = 5;
+	options.is_quick = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--label") && (i + 1 < argc))
+		{
+			options.label = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--output") && (i + 1 < argc))
+		{
+			options.output_file = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--filter") && (i + 1 < argc))
+		{
+			options.filter = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--repeat") && (i + 1 < argc))
+		{
+			options.repeat_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--quick"))
+		{
+			options.is_quick = true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return (0 < options.repeat_count)
+	    && (options.label.find_first_of("\"\\") == string::npos);
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		cerr << "usage: " << argv[0] << " [--label NAME] [--output FILE] [--filter TEXT]"
+		     << " [--repeat N] [--quick]" << endl;
+		return EXIT_FAILURE;
+	}
+
+	vector<Result> results;
+
+	benchmarkPriorityQueue(options, results);
+	benchmarkTileMap(options, results);
+	benchmarkNeighbors(options, results);
+
+	if (options.output_file.empty())
+	{
+		writeJson(cout, options, results);
+	}
+	else
+	{
+		ofstream output(options.output_file.c_str());
+
+		writeJson(output, options, results);
+
+		if (!output)
+		{
+			cerr << "Could not write " << options.output_file << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
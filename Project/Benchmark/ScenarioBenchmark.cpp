@@ -0,0 +1,731 @@
+// Runs scenario files against every search engine and reports latency percentiles, expansion
+// throughput and whether each path has the optimal cost.
+//
+// usage: ScenarioBenchmark [--engine astar|astar-counters|fringe|ida|sma|hda|all|best-first|NAME]
+//                          [--warmup N] [--repeat N] [--timeslice MS] [--threads N]
+//                          [--path-cache BYTES]
+//                          [scenario files...]
+//
+// Without scenario files, every *.txt.scen file in ./Data is run, in name order.
+// "astar-counters" runs the instrumented A* engine, which is not part of "all", and prints what
+// its counters recorded over all of its runs, warm-up included, after its row.  Both A* engines
+// also print how far their update() calls overran the time slice, which defaults to 100 ms.
+// "hda" runs hash-distributed A* on --threads workers, one per hardware thread by default.
+// "best-first" runs every engine of BestFirstRegistry.h, and any of their names runs just that
+// one; a path costlier than optimal counts as wrong only if it exceeds the engine's bound.
+// With --path-cache BYTES, the astar engine runs with a path cache of that size and prints its
+// counters after its row.  The scenarios are then run again on a fresh copy of the map between
+// edits of tiles on their paths, each reported to the cache, and every answer of the cached
+// engine is checked against an engine without the cache; a mismatch fails the benchmark.
+// When both run on a map, bf-euclid must expand fewer nodes than dijkstra, or the benchmark
+// reports the map and exits with a non-zero status.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "../SearchLibrary/PathSearch.h"
+#include "../SearchLibrary/BestFirstRegistry.h"
+#include "../SearchLibrary/FringeSearch.h"
+#include "../SearchLibrary/HDAStarSearch.h"
+#include "../SearchLibrary/IDAStarSearch.h"
+#include "../SearchLibrary/PathCache.h"
+#include "../SearchLibrary/SMAStarSearch.h"
+#include "../SearchLibrary/Scenario.h"
+#include "../SearchLibrary/SolutionValidator.h"
+
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+typedef chrono::high_resolution_clock Clock;
+
+// IDA* takes far too long on some queries, so every run gets at most this long.
+static double const QUERY_TIME_LIMIT = 2000.0;
+
+enum EngineId
+{
+	ASTAR,
+	FRINGE,
+	IDA_STAR,
+	SMA_STAR,
+	ASTAR_COUNTERS,
+	HDA_STAR
+};
+
+// One engine --engine knows by name, besides those of BestFirstRegistry.h.
+struct EngineEntry
+{
+	char const* name;
+	EngineId id;
+	bool is_in_all;
+};
+
+static EngineEntry const ENGINES[] =
+{
+	{ "astar", ASTAR, true },
+	{ "fringe", FRINGE, true },
+	{ "ida", IDA_STAR, true },
+	{ "sma", SMA_STAR, true },
+	{ "astar-counters", ASTAR_COUNTERS, false },
+	{ "hda", HDA_STAR, true }
+};
+
+static size_t const ENGINE_COUNT = sizeof(ENGINES) / sizeof(ENGINES[0]);
+
+// The number of tile edits between rounds of scenarios in the path cache check.
+static int const PATH_CACHE_EDIT_COUNT = 20;
+
+// SMA* gets a fixed 1 MB, as it would inside a fixed-size worker.
+static size_t const SMA_STAR_BYTE_BUDGET = 1 << 20;
+
+struct Report
+{
+	vector<double> milliseconds;
+	double total_milliseconds;
+	unsigned long long expansion_count;
+	int run_count;
+	int wrong_cost_count;
+	int no_path_count;
+	int timeout_count;
+};
+
+static bool hasSuffix(string const& name, string const& suffix)
+{
+	return (suffix.size() <= name.size())
+	    && !name.compare(name.size() - suffix.size(), suffix.size(), suffix);
+}
+
+// Appends the path of every scenario file in the specified directory, sorted by name.
+static void findScenarioFiles(string const& directory, vector<string>& scenario_files)
+{
+	string const suffix = ".txt.scen";
+	vector<string> names;
+
+#ifdef _MSC_VER
+	_finddata_t entry;
+	intptr_t const handle = _findfirst((directory + "/*" + suffix).c_str(), &entry);
+
+	if (handle != -1)
+	{
+		// Wildcards also match longer extensions on Windows, so the suffix is checked again.
+		do
+		{
+			if (hasSuffix(entry.name, suffix))
+			{
+				names.push_back(entry.name);
+			}
+		}
+		while (!_findnext(handle, &entry));
+
+		_findclose(handle);
+	}
+#else
+	if (DIR* const stream = opendir(directory.c_str()))
+	{
+		while (dirent const* const entry = readdir(stream))
+		{
+			if (hasSuffix(entry->d_name, suffix))
+			{
+				names.push_back(entry->d_name);
+			}
+		}
+
+		closedir(stream);
+	}
+#endif
+
+	sort(names.begin(), names.end());
+
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		scenario_files.push_back(directory + '/' + names[i]);
+	}
+}
+
+static bool isKnownEngine(string const& name)
+{
+	if ((name == "all") || (name == "best-first"))
+	{
+		return true;
+	}
+
+	for (size_t i = 0; i < ENGINE_COUNT; ++i)
+	{
+		if (name == ENGINES[i].name)
+		{
+			return true;
+		}
+	}
+
+	for (size_t i = 0; i < BEST_FIRST_ENGINE_COUNT; ++i)
+	{
+		if (name == BEST_FIRST_ENGINES[i].name)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void printUsage(char const* program)
+{
+	cerr << "usage: " << program << " [options] [scenario files...]" << endl
+	     << "Runs every *.txt.scen file in ./Data if no scenario file is given." << endl
+	     << "  --engine <name>                astar, fringe, ida, sma, hda, astar-counters, all"
+	     << endl
+	     << "                                 (default), best-first, or one of the engines below"
+	     << endl;
+
+	for (size_t i = 0; i < BEST_FIRST_ENGINE_COUNT; ++i)
+	{
+		cerr << "      " << left << setw(27) << BEST_FIRST_ENGINES[i].name
+		     << BEST_FIRST_ENGINES[i].description << endl;
+	}
+
+	cerr << right
+	     << "  --warmup <n>                   untimed runs of each scenario (default 1)" << endl
+	     << "  --repeat <n>                   timed runs of each scenario (default 5)" << endl
+	     << "  --timeslice <ms>               milliseconds per update() call (default 100)" << endl
+	     << "  --threads <n>                  worker threads of the HDA* engine (default: one"
+	     << endl
+	     << "                                 per hardware thread)" << endl
+	     << "  --path-cache <bytes>           run astar with a path cache of that size, then"
+	     << endl
+	     << "                                 check it across tile edits" << endl;
+}
+
+static double getPercentile(vector<double> const& sorted, double percentile)
+{
+	if (sorted.empty())
+	{
+		return 0.0;
+	}
+
+	// Nearest rank.
+	size_t const rank = static_cast<size_t>(percentile / 100.0 * sorted.size() + 0.999999);
+
+	return sorted[(rank ? rank : 1) - 1];
+}
+
+template <typename Engine>
+static void run(Engine& engine, TileMap& tile_map, vector<Scenario> const& scenarios,
+                int warmup_count, int repeat_count, long timeslice, Report& report,
+                double cost_bound = 1.0)
+{
+	SolutionValidator validator(tile_map, 0);
+
+	engine.initialize(&tile_map);
+
+	for (size_t i = 0; i < scenarios.size(); ++i)
+	{
+		Scenario const& scenario = scenarios[i];
+
+		for (int round = -warmup_count; round < repeat_count; ++round)
+		{
+			Clock::time_point const start = Clock::now();
+			bool is_timed_out = false;
+
+			engine.enter(scenario.start_row, scenario.start_column, scenario.goal_row,
+			             scenario.goal_column);
+
+			while (!engine.isDone())
+			{
+				engine.update(timeslice);
+
+				if (QUERY_TIME_LIMIT < chrono::duration<double, milli>(Clock::now() - start).count())
+				{
+					is_timed_out = true;
+					break;
+				}
+			}
+
+			double const milliseconds = chrono::duration<double, milli>(Clock::now() - start).count();
+			PathView const solution = engine.getSolutionView();
+			size_t const expansion_count = engine.getExpansionCount();
+
+			engine.exit();
+
+			if (round < 0)
+			{
+				continue;
+			}
+
+			report.milliseconds.push_back(milliseconds);
+			report.total_milliseconds += milliseconds;
+			report.expansion_count += expansion_count;
+			++report.run_count;
+
+			if (is_timed_out)
+			{
+				++report.timeout_count;
+				continue;
+			}
+
+			SolutionReport const solution_report = validator.validate(solution, scenario);
+			SolutionReport::Error const error = solution_report.error;
+
+			if (error == SolutionReport::MISSING_PATH)
+			{
+				++report.no_path_count;
+			}
+			else if ((error == SolutionReport::SUBOPTIMAL) && (cost_bound != 1.0))
+			{
+				if (cost_bound && (cost_bound * solution_report.optimal_cost < solution_report.cost))
+				{
+					++report.wrong_cost_count;
+				}
+			}
+			else if (error != SolutionReport::VALID)
+			{
+				++report.wrong_cost_count;
+			}
+		}
+	}
+
+	engine.shutdown();
+}
+
+static void printCounters(SearchCounters const& counters)
+{
+	cout << "    expanded " << counters.expanded_count << ", generated " << counters.generated_count
+	     << ", reopened " << counters.reopened_count << ", open peak " << counters.open_peak_size
+	     << ", push/pop/remove " << counters.push_count << '/' << counters.pop_count << '/'
+	     << counters.remove_count << setprecision(3) << ", heuristic "
+	     << counters.heuristic_nanoseconds / 1e6 << " ms, expansion "
+	     << counters.expansion_nanoseconds / 1e6 << " ms, reconstruction "
+	     << counters.reconstruction_nanoseconds / 1e6 << " ms, allocated "
+	     << counters.allocated_bytes << " bytes" << endl;
+}
+
+template <typename Counters>
+static void printSlices(BasicPathSearch<Counters> const& search)
+{
+	Histogram const& overruns = search.getOverrunHistogram();
+	Histogram const& expansions = search.getSliceExpansionHistogram();
+
+	cout << setprecision(1) << "    slices " << expansions.getCount() << ", overrun p50/p99/max "
+	     << overruns.getValueAtPercentile(50.0) / 1e3 << '/'
+	     << overruns.getValueAtPercentile(99.0) / 1e3 << '/' << overruns.getMaximum() / 1e3
+	     << " us over " << overruns.getCount() << " full slices, expansions per slice p50/p99 "
+	     << expansions.getValueAtPercentile(50.0) << '/' << expansions.getValueAtPercentile(99.0)
+	     << ", poll interval " << search.getPollInterval() << endl;
+}
+
+static void print(string const& name, string const& engine, Report& report)
+{
+	sort(report.milliseconds.begin(), report.milliseconds.end());
+
+	double const seconds = report.total_milliseconds / 1000.0;
+
+	cout << left << setw(20) << name << setw(16) << engine << right << setw(7) << report.run_count
+	     << fixed << setprecision(3)
+	     << setw(11) << getPercentile(report.milliseconds, 50.0)
+	     << setw(11) << getPercentile(report.milliseconds, 95.0)
+	     << setw(11) << getPercentile(report.milliseconds, 99.0)
+	     << setprecision(0) << setw(14) << (seconds ? report.expansion_count / seconds : 0.0)
+	     << setw(8) << report.wrong_cost_count << setw(9) << report.no_path_count
+	     << setw(10) << report.timeout_count << endl;
+}
+
+static void printStatistics(PathCache::Statistics const& statistics)
+{
+	cout << setprecision(3) << "    path cache hits " << statistics.hit_count << ", subpath hits "
+	     << statistics.subpath_hit_count << ", misses " << statistics.miss_count << ", hit rate "
+	     << statistics.getHitRate() << ", insertions " << statistics.insertion_count
+	     << ", evictions " << statistics.eviction_count << ", invalidations "
+	     << statistics.invalidation_count << ", entries " << statistics.entry_count << ", bytes "
+	     << statistics.bytes_used << endl;
+}
+
+static unsigned int getCost(PathView const& solution)
+{
+	unsigned int cost = 0;
+
+	for (size_t i = 0; i + 1 < solution.size(); ++i)
+	{
+		cost += solution[i]->getWeight();
+	}
+
+	return cost;
+}
+
+// Runs the scenarios on a fresh copy of the map, reweighting a tile of a cached path between
+// rounds as FlowFieldBenchmark does, and returns false if the cached engine ever disagrees with
+// an engine that always searches.
+static bool checkPathCacheEdits(string const& map_file, vector<Scenario> const& scenarios,
+                                size_t path_cache_bytes)
+{
+	ifstream map_input(map_file.c_str());
+	TileMap tile_map;
+
+	if (!load(map_input, tile_map))
+	{
+		cerr << "Could not load " << map_file << endl;
+		return false;
+	}
+
+	PathCache path_cache(path_cache_bytes);
+	PathSearch cached_search;
+	PathSearch search;
+	mt19937_64 generator(2016);
+	double cached_milliseconds = 0.0;
+	double milliseconds = 0.0;
+	int mismatch_count = 0;
+	int const column_count = tile_map.getColumnCount();
+	vector<Tile const*> last_path;
+
+	cached_search.initialize(&tile_map);
+	cached_search.setPathCache(&path_cache);
+	search.initialize(&tile_map);
+
+	for (int edit = 0; edit <= PATH_CACHE_EDIT_COUNT; ++edit)
+	{
+		// Mostly raise a tile's weight, which only costs the paths across it; every fourth edit
+		// lowers it to 1, which costs every entry.
+		if (edit && !last_path.empty())
+		{
+			Tile const* const tile = last_path[generator() % last_path.size()];
+			unsigned int const raised_weight
+				= tile->getWeight() + 1 + static_cast<unsigned int>(generator() % 4);
+			unsigned char const new_weight
+				= static_cast<unsigned char>((edit % 4) ? min(raised_weight, 255u) : 1u);
+			unsigned char const old_weight
+				= tile_map.setTileWeight(tile->getRow(), tile->getColumn(), new_weight);
+
+			path_cache.onTileWeightChanged(tile->getRow() * column_count + tile->getColumn(),
+			                               old_weight, new_weight, tile_map.getVersion());
+		}
+
+		for (size_t i = 0; i < scenarios.size(); ++i)
+		{
+			Scenario const& scenario = scenarios[i];
+			Clock::time_point const start = Clock::now();
+
+			cached_search.enter(scenario.start_row, scenario.start_column, scenario.goal_row,
+			                    scenario.goal_column);
+
+			while (!cached_search.isDone())
+			{
+				cached_search.update(0);
+			}
+
+			Clock::time_point const middle = Clock::now();
+
+			search.enter(scenario.start_row, scenario.start_column, scenario.goal_row,
+			             scenario.goal_column);
+
+			while (!search.isDone())
+			{
+				search.update(0);
+			}
+
+			cached_milliseconds += chrono::duration<double, milli>(middle - start).count();
+			milliseconds += chrono::duration<double, milli>(Clock::now() - middle).count();
+
+			PathView const cached_solution = cached_search.getSolutionView();
+			PathView const solution = search.getSolutionView();
+
+			if ((cached_solution.empty() != solution.empty())
+			 || (getCost(cached_solution) != getCost(solution)))
+			{
+				++mismatch_count;
+			}
+
+			if (!solution.empty())
+			{
+				last_path.assign(solution.begin(), solution.end());
+			}
+
+			cached_search.exit();
+			search.exit();
+		}
+	}
+
+	cached_search.shutdown();
+	search.shutdown();
+	cout << setprecision(3) << "    " << PATH_CACHE_EDIT_COUNT << " edits, "
+	     << (PATH_CACHE_EDIT_COUNT + 1) * scenarios.size() << " queries: cached " << fixed
+	     << cached_milliseconds << " ms, uncached " << milliseconds << " ms, mismatches "
+	     << mismatch_count << endl;
+	printStatistics(path_cache.getStatistics());
+	return !mismatch_count;
+}
+
+// Runs and prints whichever engine visitBestFirstEngine() builds.
+struct BestFirstRunner
+{
+	string const& map_name;
+	TileMap& tile_map;
+	vector<Scenario> const& scenarios;
+	int warmup_count;
+	int repeat_count;
+	long timeslice;
+	map<string, unsigned long long>& expansion_counts;
+
+	template <typename Engine>
+	void operator()(Engine& engine, BestFirstEngine const& entry)
+	{
+		Report report = Report();
+
+		run(engine, tile_map, scenarios, warmup_count, repeat_count, timeslice, report,
+		    entry.cost_bound);
+		print(map_name, entry.name, report);
+		expansion_counts[entry.name] = report.expansion_count;
+	}
+};
+
+static bool benchmark(string const& scenario_file, string const& engine_name, int warmup_count,
+                      int repeat_count, long timeslice, size_t thread_count,
+                      size_t path_cache_bytes)
+{
+	ifstream scenario_input(scenario_file.c_str());
+	vector<Scenario> scenarios;
+
+	if (!loadScenarios(scenario_input, scenarios))
+	{
+		cerr << "Could not read " << scenario_file << endl;
+		return false;
+	}
+
+	// A scenario file may span several maps; run each map's scenarios together.
+	map<string, vector<Scenario> > scenarios_by_map;
+
+	for (size_t i = 0; i < scenarios.size(); ++i)
+	{
+		scenarios_by_map[scenarios[i].map_name].push_back(scenarios[i]);
+	}
+
+	size_t const slash = scenario_file.find_last_of("/\\");
+	string const directory = (slash == string::npos) ? string() : scenario_file.substr(0, slash + 1);
+	bool is_passed = true;
+
+	for (map<string, vector<Scenario> >::const_iterator itr = scenarios_by_map.begin();
+	     itr != scenarios_by_map.end(); ++itr)
+	{
+		ifstream map_input((directory + itr->first).c_str());
+		TileMap tile_map;
+
+		if (!load(map_input, tile_map))
+		{
+			cerr << "Could not load " << directory + itr->first << endl;
+			continue;
+		}
+
+		for (size_t engine = 0; engine < ENGINE_COUNT; ++engine)
+		{
+			EngineEntry const& entry = ENGINES[engine];
+
+			if (((engine_name != "all") || !entry.is_in_all) && (engine_name != entry.name))
+			{
+				continue;
+			}
+
+			Report report = Report();
+
+			switch (entry.id)
+			{
+			case ASTAR:
+				{
+					PathSearch search;
+					PathCache path_cache(path_cache_bytes);
+
+					if (path_cache_bytes)
+					{
+						search.setPathCache(&path_cache);
+					}
+
+					run(search, tile_map, itr->second, warmup_count, repeat_count, timeslice,
+					    report);
+					print(itr->first, entry.name, report);
+					printSlices(search);
+
+					if (path_cache_bytes)
+					{
+						printStatistics(path_cache.getStatistics());
+
+						if (!checkPathCacheEdits(directory + itr->first, itr->second,
+						                         path_cache_bytes))
+						{
+							is_passed = false;
+						}
+					}
+
+					break;
+				}
+			case FRINGE:
+				{
+					FringeSearch search;
+
+					run(search, tile_map, itr->second, warmup_count, repeat_count, timeslice,
+					    report);
+					print(itr->first, entry.name, report);
+					break;
+				}
+			case IDA_STAR:
+				{
+					IDAStarSearch search;
+
+					run(search, tile_map, itr->second, warmup_count, repeat_count, timeslice,
+					    report);
+					print(itr->first, entry.name, report);
+					break;
+				}
+			case SMA_STAR:
+				{
+					SMAStarSearch search(SMAStarSearch::getNodeBudget(SMA_STAR_BYTE_BUDGET));
+
+					run(search, tile_map, itr->second, warmup_count, repeat_count, timeslice,
+					    report);
+					print(itr->first, entry.name, report);
+					break;
+				}
+			case ASTAR_COUNTERS:
+				{
+					InstrumentedPathSearch search;
+
+					run(search, tile_map, itr->second, warmup_count, repeat_count, timeslice,
+					    report);
+					print(itr->first, entry.name, report);
+					printCounters(search.getCumulativeCounters());
+					printSlices(search);
+					break;
+				}
+			case HDA_STAR:
+				{
+					HDAStarSearch search(thread_count);
+
+					run(search, tile_map, itr->second, warmup_count, repeat_count, timeslice,
+					    report);
+					print(itr->first, entry.name, report);
+					break;
+				}
+			}
+		}
+
+		map<string, unsigned long long> expansion_counts;
+		BestFirstRunner runner =
+		{
+			itr->first, tile_map, itr->second, warmup_count, repeat_count, timeslice,
+			expansion_counts
+		};
+
+		for (size_t engine = 0; engine < BEST_FIRST_ENGINE_COUNT; ++engine)
+		{
+			if ((engine_name == "best-first") || (engine_name == BEST_FIRST_ENGINES[engine].name))
+			{
+				visitBestFirstEngine(BEST_FIRST_ENGINES[engine].name, runner);
+			}
+		}
+
+		// A straight-line heuristic that prunes nothing has collapsed to zero.
+		if (expansion_counts.count("dijkstra") && expansion_counts.count("bf-euclid")
+		 && (expansion_counts["dijkstra"] <= expansion_counts["bf-euclid"]))
+		{
+			cerr << itr->first << ": bf-euclid expanded " << expansion_counts["bf-euclid"]
+			     << " nodes, no fewer than dijkstra's " << expansion_counts["dijkstra"] << endl;
+			is_passed = false;
+		}
+	}
+
+	return is_passed;
+}
+
+int main(int argc, char* argv[])
+{
+	string engine_name = "all";
+	int warmup_count = 1;
+	int repeat_count = 5;
+	long timeslice = 100;
+	size_t thread_count = 0;
+	size_t path_cache_bytes = 0;
+	vector<string> scenario_files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--engine") && (i + 1 < argc))
+		{
+			engine_name = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--warmup") && (i + 1 < argc))
+		{
+			warmup_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--repeat") && (i + 1 < argc))
+		{
+			repeat_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--timeslice") && (i + 1 < argc))
+		{
+			timeslice = atol(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--threads") && (i + 1 < argc))
+		{
+			thread_count = static_cast<size_t>(atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--path-cache") && (i + 1 < argc))
+		{
+			path_cache_bytes = static_cast<size_t>(strtoull(argv[++i], 0, 10));
+		}
+		else if ((argv[i][0] == '-') && argv[i][1])
+		{
+			printUsage(argv[0]);
+			return 1;
+		}
+		else
+		{
+			scenario_files.push_back(argv[i]);
+		}
+	}
+
+	if (!isKnownEngine(engine_name))
+	{
+		cerr << "Unknown engine " << engine_name << endl;
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	if (scenario_files.empty())
+	{
+		findScenarioFiles("./Data", scenario_files);
+
+		if (scenario_files.empty())
+		{
+			cerr << "No scenario files in ./Data" << endl;
+			return 1;
+		}
+	}
+
+	cout << left << setw(20) << "map" << setw(16) << "engine" << right << setw(7) << "runs"
+	     << setw(11) << "p50 ms" << setw(11) << "p95 ms" << setw(11) << "p99 ms"
+	     << setw(14) << "expansions/s" << setw(8) << "wrong" << setw(9) << "no path"
+	     << setw(10) << "timeouts" << endl;
+
+	bool is_passed = true;
+
+	for (size_t i = 0; i < scenario_files.size(); ++i)
+	{
+		if (!benchmark(scenario_files[i], engine_name, warmup_count, repeat_count, timeslice,
+		               thread_count, path_cache_bytes))
+		{
+			is_passed = false;
+		}
+	}
+
+	return is_passed ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+// Feeds the scenarios of one map to a SearchScheduler as a stream of agents and reports queue
+// depth, completion latency and how much of each frame's budget was spent.
+//
+// usage: SchedulerBenchmark [--engines N] [--budget N] [--arrivals N] [scenario file]
+//
+// Every frame, --arrivals new requests are submitted with priorities cycling from 0 to 3 until
+// the scenarios run out, and the scheduler spends at most --budget expansions on --engines
+// concurrent searches.  Every path is checked against the optimal cost in the scenario file.
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "../SearchLibrary/Scenario.h"
+#include "../SearchLibrary/SearchScheduler.h"
+#include "../SearchLibrary/SolutionValidator.h"
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+static void printHistogram(char const* name, Histogram const& histogram, double scale)
+{
+	cout << left << setw(22) << name << right << fixed << setprecision(2)
+	     << setw(10) << histogram.getValueAtPercentile(50.0) / scale
+	     << setw(10) << histogram.getValueAtPercentile(95.0) / scale
+	     << setw(10) << histogram.getValueAtPercentile(99.0) / scale
+	     << setw(10) << histogram.getMaximum() / scale
+	     << setw(10) << histogram.getMean() / scale << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t engine_count = 32;
+	size_t frame_budget = 2000;
+	size_t arrival_count = 8;
+	string scenario_file = "./Data/hex113x083.txt.scen";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--engines") && (i + 1 < argc))
+		{
+			engine_count = static_cast<size_t>(atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--budget") && (i + 1 < argc))
+		{
+			frame_budget = static_cast<size_t>(atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--arrivals") && (i + 1 < argc))
+		{
+			arrival_count = static_cast<size_t>(atoi(argv[++i]));
+		}
+		else
+		{
+			scenario_file = argv[i];
+		}
+	}
+
+	ifstream scenario_input(scenario_file.c_str());
+	vector<Scenario> scenarios;
+
+	if (!loadScenarios(scenario_input, scenarios) || scenarios.empty())
+	{
+		cerr << "Could not read " << scenario_file << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Only the scenarios on the first map are run.
+	size_t const slash = scenario_file.find_last_of("/\\");
+	string const map_file = ((slash == string::npos) ? string() : scenario_file.substr(0, slash + 1))
+	                      + scenarios[0].map_name;
+	ifstream map_input(map_file.c_str());
+	TileMap tile_map;
+
+	if (!load(map_input, tile_map))
+	{
+		cerr << "Could not load " << map_file << endl;
+		return EXIT_FAILURE;
+	}
+
+	SearchScheduler scheduler(tile_map, engine_count, frame_budget);
+	SolutionValidator validator(tile_map, 0);
+	vector<SearchScheduler::Ticket> tickets;
+	vector<size_t> ticket_scenarios;
+	size_t next_scenario = 0;
+	size_t frame_count = 0;
+	size_t finished_count = 0;
+	size_t wrong_count = 0;
+	unsigned long long expansion_count = 0;
+	bool is_over_budget = false;
+
+	while ((next_scenario < scenarios.size()) || scheduler.getQueueDepth())
+	{
+		for (size_t i = 0; (i < arrival_count) && (next_scenario < scenarios.size()); ++i)
+		{
+			Scenario const& scenario = scenarios[next_scenario];
+
+			if (scenario.map_name == scenarios[0].map_name)
+			{
+				tickets.push_back(scheduler.submit(scenario.start_row, scenario.start_column,
+				                                   scenario.goal_row, scenario.goal_column,
+				                                   static_cast<int>(tickets.size() % 4)));
+				ticket_scenarios.push_back(next_scenario);
+			}
+
+			++next_scenario;
+		}
+
+		size_t const spent = scheduler.runFrame();
+
+		expansion_count += spent;
+		is_over_budget = is_over_budget || (frame_budget < spent);
+		++frame_count;
+
+		for (size_t i = 0; i < tickets.size(); )
+		{
+			if (!scheduler.isDone(tickets[i]))
+			{
+				++i;
+				continue;
+			}
+
+			if (validator.validate(scheduler.getSolution(tickets[i]),
+			                       scenarios[ticket_scenarios[i]]).error != SolutionReport::VALID)
+			{
+				++wrong_count;
+			}
+
+			scheduler.release(tickets[i]);
+			tickets[i] = tickets.back();
+			tickets.pop_back();
+			ticket_scenarios[i] = ticket_scenarios.back();
+			ticket_scenarios.pop_back();
+			++finished_count;
+		}
+	}
+
+	cout << scenarios[0].map_name << ": " << finished_count << " requests, " << engine_count
+	     << " engines, " << frame_budget << " expansions per frame, " << frame_count
+	     << " frames, " << fixed << setprecision(1)
+	     << (frame_count ? 100.0 * expansion_count / (frame_count * frame_budget) : 0.0)
+	     << "% of the budget spent, " << wrong_count << " wrong paths"
+	     << (is_over_budget ? ", BUDGET EXCEEDED" : "") << endl;
+	cout << left << setw(22) << "" << right << setw(10) << "p50" << setw(10) << "p95"
+	     << setw(10) << "p99" << setw(10) << "max" << setw(10) << "mean" << endl;
+	printHistogram("queue depth", scheduler.getQueueDepths(), 1.0);
+	printHistogram("latency (frames)", scheduler.getLatencyFrames(), 1.0);
+	printHistogram("latency (ms)", scheduler.getLatencyNanoseconds(), 1e6);
+	return (wrong_count || is_over_budget) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
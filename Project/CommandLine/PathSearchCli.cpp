@@ -0,0 +1,483 @@
+// Headless front-end for SearchLibrary.  Loads a map, then streams queries from a file or from
+// standard input and writes each result as soon as its search completes.
+//
+// Each query line holds "start_row start_column goal_row goal_column"; blank lines and lines
+// starting with '#' are skipped.  Each result line is tab-separated:
+//
+//     index  start_row start_column goal_row goal_column  status  cost  tiles  milliseconds  path
+//
+// where status is "found", "unreachable", "out-of-memory" or "invalid", and path lists the tiles
+// from start to goal as row,column pairs.  With --compact, path is instead the CompactPath
+// encoding "start_index:step_count:word,word,...", with the words in hexadecimal.
+//
+// Unless --no-components is given, the connected components of the map are labelled once after
+// loading, and a query between two components is answered "unreachable" without a search.
+//
+// With --path-cache, the A* engine answers repeated queries, and queries along a path it found
+// before, from a cache of that many bytes, whose counters are written to standard error at the
+// end of the run.
+//
+// With --trace, the load and every engine call are recorded and written as a Chrome trace.
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "../SearchLibrary/PathSearch.h"
+#include "../SearchLibrary/BestFirstRegistry.h"
+#include "../SearchLibrary/CompactPath.h"
+#include "../SearchLibrary/ComponentIndex.h"
+#include "../SearchLibrary/FringeSearch.h"
+#include "../SearchLibrary/HDAStarSearch.h"
+#include "../SearchLibrary/IDAStarSearch.h"
+#include "../SearchLibrary/PathCache.h"
+#include "../SearchLibrary/SMAStarSearch.h"
+#include "../SearchLibrary/Tracer.h"
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+typedef chrono::high_resolution_clock Clock;
+
+struct Options
+{
+	string engine;
+	long timeslice;
+	size_t expansion_budget;
+	size_t sma_star_bytes;
+	size_t thread_count;
+	size_t path_cache_bytes;
+	bool is_path_printed;
+	bool is_path_compact;
+	bool is_component_index_used;
+	char const* map_file;
+	char const* query_file;
+	char const* trace_file;
+};
+
+static void printUsage(char const* program)
+{
+	cerr << "usage: " << program << " [options] <map file> [query file]" << endl
+	     << "Reads queries from standard input if no query file is given." << endl
+	     << "  --engine astar|fringe|ida|sma|hda" << endl
+	     << "                                 search engine to run (default astar)" << endl
+	     << "  --engine <best-first engine>   one of the engines below, built from policies" << endl;
+
+	for (size_t i = 0; i < BEST_FIRST_ENGINE_COUNT; ++i)
+	{
+		cerr << "      " << left << setw(27) << BEST_FIRST_ENGINES[i].name
+		     << BEST_FIRST_ENGINES[i].description << endl;
+	}
+
+	cerr << right
+	     << "  --timeslice <ms>               milliseconds per update() call (default 10)" << endl
+	     << "  --expansions <n>               expansions per updateExpansions() call, instead of"
+	     << endl
+	     << "                                 --timeslice, for reproducible progress" << endl
+	     << "  --sma-bytes <bytes>            memory budget of the SMA* engine (default 1048576)"
+	     << endl
+	     << "  --threads <n>                  worker threads of the HDA* engine and of the"
+	     << endl
+	     << "                                 component labelling (default: one per hardware"
+	     << endl
+	     << "                                 thread)" << endl
+	     << "  --no-components                search for every goal, even one in another component"
+	     << endl
+	     << "  --path-cache <bytes>           cache the paths of the astar engine in that many"
+	     << endl
+	     << "                                 bytes and report its counters at the end" << endl
+	     << "  --no-path                      omit the path from each result" << endl
+	     << "  --compact                      print each path in its compact encoding" << endl
+	     << "  --trace <file>                 write a Chrome trace of the run to the file" << endl;
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options)
+{
+	options.engine = "astar";
+	options.timeslice = 10;
+	options.expansion_budget = 0;
+	options.sma_star_bytes = 1 << 20;
+	options.thread_count = 0;
+	options.path_cache_bytes = 0;
+	options.is_path_printed = true;
+	options.is_path_compact = false;
+	options.is_component_index_used = true;
+	options.map_file = 0;
+	options.query_file = 0;
+	options.trace_file = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--engine") && (i + 1 < argc))
+		{
+			options.engine = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--timeslice") && (i + 1 < argc))
+		{
+			options.timeslice = atol(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--expansions") && (i + 1 < argc))
+		{
+			options.expansion_budget = static_cast<size_t>(strtoull(argv[++i], 0, 10));
+		}
+		else if (!strcmp(argv[i], "--sma-bytes") && (i + 1 < argc))
+		{
+			options.sma_star_bytes = static_cast<size_t>(strtoull(argv[++i], 0, 10));
+		}
+		else if (!strcmp(argv[i], "--threads") && (i + 1 < argc))
+		{
+			options.thread_count = static_cast<size_t>(strtoull(argv[++i], 0, 10));
+		}
+		else if (!strcmp(argv[i], "--path-cache") && (i + 1 < argc))
+		{
+			options.path_cache_bytes = static_cast<size_t>(strtoull(argv[++i], 0, 10));
+		}
+		else if (!strcmp(argv[i], "--no-path"))
+		{
+			options.is_path_printed = false;
+		}
+		else if (!strcmp(argv[i], "--compact"))
+		{
+			options.is_path_compact = true;
+		}
+		else if (!strcmp(argv[i], "--no-components"))
+		{
+			options.is_component_index_used = false;
+		}
+		else if (!strcmp(argv[i], "--trace") && (i + 1 < argc))
+		{
+			options.trace_file = argv[++i];
+		}
+		else if ((argv[i][0] == '-') && argv[i][1])
+		{
+			return false;
+		}
+		else if (!options.map_file)
+		{
+			options.map_file = argv[i];
+		}
+		else if (!options.query_file)
+		{
+			options.query_file = argv[i];
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return options.map_file != 0;
+}
+
+static bool isOutOfMemory(PathSearch const&)
+{
+	return false;
+}
+
+static bool isOutOfMemory(FringeSearch const&)
+{
+	return false;
+}
+
+static bool isOutOfMemory(IDAStarSearch const&)
+{
+	return false;
+}
+
+static bool isOutOfMemory(HDAStarSearch const&)
+{
+	return false;
+}
+
+static bool isOutOfMemory(SMAStarSearch const& engine)
+{
+	return engine.isOutOfMemory();
+}
+
+template <typename Heuristic, template <typename, typename> class OpenList, typename TieBreak,
+          typename Weighting>
+static bool isOutOfMemory(BestFirstSearch<Heuristic, OpenList, TieBreak, Weighting> const&)
+{
+	return false;
+}
+
+template <typename Engine>
+static void solve(Engine& engine, TileMap& tile_map, ComponentIndex const* component_index,
+                  istream& queries, Options const& options)
+{
+	string line;
+	int line_number = 0;
+	int index = 0;
+	CompactPath compact_path;
+
+	engine.initialize(&tile_map);
+	engine.setComponentIndex(component_index);
+
+	while (getline(queries, line))
+	{
+		++line_number;
+
+		size_t const first = line.find_first_not_of(" \t\r");
+
+		if ((first == string::npos) || (line[first] == '#'))
+		{
+			continue;
+		}
+
+		istringstream fields(line);
+		int start_row, start_column, goal_row, goal_column;
+
+		if (!(fields >> start_row >> start_column >> goal_row >> goal_column))
+		{
+			cerr << "line " << line_number << ": expected four integers" << endl;
+			continue;
+		}
+
+		cout << index++ << '\t' << start_row << ' ' << start_column << ' ' << goal_row << ' '
+		     << goal_column << '\t';
+
+		Tile const* const start = tile_map.getTile(start_row, start_column);
+		Tile const* const goal = tile_map.getTile(goal_row, goal_column);
+
+		if (!start || !goal || !start->getWeight() || !goal->getWeight())
+		{
+			cout << "invalid\t0\t0\t0" << endl;
+			continue;
+		}
+
+		Clock::time_point const begin = Clock::now();
+
+		engine.enter(start_row, start_column, goal_row, goal_column);
+
+		while (!engine.isDone())
+		{
+			if (options.expansion_budget)
+			{
+				engine.updateExpansions(options.expansion_budget);
+			}
+			else
+			{
+				engine.update(options.timeslice);
+			}
+		}
+
+		double const milliseconds = chrono::duration<double, milli>(Clock::now() - begin).count();
+		PathView const solution = engine.getSolutionView();
+		unsigned int cost = 0;
+
+		for (size_t i = 0; i + 1 < solution.size(); ++i)
+		{
+			cost += solution[i]->getWeight();
+		}
+
+		if (!solution.empty())
+		{
+			cout << "found";
+		}
+		else if (isOutOfMemory(engine))
+		{
+			cout << "out-of-memory";
+		}
+		else
+		{
+			cout << "unreachable";
+		}
+
+		cout << '\t' << cost << '\t' << solution.size() << '\t' << milliseconds;
+
+		if (options.is_path_compact && !solution.empty())
+		{
+			compact_path.assign(solution, tile_map);
+			cout << '\t' << compact_path.getStartIndex() << ':' << compact_path.getStepCount()
+			     << ':' << hex;
+
+			for (size_t i = 0; i < compact_path.getWords().size(); ++i)
+			{
+				cout << (i ? "," : "") << compact_path.getWords()[i];
+			}
+
+			cout << dec;
+		}
+		else if (options.is_path_printed && !solution.empty())
+		{
+			cout << '\t';
+
+			for (size_t i = solution.size(); i--; )
+			{
+				cout << solution[i]->getRow() << ',' << solution[i]->getColumn()
+				     << (i ? " " : "");
+			}
+		}
+
+		// Flush every result so that a consumer on the other end of a pipe sees it right away.
+		cout << endl;
+		engine.exit();
+	}
+
+	engine.shutdown();
+}
+
+static void printStatistics(PathCache::Statistics const& statistics)
+{
+	cerr << "path cache: hits " << statistics.hit_count << ", subpath hits "
+	     << statistics.subpath_hit_count << ", misses " << statistics.miss_count << ", hit rate "
+	     << setprecision(3) << statistics.getHitRate() << ", insertions "
+	     << statistics.insertion_count << ", evictions " << statistics.eviction_count
+	     << ", invalidations " << statistics.invalidation_count << ", entries "
+	     << statistics.entry_count << ", bytes " << statistics.bytes_used << endl;
+}
+
+// Runs solve() on whichever engine visitBestFirstEngine() builds.
+struct BestFirstSolver
+{
+	TileMap& tile_map;
+	ComponentIndex const* component_index;
+	istream& queries;
+	Options const& options;
+
+	template <typename Engine>
+	void operator()(Engine& engine, BestFirstEngine const&)
+	{
+		solve(engine, tile_map, component_index, queries, options);
+	}
+};
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (options.path_cache_bytes && (options.engine != "astar"))
+	{
+		cerr << "--path-cache needs --engine astar" << endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (options.trace_file)
+	{
+		Tracer::enable();
+	}
+
+	ifstream map_input(options.map_file);
+	TileMap tile_map;
+	bool is_loaded;
+
+	{
+		TraceScope scope("load");
+
+		is_loaded = load(map_input, tile_map);
+	}
+
+	if (!is_loaded)
+	{
+		cerr << "Could not load " << options.map_file << endl;
+		return EXIT_FAILURE;
+	}
+
+	ComponentIndex component_index(tile_map);
+
+	if (options.is_component_index_used)
+	{
+		TraceScope scope("components");
+
+		component_index.build(options.thread_count);
+	}
+
+	ComponentIndex const* const attached_index
+		= options.is_component_index_used ? &component_index : 0;
+	ifstream query_input;
+
+	if (options.query_file && strcmp(options.query_file, "-"))
+	{
+		query_input.open(options.query_file);
+
+		if (!query_input)
+		{
+			cerr << "Could not open " << options.query_file << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	istream& queries = query_input.is_open() ? static_cast<istream&>(query_input) : cin;
+
+	if (options.engine == "astar")
+	{
+		PathSearch engine;
+		PathCache path_cache(options.path_cache_bytes);
+
+		if (options.path_cache_bytes)
+		{
+			engine.setPathCache(&path_cache);
+		}
+
+		solve(engine, tile_map, attached_index, queries, options);
+
+		if (options.path_cache_bytes)
+		{
+			printStatistics(path_cache.getStatistics());
+		}
+	}
+	else if (options.engine == "fringe")
+	{
+		FringeSearch engine;
+
+		solve(engine, tile_map, attached_index, queries, options);
+	}
+	else if (options.engine == "ida")
+	{
+		IDAStarSearch engine;
+
+		solve(engine, tile_map, attached_index, queries, options);
+	}
+	else if (options.engine == "sma")
+	{
+		SMAStarSearch engine(SMAStarSearch::getNodeBudget(options.sma_star_bytes));
+
+		solve(engine, tile_map, attached_index, queries, options);
+	}
+	else if (options.engine == "hda")
+	{
+		HDAStarSearch engine(options.thread_count);
+
+		solve(engine, tile_map, attached_index, queries, options);
+	}
+	else
+	{
+		BestFirstSolver solver = { tile_map, attached_index, queries, options };
+
+		if (!visitBestFirstEngine(options.engine.c_str(), solver))
+		{
+			cerr << "Unknown engine " << options.engine << endl;
+			printUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (options.trace_file)
+	{
+		ofstream trace_output(options.trace_file);
+
+		Tracer::disable();
+
+		if (!Tracer::write(trace_output))
+		{
+			cerr << "Could not write " << options.trace_file << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
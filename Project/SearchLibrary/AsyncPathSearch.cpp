@@ -0,0 +1,201 @@
+#include "AsyncPathSearch.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	size_t const AsyncPathSearch::DEFAULT_SLICE_EXPANSION_COUNT;
+
+	AsyncPathSearch::AsyncPathSearch(TileMap& map, size_t worker_count, size_t slice_count)
+		: tile_map(&map), slice_expansion_count(slice_count ? slice_count : 1), workers()
+		, queries(), mutex(), has_query(), is_stopping(false), submitted_count(0)
+		, completed_count(0), cancelled_count(0), busy_nanoseconds(0)
+		, statistics_start(Clock::now()), latency_nanoseconds()
+	{
+		for (size_t i = 0; i < worker_count; ++i)
+		{
+			workers.push_back(thread(&AsyncPathSearch::work, this));
+		}
+	}
+
+	AsyncPathSearch::~AsyncPathSearch()
+	{
+		{
+			lock_guard<std::mutex> lock(mutex);
+
+			is_stopping = true;
+		}
+
+		has_query.notify_all();
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			workers[i].join();
+		}
+	}
+
+	shared_future<AsyncPathSearch::Result> AsyncPathSearch::submit(
+		int start_row
+	  , int start_column
+	  , int goal_row
+	  , int goal_column
+	  , CancellationToken const& token
+	  , Callback const& callback
+	)
+	{
+		Query query;
+
+		query.start_row = start_row;
+		query.start_column = start_column;
+		query.goal_row = goal_row;
+		query.goal_column = goal_column;
+		query.token = token;
+		query.callback = callback;
+		query.submit_time = Clock::now();
+
+		shared_future<Result> future = query.promise.get_future().share();
+
+		{
+			lock_guard<std::mutex> lock(mutex);
+
+			queries.push_back(move(query));
+			++submitted_count;
+		}
+
+		has_query.notify_one();
+		return future;
+	}
+
+	void AsyncPathSearch::run(PathSearch& engine, Query& query, Result& result)
+	{
+		Tile const* const start = tile_map->getTile(query.start_row, query.start_column);
+		Tile const* const goal = tile_map->getTile(query.goal_row, query.goal_column);
+
+		if (!start || !goal || !start->getWeight() || !goal->getWeight())
+		{
+			result.status = Result::INVALID;
+			return;
+		}
+
+		TraceScope scope("query");
+
+		engine.enter(query.start_row, query.start_column, query.goal_row, query.goal_column);
+
+		while (!engine.isDone())
+		{
+			if (query.token.isCancelled() || is_stopping)
+			{
+				// Only the open list is per query; the nodes stay with the worker for reuse.
+				engine.exit();
+				result.status = Result::CANCELLED;
+				return;
+			}
+
+			engine.updateExpansions(slice_expansion_count);
+		}
+
+		result.solution = engine.getSolution();
+		result.status = result.solution.empty() ? Result::UNREACHABLE : Result::FOUND;
+		engine.exit();
+	}
+
+	void AsyncPathSearch::work()
+	{
+		PathSearch engine;
+
+		engine.initialize(tile_map);
+
+		for (;;)
+		{
+			Query query;
+
+			{
+				unique_lock<std::mutex> lock(mutex);
+
+				while (!is_stopping && queries.empty())
+				{
+					has_query.wait(lock);
+				}
+
+				if (queries.empty())
+				{
+					return;
+				}
+
+				query = move(queries.front());
+				queries.pop_front();
+			}
+
+			Clock::time_point const begin = Clock::now();
+			Result result;
+
+			result.status = Result::CANCELLED;
+
+			// Once the pool is stopping, queries still queued are only drained.
+			if (!query.token.isCancelled() && !is_stopping)
+			{
+				run(engine, query, result);
+			}
+
+			Clock::time_point const end = Clock::now();
+
+			result.latency_nanoseconds
+				= chrono::duration_cast<chrono::nanoseconds>(end - query.submit_time).count();
+
+			{
+				lock_guard<std::mutex> lock(mutex);
+
+				busy_nanoseconds += chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+
+				if (result.status == Result::CANCELLED)
+				{
+					++cancelled_count;
+				}
+				else
+				{
+					++completed_count;
+					latency_nanoseconds.record(static_cast<unsigned long long>(
+						result.latency_nanoseconds
+					));
+				}
+			}
+
+			if (query.callback)
+			{
+				query.callback(result);
+			}
+
+			query.promise.set_value(move(result));
+		}
+	}
+
+	AsyncPathSearch::Statistics AsyncPathSearch::getStatistics() const
+	{
+		lock_guard<std::mutex> lock(mutex);
+		Statistics statistics;
+		long long const elapsed = chrono::duration_cast<chrono::nanoseconds>(
+			Clock::now() - statistics_start
+		).count();
+
+		statistics.submitted_count = submitted_count;
+		statistics.completed_count = completed_count;
+		statistics.cancelled_count = cancelled_count;
+		statistics.queued_count = queries.size();
+		statistics.utilization = (elapsed && !workers.empty())
+		                       ? static_cast<double>(busy_nanoseconds) / elapsed / workers.size()
+		                       : 0.0;
+		statistics.latency_nanoseconds = latency_nanoseconds;
+		return statistics;
+	}
+
+	void AsyncPathSearch::resetStatistics()
+	{
+		lock_guard<std::mutex> lock(mutex);
+
+		submitted_count = completed_count = cancelled_count = 0;
+		busy_nanoseconds = 0;
+		statistics_start = Clock::now();
+		latency_nanoseconds.clear();
+	}
+}}  // namespace fullsail_ai::algorithms
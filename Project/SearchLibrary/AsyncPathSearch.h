@@ -0,0 +1,183 @@
+//! \file AsyncPathSearch.h
+//! \brief Defines the <code>fullsail_ai::algorithms::AsyncPathSearch</code> class.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "PathSearch.h"
+#include "SliceStatistics.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Runs path queries on a pool of worker threads and hands back futures.
+	//!
+	//! Every worker owns one <code>PathSearch</code>, initialized once, and drives it through
+	//! <code>enter()</code>, <code>updateExpansions()</code> and <code>exit()</code>.  Between
+	//! slices the worker checks the query's cancellation token, so a stale query is dropped
+	//! within one slice and its worker moves straight on to the next query.
+	//!
+	//! The tile map must not change while queries are running.
+	class AsyncPathSearch
+	{
+	public:
+		//! \brief The outcome of one query.
+		struct Result
+		{
+			//! \brief How the query ended.
+			enum Status
+			{
+				//! A path was found.
+				FOUND,
+
+				//! The goal cannot be reached from the start.
+				UNREACHABLE,
+
+				//! The start or the goal is off the map or impassable.
+				INVALID,
+
+				//! The query was cancelled, or the pool was destroyed, before it finished.
+				CANCELLED
+			};
+
+			//! \brief How the query ended.
+			Status status;
+
+			//! \brief The path found, goal first, or an empty vector.
+			std::vector<Tile const*> solution;
+
+			//! \brief The time from <code>submit()</code> to completion.
+			long long latency_nanoseconds;
+		};
+
+		//! \brief A flag shared by every copy, used to cancel the queries it was passed to.
+		class CancellationToken
+		{
+			std::shared_ptr<std::atomic<bool> > flag;
+
+		public:
+			//! \brief Constructs a token that has not been cancelled.
+			inline CancellationToken() : flag(std::make_shared<std::atomic<bool> >(false))
+			{
+			}
+
+			//! \brief Cancels every query this token, or a copy of it, was passed to.
+			inline void cancel()
+			{
+				flag->store(true, std::memory_order_relaxed);
+			}
+
+			//! \brief Returns <code>true</code> once <code>cancel()</code> has been called.
+			inline bool isCancelled() const
+			{
+				return flag->load(std::memory_order_relaxed);
+			}
+		};
+
+		//! \brief Called on the worker thread when a query ends, just before its future is
+		//! made ready.
+		typedef std::function<void (Result const&)> Callback;
+
+		//! \brief Snapshot of the pool's counters.
+		struct Statistics
+		{
+			unsigned long long submitted_count;
+			unsigned long long completed_count;
+			unsigned long long cancelled_count;
+			std::size_t queued_count;
+
+			//! \brief The fraction of worker time spent on queries since construction or the
+			//! last call to <code>resetStatistics()</code>.
+			double utilization;
+
+			//! \brief The latency of every query that was not cancelled, in nanoseconds.
+			Histogram latency_nanoseconds;
+		};
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Query
+		{
+			int start_row;
+			int start_column;
+			int goal_row;
+			int goal_column;
+			CancellationToken token;
+			Callback callback;
+			Clock::time_point submit_time;
+			std::promise<Result> promise;
+		};
+
+		TileMap* tile_map;
+		std::size_t slice_expansion_count;
+		std::vector<std::thread> workers;
+		std::deque<Query> queries;
+		mutable std::mutex mutex;
+		std::condition_variable has_query;
+		std::atomic<bool> is_stopping;
+		unsigned long long submitted_count;
+		unsigned long long completed_count;
+		unsigned long long cancelled_count;
+		long long busy_nanoseconds;
+		Clock::time_point statistics_start;
+		Histogram latency_nanoseconds;
+
+		AsyncPathSearch(AsyncPathSearch const&);
+		AsyncPathSearch& operator=(AsyncPathSearch const&);
+
+		void work();
+		void run(PathSearch& engine, Query& query, Result& result);
+
+	public:
+		//! \brief The default number of expansions between two checks of the cancellation token.
+		static std::size_t const DEFAULT_SLICE_EXPANSION_COUNT = 1024;
+
+		//! \brief Starts the specified number of workers over the specified tile map.
+		//!
+		//! Each worker holds a node for every tile of the map.
+		DLLEXPORT AsyncPathSearch(TileMap& tile_map, std::size_t worker_count,
+		                          std::size_t slice_expansion_count = DEFAULT_SLICE_EXPANSION_COUNT);
+
+		//! \brief Cancels every query that has not finished and waits for the workers to stop.
+		DLLEXPORT ~AsyncPathSearch();
+
+		//! \brief Queues a query between the specified locations.
+		//!
+		//! \param   token     cancels the query if it has not finished yet.
+		//! \param   callback  called with the result, on the worker thread, if not empty.
+		//! \return  a future that becomes ready when the query ends, cancelled or not.
+		DLLEXPORT std::shared_future<Result> submit(
+			int start_row
+		  , int start_column
+		  , int goal_row
+		  , int goal_column
+		  , CancellationToken const& token = CancellationToken()
+		  , Callback const& callback = Callback()
+		);
+
+		//! \brief Returns a snapshot of the pool's counters.
+		DLLEXPORT Statistics getStatistics() const;
+
+		//! \brief Sets every counter returned by <code>getStatistics()</code> back to zero,
+		//! except the number of queued queries.
+		DLLEXPORT void resetStatistics();
+
+		//! \brief Returns the number of worker threads.
+		inline std::size_t getWorkerCount() const
+		{
+			return workers.size();
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,379 @@
+//! \file BestFirstPolicies.h
+//! \brief Heuristic, open-list, tie-breaking and weighting policies of the
+//! <code>fullsail_ai::algorithms::BestFirstSearch</code> class template.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "../TileLibrary/TileMap.h"
+#include "GridTopology.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Heuristic policy that estimates nothing, which turns A* into Dijkstra's algorithm.
+	//!
+	//! A heuristic policy is default-constructible and provides:
+	//!   - <code>initialize(tile_map)</code>, called whenever the search is bound to a map.
+	//!   - <code>setGoal(goal)</code>, called by every <code>enter()</code>.
+	//!   - <code>estimate<Topology>(row, column, tile)</code>, a lower bound on the cost of
+	//!     reaching the goal from the specified tile.  Every step costs at least the minimum
+	//!     weight in <code>TileMap::getStatistics()</code>, so a lower bound on the number of
+	//!     steps, scaled by that weight, is admissible.
+	struct ZeroHeuristic
+	{
+		inline void initialize(TileMap const&)
+		{
+		}
+
+		inline void setGoal(Tile const*)
+		{
+		}
+
+		template <typename Topology>
+		inline double estimate(int, int, Tile const*) const
+		{
+			return 0.0;
+		}
+	};
+
+	//! \brief Heuristic policy that measures the straight line between tile centres.
+	//!
+	//! The centres are placed in grid units, with adjacent hexagons one unit apart and squares
+	//! one unit a side, so the estimate does not depend on <code>TileMap::setRadius()</code>.
+	//! The distance is divided by the longest step of the topology, so it never exceeds the
+	//! number of steps left, and then scaled by the minimum weight.  It is weaker than
+	//! <code>GridDistanceHeuristic</code>, but consistent all the same.
+	class EuclideanHeuristic
+	{
+		double row_shifts[2];
+		double row_height;
+		double step_scale;
+		double goal_x;
+		double goal_y;
+
+		inline double getX(int row, int column) const
+		{
+			return column + row_shifts[row & 1];
+		}
+
+		inline double getY(int row) const
+		{
+			return row * row_height;
+		}
+
+	public:
+		inline EuclideanHeuristic()
+			: row_height(1.0), step_scale(0.0), goal_x(0.0), goal_y(0.0)
+		{
+			row_shifts[0] = row_shifts[1] = 0.0;
+		}
+
+		inline void initialize(TileMap const& tile_map)
+		{
+			double longest_step = 1.0;
+
+			row_shifts[0] = row_shifts[1] = 0.0;
+			row_height = 1.0;
+
+			switch (tile_map.getTopology())
+			{
+			case HEX_EVEN_ROWS:
+				row_shifts[0] = 0.5;
+				row_height = std::sqrt(3.0) / 2.0;
+				break;
+			case SQUARE_FOUR:
+				break;
+			case SQUARE_EIGHT:
+				// A diagonal step crosses the most ground for the same single step.
+				longest_step = std::sqrt(2.0);
+				break;
+			default:
+				row_shifts[1] = 0.5;
+				row_height = std::sqrt(3.0) / 2.0;
+			}
+
+			step_scale = tile_map.getStatistics().getMinimumWeight() / longest_step;
+		}
+
+		inline void setGoal(Tile const* goal)
+		{
+			goal_x = getX(goal->getRow(), goal->getColumn());
+			goal_y = getY(goal->getRow());
+		}
+
+		template <typename Topology>
+		inline double estimate(int row, int column, Tile const*) const
+		{
+			double const dx = goal_x - getX(row, column);
+			double const dy = goal_y - getY(row);
+
+			return std::sqrt(dx * dx + dy * dy) * step_scale;
+		}
+	};
+
+	//! \brief Heuristic policy that counts the steps between two tiles with
+	//! <code>Topology::getDistance()</code>: the integer hex distance on hex maps, the
+	//! Manhattan or Chebyshev distance on square ones.  <code>PathSearch</code> counts the
+	//! same, but this policy also scales the count by the minimum weight, which tightens it on
+	//! maps without tiles of weight one.
+	class GridDistanceHeuristic
+	{
+		int goal_row;
+		int goal_column;
+		double step_cost;
+
+	public:
+		inline GridDistanceHeuristic() : goal_row(0), goal_column(0), step_cost(1.0)
+		{
+		}
+
+		inline void initialize(TileMap const& tile_map)
+		{
+			step_cost = tile_map.getStatistics().getMinimumWeight();
+		}
+
+		inline void setGoal(Tile const* goal)
+		{
+			goal_row = goal->getRow();
+			goal_column = goal->getColumn();
+		}
+
+		template <typename Topology>
+		inline double estimate(int row, int column, Tile const*) const
+		{
+			return Topology::getDistance(row, column, goal_row, goal_column) * step_cost;
+		}
+	};
+
+	//! \brief Weighting policy of A*: a node's priority is its given cost plus its estimate.
+	//!
+	//! A weighting policy provides <code>getFinalCost(given_cost, estimate)</code>; the open
+	//! list is ordered by that value, smallest first.
+	struct AStarWeighting
+	{
+		static inline double getFinalCost(double given_cost, double estimate)
+		{
+			return given_cost + estimate;
+		}
+	};
+
+	//! \brief Weighting policy of weighted A*, which inflates the estimate by
+	//! <code>Numerator / Denominator</code>.
+	//!
+	//! With an admissible heuristic, the path found costs at most that many times the optimal
+	//! cost, and usually takes far fewer expansions to find.
+	template <int Numerator, int Denominator>
+	struct WeightedAStarWeighting
+	{
+		static inline double getFinalCost(double given_cost, double estimate)
+		{
+			return given_cost + estimate * Numerator / Denominator;
+		}
+	};
+
+	//! \brief Weighting policy of greedy best-first search, which ignores the given cost.
+	//!
+	//! Greedy search heads straight for the goal and makes no promise about the path's cost.
+	struct GreedyWeighting
+	{
+		static inline double getFinalCost(double, double estimate)
+		{
+			return estimate;
+		}
+	};
+
+	//! \brief Tie-breaking policy that prefers, among nodes of equal priority, the one with the
+	//! largest given cost, and so the one closest to the goal.  <code>PathSearch</code> breaks
+	//! ties the same way.
+	//!
+	//! A tie-breaking policy provides <code>isPreferred(lhs, rhs)</code>, which is only called
+	//! on nodes of equal priority and returns <code>true</code> if <code>lhs</code> should be
+	//! expanded first.
+	struct PreferDeeperTieBreak
+	{
+		template <typename Node>
+		static inline bool isPreferred(Node const& lhs, Node const& rhs)
+		{
+			return rhs.given_cost < lhs.given_cost;
+		}
+	};
+
+	//! \brief Tie-breaking policy that prefers, among nodes of equal priority, the one with the
+	//! smallest given cost.  This expands more nodes on open maps, as a baseline.
+	struct PreferShallowerTieBreak
+	{
+		template <typename Node>
+		static inline bool isPreferred(Node const& lhs, Node const& rhs)
+		{
+			return lhs.given_cost < rhs.given_cost;
+		}
+	};
+
+	//! \brief Open-list policy that keeps the nodes sorted in a deque, best at the back, as
+	//! <code>PriorityQueue</code> does.
+	//!
+	//! An open list is parameterised on the search node and a comparator, whose static
+	//! <code>isCostlier(lhs, rhs)</code> returns <code>true</code> if <code>rhs</code> should be
+	//! expanded before <code>lhs</code>.  It provides <code>empty()</code>, <code>size()</code>,
+	//! <code>clear()</code>, <code>push()</code>, <code>front()</code>, <code>pop()</code> and
+	//! <code>update()</code>, which restores the order after a node's priority decreased.
+	//!
+	//! Pushing costs a binary search and a linear insertion; popping is constant time.
+	template <typename Node, typename Compare>
+	class SortedOpenList
+	{
+		std::deque<Node*> nodes;
+
+		static inline bool isCostlier(Node* lhs, Node* rhs)
+		{
+			return Compare::isCostlier(*lhs, *rhs);
+		}
+
+	public:
+		inline bool empty() const
+		{
+			return nodes.empty();
+		}
+
+		inline std::size_t size() const
+		{
+			return nodes.size();
+		}
+
+		inline void clear()
+		{
+			nodes.clear();
+		}
+
+		inline void push(Node* node)
+		{
+			nodes.insert(std::upper_bound(nodes.begin(), nodes.end(), node, isCostlier), node);
+		}
+
+		inline Node* front() const
+		{
+			return nodes.back();
+		}
+
+		inline void pop()
+		{
+			nodes.pop_back();
+		}
+
+		//! \brief Moves the specified node, which must be in the list, to its new place.
+		//!
+		//! The node's old priority is gone, so it is found by a linear scan.
+		inline void update(Node* node)
+		{
+			nodes.erase(std::find(nodes.begin(), nodes.end(), node));
+			push(node);
+		}
+	};
+
+	//! \brief Open-list policy that keeps the nodes in an indexed binary heap.
+	//!
+	//! Each node records its position in the heap in its <code>open_index</code> member, so a
+	//! node whose priority decreased is sifted up from where it is, in logarithmic time, with
+	//! no search for it.
+	template <typename Node, typename Compare>
+	class BinaryHeapOpenList
+	{
+		std::vector<Node*> nodes;
+
+		inline void place(Node* node, std::size_t index)
+		{
+			nodes[index] = node;
+			node->open_index = static_cast<int>(index);
+		}
+
+		inline void siftUp(Node* node, std::size_t index)
+		{
+			while (index)
+			{
+				std::size_t const parent = (index - 1) >> 1;
+
+				if (!Compare::isCostlier(*nodes[parent], *node))
+				{
+					break;
+				}
+
+				place(nodes[parent], index);
+				index = parent;
+			}
+
+			place(node, index);
+		}
+
+		inline void siftDown(Node* node, std::size_t index)
+		{
+			std::size_t const count = nodes.size();
+
+			for (std::size_t child = 2 * index + 1; child < count; child = 2 * index + 1)
+			{
+				if ((child + 1 < count) && Compare::isCostlier(*nodes[child], *nodes[child + 1]))
+				{
+					++child;
+				}
+
+				if (!Compare::isCostlier(*node, *nodes[child]))
+				{
+					break;
+				}
+
+				place(nodes[child], index);
+				index = child;
+			}
+
+			place(node, index);
+		}
+
+	public:
+		inline bool empty() const
+		{
+			return nodes.empty();
+		}
+
+		inline std::size_t size() const
+		{
+			return nodes.size();
+		}
+
+		inline void clear()
+		{
+			nodes.clear();
+		}
+
+		inline void push(Node* node)
+		{
+			nodes.push_back(node);
+			siftUp(node, nodes.size() - 1);
+		}
+
+		inline Node* front() const
+		{
+			return nodes.front();
+		}
+
+		inline void pop()
+		{
+			Node* const last = nodes.back();
+
+			nodes.pop_back();
+
+			if (!nodes.empty())
+			{
+				siftDown(last, 0);
+			}
+		}
+
+		//! \brief Sifts the specified node, which must be in the heap, up to its new place.
+		inline void update(Node* node)
+		{
+			siftUp(node, static_cast<std::size_t>(node->open_index));
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,166 @@
+//! \file BestFirstRegistry.h
+//! \brief Names the <code>fullsail_ai::algorithms::BestFirstSearch</code> engines the tools can
+//! run.
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include "BestFirstSearch.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Dijkstra's algorithm: no heuristic at all.
+	typedef BestFirstSearch<ZeroHeuristic, BinaryHeapOpenList, PreferDeeperTieBreak,
+	                        AStarWeighting> DijkstraSearch;
+
+	//! \brief A* with the step-count heuristic and an indexed binary heap.
+	typedef BestFirstSearch<GridDistanceHeuristic, BinaryHeapOpenList, PreferDeeperTieBreak,
+	                        AStarWeighting> HeapAStarSearch;
+
+	//! \brief A* with the step-count heuristic and the sorted open list of
+	//! <code>PriorityQueue</code>, the policies of <code>PathSearch</code> without its kernel.
+	typedef BestFirstSearch<GridDistanceHeuristic, SortedOpenList, PreferDeeperTieBreak,
+	                        AStarWeighting> SortedAStarSearch;
+
+	//! \brief A* that breaks ties towards the start, for comparison.
+	typedef BestFirstSearch<GridDistanceHeuristic, BinaryHeapOpenList, PreferShallowerTieBreak,
+	                        AStarWeighting> ShallowAStarSearch;
+
+	//! \brief A* with the straight-line heuristic.
+	typedef BestFirstSearch<EuclideanHeuristic, BinaryHeapOpenList, PreferDeeperTieBreak,
+	                        AStarWeighting> EuclideanAStarSearch;
+
+	//! \brief Weighted A* with a weight of 1.5.
+	typedef BestFirstSearch<GridDistanceHeuristic, BinaryHeapOpenList, PreferDeeperTieBreak,
+	                        WeightedAStarWeighting<3, 2> > WeightedAStarSearch;
+
+	//! \brief Weighted A* with a weight of 2.
+	typedef BestFirstSearch<GridDistanceHeuristic, BinaryHeapOpenList, PreferDeeperTieBreak,
+	                        WeightedAStarWeighting<2, 1> > DoubleWeightedAStarSearch;
+
+	//! \brief Greedy best-first search with the step-count heuristic.
+	typedef BestFirstSearch<GridDistanceHeuristic, BinaryHeapOpenList, PreferDeeperTieBreak,
+	                        GreedyWeighting> GreedySearch;
+
+	//! \brief One engine the tools know by name.
+	struct BestFirstEngine
+	{
+		//! \brief The name passed to <code>--engine</code>.
+		char const* name;
+
+		//! \brief A one-line description for usage messages.
+		char const* description;
+
+		//! \brief The most the cost of a path found can exceed the optimal cost by, as a
+		//! factor: 1 for an optimal engine, or 0 if the cost is not bounded at all.
+		double cost_bound;
+	};
+
+	//! \brief Every engine <code>visitBestFirstEngine()</code> can build, in the order of its
+	//! cases.
+	static BestFirstEngine const BEST_FIRST_ENGINES[] =
+	{
+		{ "dijkstra", "Dijkstra's algorithm, binary heap", 1.0 },
+		{ "bf-astar", "A*, step-count heuristic, binary heap", 1.0 },
+		{ "bf-sorted", "A*, step-count heuristic, sorted open list", 1.0 },
+		{ "bf-shallow", "A*, ties broken towards the start", 1.0 },
+		{ "bf-euclid", "A*, straight-line heuristic", 1.0 },
+		{ "wastar-1.5", "weighted A*, weight 1.5", 1.5 },
+		{ "wastar-2", "weighted A*, weight 2", 2.0 },
+		{ "greedy", "greedy best-first search", 0.0 }
+	};
+
+	//! \brief The number of entries of <code>BEST_FIRST_ENGINES</code>.
+	static std::size_t const BEST_FIRST_ENGINE_COUNT
+		= sizeof(BEST_FIRST_ENGINES) / sizeof(BEST_FIRST_ENGINES[0]);
+
+	//! \brief Builds the engine of the specified name and passes it to <code>visitor</code>,
+	//! along with its entry in <code>BEST_FIRST_ENGINES</code>.
+	//!
+	//! The visitor is called as <code>visitor(engine, entry)</code> and should be a function
+	//! object with a templated call operator, so that each engine is driven by code compiled
+	//! for its own type.  The engine lives until the visitor returns.
+	//!
+	//! \return  <code>false</code> if no engine has that name, <code>true</code> otherwise.
+	template <typename Visitor>
+	bool visitBestFirstEngine(char const* name, Visitor& visitor)
+	{
+		std::size_t index = 0;
+
+		while ((index < BEST_FIRST_ENGINE_COUNT)
+		    && std::strcmp(name, BEST_FIRST_ENGINES[index].name))
+		{
+			++index;
+		}
+
+		if (index == BEST_FIRST_ENGINE_COUNT)
+		{
+			return false;
+		}
+
+		BestFirstEngine const& entry = BEST_FIRST_ENGINES[index];
+
+		switch (index)
+		{
+		case 0:
+			{
+				DijkstraSearch engine;
+
+				visitor(engine, entry);
+				return true;
+			}
+		case 1:
+			{
+				HeapAStarSearch engine;
+
+				visitor(engine, entry);
+				return true;
+			}
+		case 2:
+			{
+				SortedAStarSearch engine;
+
+				visitor(engine, entry);
+				return true;
+			}
+		case 3:
+			{
+				ShallowAStarSearch engine;
+
+				visitor(engine, entry);
+				return true;
+			}
+		case 4:
+			{
+				EuclideanAStarSearch engine;
+
+				visitor(engine, entry);
+				return true;
+			}
+		case 5:
+			{
+				WeightedAStarSearch engine;
+
+				visitor(engine, entry);
+				return true;
+			}
+		case 6:
+			{
+				DoubleWeightedAStarSearch engine;
+
+				visitor(engine, entry);
+				return true;
+			}
+		case 7:
+			{
+				GreedySearch engine;
+
+				visitor(engine, entry);
+				return true;
+			}
+		default:
+			return false;
+		}
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,365 @@
+//! \file BestFirstSearch.h
+//! \brief Defines the <code>fullsail_ai::algorithms::BestFirstSearch</code> class template.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "../TileLibrary/TileMap.h"
+#include "BestFirstPolicies.h"
+#include "ComponentIndex.h"
+#include "GridTopology.h"
+#include "PathView.h"
+#include "Tracer.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Time-sliced best-first search assembled from policies, over a tile map of any
+	//! <code>TileTopology</code>.
+	//!
+	//! Each combination of policies compiles to its own engine: every policy call is resolved,
+	//! and can be inlined, at compile time, and the search loop is compiled once per topology
+	//! as in <code>PathSearch</code>.  The engine has the same interface as the hand-written
+	//! ones, so the tools drive it through the same templates.  The combinations the tools
+	//! know by name are listed in BestFirstRegistry.h.
+	//!
+	//! Entering a tile costs its weight, as for every other engine.  A node is closed once
+	//! expanded and never reopened, which keeps A* optimal with a consistent heuristic and
+	//! weighted A* within its bound.
+	//!
+	//! \tparam Heuristic  <code>ZeroHeuristic</code>, <code>EuclideanHeuristic</code> or
+	//!                    <code>GridDistanceHeuristic</code>.
+	//! \tparam OpenList   <code>SortedOpenList</code> or <code>BinaryHeapOpenList</code>.
+	//! \tparam TieBreak   <code>PreferDeeperTieBreak</code> or
+	//!                    <code>PreferShallowerTieBreak</code>.
+	//! \tparam Weighting  <code>AStarWeighting</code>, <code>WeightedAStarWeighting</code> or
+	//!                    <code>GreedyWeighting</code>.
+	template <typename Heuristic, template <typename, typename> class OpenList, typename TieBreak,
+	          typename Weighting>
+	class BestFirstSearch
+	{
+		struct SearchNode
+		{
+			Tile const* tile;
+			SearchNode* parent;
+			double given_cost;
+			double final_cost;
+			unsigned int generation;
+			int open_index;
+			bool is_closed;
+		};
+
+		struct Compare
+		{
+			static inline bool isCostlier(SearchNode const& lhs, SearchNode const& rhs)
+			{
+				return (lhs.final_cost == rhs.final_cost)
+				     ? TieBreak::isPreferred(rhs, lhs)
+				     : (rhs.final_cost < lhs.final_cost);
+			}
+		};
+
+		TileMap* tile_map;
+		std::vector<SearchNode> nodes;
+		OpenList<SearchNode, Compare> open;
+		Heuristic heuristic;
+		Tile const* goal_tile;
+		unsigned int generation;
+		unsigned int map_version;
+		bool is_done;
+		std::vector<Tile const*> solution;
+		ComponentIndex const* component_index;
+		std::size_t peak_open_size;
+		std::size_t expansion_count;
+
+		BestFirstSearch(BestFirstSearch const&);
+		BestFirstSearch& operator=(BestFirstSearch const&);
+
+		template <typename Topology>
+		inline void expand(SearchNode* node, Topology)
+		{
+			TileMapView const view = tile_map->getView();
+			int const row = node->tile->getRow();
+			int const column = node->tile->getColumn();
+			int const (*offsets)[2] = Topology::getOffsets(row);
+
+			for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+			{
+				int const successor_row = row + offsets[direction][0];
+				int const successor_column = column + offsets[direction][1];
+
+				if (!view.getWeight(successor_row, successor_column))
+				{
+					continue;
+				}
+
+				int const index = view.getIndex(successor_row, successor_column);
+				SearchNode* const successor = &nodes[index];
+				double const given_cost = node->given_cost + view.getTile(index)->getWeight();
+
+				if (successor->generation != generation)
+				{
+					successor->tile = view.getTile(index);
+					successor->parent = node;
+					successor->given_cost = given_cost;
+					successor->final_cost = Weighting::getFinalCost(
+						given_cost
+					  , heuristic.template estimate<Topology>(successor_row, successor_column,
+					                                          successor->tile)
+					);
+					successor->generation = generation;
+					successor->is_closed = false;
+					open.push(successor);
+				}
+				else if (!successor->is_closed && (given_cost < successor->given_cost))
+				{
+					// Every weighting is affine in the given cost, so the estimate's share of the
+					// final cost stays as it was.
+					successor->final_cost += Weighting::getFinalCost(given_cost, 0.0)
+					                       - Weighting::getFinalCost(successor->given_cost, 0.0);
+					successor->given_cost = given_cost;
+					successor->parent = node;
+					open.update(successor);
+				}
+			}
+		}
+
+		void run(long timeslice, std::size_t expansion_budget)
+		{
+			switch (tile_map->getTopology())
+			{
+			case HEX_EVEN_ROWS:
+				run(timeslice, expansion_budget, HexEvenRowTopology());
+				break;
+			case SQUARE_FOUR:
+				run(timeslice, expansion_budget, SquareFourTopology());
+				break;
+			case SQUARE_EIGHT:
+				run(timeslice, expansion_budget, SquareEightTopology());
+				break;
+			default:
+				run(timeslice, expansion_budget, HexOddRowTopology());
+			}
+		}
+
+		template <typename Topology>
+		void run(long timeslice, std::size_t expansion_budget, Topology)
+		{
+			// An expansion budget replaces the clock entirely.
+			std::chrono::steady_clock::time_point const deadline = expansion_budget
+				? std::chrono::steady_clock::time_point()
+				: std::chrono::steady_clock::now() + std::chrono::milliseconds(timeslice);
+
+			while (!is_done)
+			{
+				if (open.empty())
+				{
+					// Every reachable tile has been closed without finding the goal.
+					is_done = true;
+					break;
+				}
+
+				SearchNode* node = open.front();
+
+				open.pop();
+
+				if (node->tile == goal_tile)
+				{
+					for (; node; node = node->parent)
+					{
+						solution.push_back(node->tile);
+					}
+
+					is_done = true;
+					break;
+				}
+
+				node->is_closed = true;
+				expand(node, Topology());
+				++expansion_count;
+
+				if (peak_open_size < open.size())
+				{
+					peak_open_size = open.size();
+				}
+
+				if (expansion_budget ? !--expansion_budget
+				                     : (!timeslice || (deadline <= std::chrono::steady_clock::now())))
+				{
+					break;
+				}
+			}
+		}
+
+	public:
+		//! \brief Constructs a search that is not yet bound to a tile map.
+		inline BestFirstSearch()
+			: tile_map(0), nodes(), open(), heuristic(), goal_tile(0), generation(0)
+			, map_version(0), is_done(false), solution(), component_index(0), peak_open_size(0)
+			, expansion_count(0)
+		{
+		}
+
+		//! \brief Binds the search to the specified tile map and allocates its per-tile nodes.
+		//!
+		//! Call this again whenever the tile map is reloaded.
+		inline void initialize(TileMap* map)
+		{
+			tile_map = map;
+			nodes.clear();
+			nodes.resize(tile_map->getRowCount() * tile_map->getColumnCount());
+			generation = 0;
+			map_version = tile_map->getVersion();
+			heuristic.initialize(*tile_map);
+		}
+
+		//! \brief Begins a new search between the specified locations.
+		//!
+		//! If a current component index shows the goal to be unreachable, the search finishes
+		//! immediately.
+		void enter(int start_row, int start_column, int goal_row, int goal_column)
+		{
+			TraceScope scope("enter");
+
+			if (nodes.size() != static_cast<std::size_t>(tile_map->getRowCount()
+			                                              * tile_map->getColumnCount()))
+			{
+				initialize(tile_map);
+			}
+			else if (map_version != tile_map->getVersion())
+			{
+				// The topology or the minimum weight, and so the estimates, may have changed.
+				map_version = tile_map->getVersion();
+				heuristic.initialize(*tile_map);
+			}
+
+			// Bump the stamp so that every node left over from the previous search reads as unseen.
+			if (!++generation)
+			{
+				nodes.assign(nodes.size(), SearchNode());
+				generation = 1;
+			}
+
+			TileMapView const view = tile_map->getView();
+			SearchNode* const start_node = &nodes[view.getIndex(start_row, start_column)];
+
+			open.clear();
+			solution.clear();
+			goal_tile = view.getTile(goal_row, goal_column);
+			heuristic.setGoal(goal_tile);
+			is_done = false;
+			peak_open_size = 0;
+			expansion_count = 0;
+
+			if (component_index
+			 && component_index->isUnreachable(view.getIndex(start_row, start_column),
+			                                   view.getIndex(goal_row, goal_column)))
+			{
+				is_done = true;
+				return;
+			}
+
+			start_node->tile = view.getTile(start_row, start_column);
+			start_node->parent = 0;
+			start_node->given_cost = 0.0;
+			start_node->final_cost = Weighting::getFinalCost(0.0, 0.0);
+			start_node->generation = generation;
+			start_node->is_closed = false;
+			open.push(start_node);
+		}
+
+		//! \brief Runs the search for roughly <code>timeslice</code> milliseconds, or for a
+		//! single expansion if <code>timeslice</code> is zero.
+		void update(long timeslice)
+		{
+			TraceScope scope("update", timeslice);
+
+			run(timeslice, 0);
+		}
+
+		//! \brief Runs the search for at most <code>expansion_budget</code> expansions without
+		//! reading the clock, so the same inputs always make the same progress.
+		void updateExpansions(std::size_t expansion_budget)
+		{
+			TraceScope scope("updateExpansions", static_cast<long long>(expansion_budget));
+
+			if (expansion_budget)
+			{
+				run(0, expansion_budget);
+			}
+		}
+
+		//! \brief Cleans up the open list of the current search.
+		//!
+		//! <code>isDone()</code> keeps reporting the outcome of the search that was exited.
+		inline void exit()
+		{
+			TraceScope scope("exit");
+
+			open.clear();
+		}
+
+		//! \brief Releases the memory allocated by <code>initialize()</code>.
+		inline void shutdown()
+		{
+			open.clear();
+			solution.clear();
+			std::vector<SearchNode>().swap(nodes);
+			tile_map = 0;
+			is_done = false;
+		}
+
+		//! \brief Returns <code>true</code> if the current search has either found the goal or
+		//! proven it unreachable, <code>false</code> otherwise.
+		inline bool isDone() const
+		{
+			return is_done;
+		}
+
+		//! \brief Returns the path found by the current search, goal first and start last, or
+		//! an empty vector if the goal is unreachable.
+		inline std::vector<Tile const*> const getSolution() const
+		{
+			TraceScope scope("getSolution");
+
+			return solution;
+		}
+
+		//! \brief Returns the same path as <code>getSolution()</code> without copying it.
+		//!
+		//! The view stays valid until the next call to <code>enter()</code> or
+		//! <code>shutdown()</code>.
+		inline PathView getSolutionView() const
+		{
+			return PathView(solution);
+		}
+
+		//! \brief Attaches an index that <code>enter()</code> consults to reject unreachable
+		//! goals without searching, or detaches the index if <code>NULL</code>.
+		inline void setComponentIndex(ComponentIndex const* index)
+		{
+			component_index = index;
+		}
+
+		//! \brief Returns the number of bytes currently held by the per-tile nodes and the open
+		//! list.
+		inline std::size_t getMemoryUsage() const
+		{
+			return nodes.capacity() * sizeof(SearchNode) + open.size() * sizeof(SearchNode*);
+		}
+
+		//! \brief Returns the largest value <code>getMemoryUsage()</code> has reached since the
+		//! last call to <code>enter()</code>.
+		inline std::size_t getPeakMemoryUsage() const
+		{
+			return nodes.capacity() * sizeof(SearchNode) + peak_open_size * sizeof(SearchNode*);
+		}
+
+		//! \brief Returns the number of nodes expanded since the last call to <code>enter()</code>.
+		inline std::size_t getExpansionCount() const
+		{
+			return expansion_count;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,53 @@
+#include "CompactPath.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	bool CompactPath::assign(PathView path, TileMap const& tile_map)
+	{
+		clear();
+
+		if (path.empty())
+		{
+			return true;
+		}
+
+		step_count = path.size() - 1;
+		words.assign((step_count + STEPS_PER_WORD - 1) / STEPS_PER_WORD, 0);
+
+		// The engines' paths run goal first, so the steps are read from the back.
+		for (size_t step = 0; step < step_count; ++step)
+		{
+			Tile const* const from = path[step_count - step];
+			Tile const* const to = path[step_count - step - 1];
+			int const direction = getGridDirection(tile_map, from->getRow(), from->getColumn(),
+			                                       to->getRow(), to->getColumn());
+
+			if (direction < 0)
+			{
+				clear();
+				return false;
+			}
+
+			words[step / STEPS_PER_WORD]
+				|= static_cast<unsigned int>(direction) << (step % STEPS_PER_WORD * BITS_PER_STEP);
+		}
+
+		start_index = tile_map.getView().getIndex(path.back()->getRow(), path.back()->getColumn());
+		return true;
+	}
+
+	void CompactPath::decode(TileMap const& tile_map, vector<Tile const*>& path) const
+	{
+		path.resize(size());
+
+		// Fill the vector from its end, so that the goal lands first.
+		size_t index = path.size();
+
+		for (const_iterator itr = begin(tile_map); index; ++itr)
+		{
+			path[--index] = *itr;
+		}
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,228 @@
+//! \file CompactPath.h
+//! \brief Defines the <code>fullsail_ai::algorithms::CompactPath</code> class.
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "GridTopology.h"
+#include "PathView.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief A path stored as the index of its start and the direction of each step, for
+	//! keeping many paths or sending them to another process.
+	//!
+	//! A direction fits in three bits on every <code>TileTopology</code>, so a step takes 3 bits
+	//! instead of the 64 of a <code>Tile</code> pointer, and ten steps are packed into each
+	//! 32-bit word, lowest bits first.  The encoding holds no pointers and does not depend on the
+	//! process, only on the map's dimensions and topology.
+	//!
+	//! Unlike the engines' paths, a compact path runs from the start to the goal.  Its tiles are
+	//! decoded one at a time, as <code>const_iterator</code> is advanced, against the map the
+	//! path was encoded on.
+	class CompactPath
+	{
+	public:
+		//! \brief The number of bits holding one direction.
+		static int const BITS_PER_STEP = 3;
+
+		//! \brief The number of steps packed into one word.
+		static int const STEPS_PER_WORD = 32 / BITS_PER_STEP;
+
+		//! \brief Decodes the tiles of a compact path, start first.
+		class const_iterator
+		{
+			TileMapView view;
+			TileTopology topology;
+			unsigned int const* words;
+			std::size_t step_count;
+			std::size_t step;
+			int row;
+			int column;
+
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef Tile const* value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Tile const* const* pointer;
+			typedef Tile const* reference;
+
+			//! \brief Constructs an iterator that points nowhere.
+			inline const_iterator()
+				: view(), topology(HEX_ODD_ROWS), words(0), step_count(0), step(0), row(0)
+				, column(0)
+			{
+			}
+
+			//! \brief Constructs an iterator to the tile reached after the specified number of
+			//! steps of the specified path, which must be at <code>(row, column)</code> of the map.
+			inline const_iterator(TileMap const& tile_map, CompactPath const& path,
+			                      std::size_t step_index, int tile_row, int tile_column)
+				: view(tile_map.getView()), topology(tile_map.getTopology())
+				, words(path.words.empty() ? 0 : &path.words[0]), step_count(path.step_count)
+				, step(step_index), row(tile_row), column(tile_column)
+			{
+			}
+
+			//! \brief Returns the current tile.
+			inline Tile const* operator*() const
+			{
+				return view.getTile(row, column);
+			}
+
+			//! \brief Takes the next step of the path.
+			inline const_iterator& operator++()
+			{
+				// Past the goal there is no step left to take.
+				if (step < step_count)
+				{
+					int const* offset = getGridOffsets(topology, row)[unpack(words, step)];
+
+					row += offset[0];
+					column += offset[1];
+				}
+
+				++step;
+				return *this;
+			}
+
+			//! \brief Takes the next step of the path, returning the iterator as it was.
+			inline const_iterator operator++(int)
+			{
+				const_iterator const result = *this;
+
+				++*this;
+				return result;
+			}
+
+			//! \brief Returns <code>true</code> if both iterators have taken as many steps,
+			//! <code>false</code> otherwise.
+			inline bool operator==(const_iterator const& other) const
+			{
+				return step == other.step;
+			}
+
+			//! \brief Returns <code>false</code> if both iterators have taken as many steps,
+			//! <code>true</code> otherwise.
+			inline bool operator!=(const_iterator const& other) const
+			{
+				return step != other.step;
+			}
+		};
+
+	private:
+		int start_index;
+		std::size_t step_count;
+		std::vector<unsigned int> words;
+
+		static inline int unpack(unsigned int const* words, std::size_t step)
+		{
+			return static_cast<int>((words[step / STEPS_PER_WORD]
+			                         >> (step % STEPS_PER_WORD * BITS_PER_STEP)) & 7);
+		}
+
+	public:
+		//! \brief Constructs an empty path.
+		inline CompactPath() : start_index(-1), step_count(0), words()
+		{
+		}
+
+		//! \brief Constructs a path from the fields of another, as received from another
+		//! process.
+		//!
+		//! \param   start       the row-major index of the start, or -1 for an empty path.
+		//! \param   steps       the number of steps, one fewer than the number of tiles.
+		//! \param   step_words  the packed directions, as returned by <code>getWords()</code>.
+		inline CompactPath(int start, std::size_t steps,
+		                   std::vector<unsigned int> const& step_words)
+			: start_index(start), step_count(steps), words(step_words)
+		{
+		}
+
+		//! \brief Encodes the specified path, goal first as the engines return it, found on
+		//! the specified map.
+		//!
+		//! \return  <code>false</code>, leaving this path empty, if two consecutive tiles of
+		//!          the path are not adjacent on the map, <code>true</code> otherwise.
+		DLLEXPORT bool assign(PathView path, TileMap const& tile_map);
+
+		//! \brief Makes this path empty, keeping its memory.
+		inline void clear()
+		{
+			start_index = -1;
+			step_count = 0;
+			words.clear();
+		}
+
+		//! \brief Returns <code>true</code> if the path has no tiles, <code>false</code>
+		//! otherwise.
+		inline bool empty() const
+		{
+			return start_index < 0;
+		}
+
+		//! \brief Returns the number of tiles on the path, start and goal included.
+		inline std::size_t size() const
+		{
+			return empty() ? 0 : step_count + 1;
+		}
+
+		//! \brief Returns the row-major index of the start, or -1 if the path is empty.
+		inline int getStartIndex() const
+		{
+			return start_index;
+		}
+
+		//! \brief Returns the number of steps, one fewer than the number of tiles.
+		inline std::size_t getStepCount() const
+		{
+			return step_count;
+		}
+
+		//! \brief Returns the direction (see <code>getGridOffsets()</code>) of the specified step.
+		inline int getDirection(std::size_t step) const
+		{
+			return unpack(&words[0], step);
+		}
+
+		//! \brief Returns the packed directions, <code>STEPS_PER_WORD</code> to a word.
+		inline std::vector<unsigned int> const& getWords() const
+		{
+			return words;
+		}
+
+		//! \brief Returns an iterator to the start, decoding against the specified map.
+		inline const_iterator begin(TileMap const& tile_map) const
+		{
+			if (empty())
+			{
+				return const_iterator();
+			}
+
+			int const column_count = tile_map.getColumnCount();
+
+			return const_iterator(tile_map, *this, 0, start_index / column_count,
+			                      start_index % column_count);
+		}
+
+		//! \brief Returns an iterator past the goal.
+		inline const_iterator end(TileMap const& tile_map) const
+		{
+			return const_iterator(tile_map, *this, size(), 0, 0);
+		}
+
+		//! \brief Writes every tile of the path to <code>path</code>, goal first as the engines
+		//! return them.
+		DLLEXPORT void decode(TileMap const& tile_map, std::vector<Tile const*>& path) const;
+
+		//! \brief Returns the number of bytes held by the packed directions.
+		inline std::size_t getMemoryUsage() const
+		{
+			return words.capacity() * sizeof(unsigned int);
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,394 @@
+#include <thread>
+
+#include "ComponentIndex.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	// Bands thinner than this are not worth a thread of their own.
+	static int const MIN_BAND_ROWS = 32;
+
+	ComponentIndex::ComponentIndex(TileMap const& map)
+		: tile_map(&map), map_version(0), thread_count(0), labels(), parents(), sizes()
+		, component_count(0), rebuild_count(0)
+	{
+	}
+
+	int ComponentIndex::find(int node)
+	{
+		// Path halving: every other node on the way up skips to its grandparent.
+		while (parents[node] != node)
+		{
+			parents[node] = parents[parents[node]];
+			node = parents[node];
+		}
+
+		return node;
+	}
+
+	bool ComponentIndex::unite(int node, int other_node)
+	{
+		int root = find(node);
+		int other_root = find(other_node);
+
+		if (root == other_root)
+		{
+			return false;
+		}
+
+		// Hang the smaller tree under the larger one to keep every tree shallow.
+		if (sizes[root] < sizes[other_root])
+		{
+			int const swapped = root;
+
+			root = other_root;
+			other_root = swapped;
+		}
+
+		parents[other_root] = root;
+		sizes[root] += sizes[other_root];
+		return true;
+	}
+
+	template <typename Topology>
+	void ComponentIndex::uniteRow(int row, int first_row, Topology)
+	{
+		TileMapView const view = tile_map->getView();
+		int const (*offsets)[2] = Topology::getOffsets(row);
+
+		for (int column = 0; column < view.getColumnCount(); ++column)
+		{
+			if (!view.getWeight(row, column))
+			{
+				continue;
+			}
+
+			int const node = labels[view.getIndex(row, column)];
+
+			for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+			{
+				int const neighbor_row = row + offsets[direction][0];
+				int const neighbor_column = column + offsets[direction][1];
+
+				// Each pair of neighbours is linked once, from the later tile of the two.
+				if ((neighbor_row < first_row) || (row < neighbor_row)
+				 || ((row == neighbor_row) && (column < neighbor_column))
+				 || !view.getWeight(neighbor_row, neighbor_column))
+				{
+					continue;
+				}
+
+				unite(node, labels[view.getIndex(neighbor_row, neighbor_column)]);
+			}
+		}
+	}
+
+	template <typename Topology>
+	void ComponentIndex::buildBand(int first_row, int end_row, Topology)
+	{
+		TileMapView const view = tile_map->getView();
+
+		for (int row = first_row; row < end_row; ++row)
+		{
+			for (int column = 0; column < view.getColumnCount(); ++column)
+			{
+				int const index = view.getIndex(row, column);
+				bool const is_passable = (view.getWeight(row, column) != 0);
+
+				labels[index] = is_passable ? index : -1;
+				parents[index] = index;
+				sizes[index] = is_passable ? 1 : 0;
+			}
+
+			// Links stay within the band, so no other thread touches the same nodes.
+			uniteRow(row, first_row, Topology());
+		}
+	}
+
+	void ComponentIndex::flattenBand(int first_index, int end_index, vector<int>& roots) const
+	{
+		for (int index = first_index; index < end_index; ++index)
+		{
+			roots[index] = findRoot(index);
+		}
+	}
+
+	template <typename Topology>
+	void ComponentIndex::label(Topology)
+	{
+		int const row_count = tile_map->getRowCount();
+		int const column_count = tile_map->getColumnCount();
+		size_t const tile_count = static_cast<size_t>(row_count) * column_count;
+		size_t band_count = static_cast<size_t>(row_count / MIN_BAND_ROWS);
+		vector<int> band_rows;
+		vector<thread> threads;
+
+		if (thread_count < band_count)
+		{
+			band_count = thread_count;
+		}
+
+		if (!band_count)
+		{
+			band_count = 1;
+		}
+
+		for (size_t band = 0; band <= band_count; ++band)
+		{
+			band_rows.push_back(static_cast<int>(band * row_count / band_count));
+		}
+
+		map_version = tile_map->getVersion();
+		labels.resize(tile_count);
+		parents.resize(tile_count);
+		sizes.resize(tile_count);
+
+		// The first band is built on the calling thread.
+		for (size_t band = 1; band < band_count; ++band)
+		{
+			threads.push_back(thread(&ComponentIndex::buildBand<Topology>, this, band_rows[band],
+			                         band_rows[band + 1], Topology()));
+		}
+
+		buildBand(band_rows[0], band_rows[1], Topology());
+
+		for (size_t i = 0; i < threads.size(); ++i)
+		{
+			threads[i].join();
+		}
+
+		threads.clear();
+
+		// Stitch each band to the one above it.
+		for (size_t band = 1; band < band_count; ++band)
+		{
+			uniteRow(band_rows[band], band_rows[band] - 1, Topology());
+		}
+
+		// Point every node straight at its root, so that queries take a single step until the
+		// next edit.
+		vector<int> roots(tile_count);
+
+		for (size_t band = 1; band < band_count; ++band)
+		{
+			threads.push_back(thread(&ComponentIndex::flattenBand, this,
+			                         band_rows[band] * column_count,
+			                         band_rows[band + 1] * column_count, ref(roots)));
+		}
+
+		flattenBand(0, band_rows[1] * column_count, roots);
+
+		for (size_t i = 0; i < threads.size(); ++i)
+		{
+			threads[i].join();
+		}
+
+		parents.swap(roots);
+		component_count = 0;
+
+		for (size_t index = 0; index < tile_count; ++index)
+		{
+			if ((labels[index] >= 0) && (parents[index] == static_cast<int>(index)))
+			{
+				++component_count;
+			}
+		}
+	}
+
+	void ComponentIndex::build(size_t threads)
+	{
+		thread_count = threads;
+
+		if (!thread_count)
+		{
+			thread_count = thread::hardware_concurrency() ? thread::hardware_concurrency() : 1;
+		}
+
+		++rebuild_count;
+
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			label(HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			label(SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			label(SquareEightTopology());
+			break;
+		default:
+			label(HexOddRowTopology());
+		}
+	}
+
+	template <typename Topology>
+	void ComponentIndex::onTileWeightChanged(int row, int column, unsigned char new_weight,
+	                                         Topology)
+	{
+		TileMapView const view = tile_map->getView();
+		int const tile = view.getIndex(row, column);
+		int const (*offsets)[2] = Topology::getOffsets(row);
+
+		if (new_weight)
+		{
+			// The tile's old node, if any, may still hold other tiles together; start afresh.
+			labels[tile] = static_cast<int>(parents.size());
+			parents.push_back(labels[tile]);
+			sizes.push_back(1);
+			++component_count;
+
+			for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+			{
+				int const neighbor_row = row + offsets[direction][0];
+				int const neighbor_column = column + offsets[direction][1];
+
+				if (view.getWeight(neighbor_row, neighbor_column)
+				 && unite(labels[tile], labels[view.getIndex(neighbor_row, neighbor_column)]))
+				{
+					--component_count;
+				}
+			}
+
+			// Only a rebuild reclaims the nodes of tiles made impassable.
+			if (2 * labels.size() < parents.size())
+			{
+				build(thread_count);
+			}
+
+			return;
+		}
+
+		// The offsets run around the tile in order, so the passable neighbours form runs.
+		int passable_count = 0;
+		int run_count = 0;
+
+		for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+		{
+			int const previous = (direction ? direction : Topology::DIRECTION_COUNT) - 1;
+
+			if (view.getWeight(row + offsets[direction][0], column + offsets[direction][1]))
+			{
+				++passable_count;
+
+				if (!view.getWeight(row + offsets[previous][0], column + offsets[previous][1]))
+				{
+					++run_count;
+				}
+			}
+		}
+
+		// Neighbours next to each other around a hexagon, or around a square counting its
+		// corners, are adjacent themselves, so a single run stays connected without the tile.
+		// Around a square without corners, only a single neighbour is sure to.
+		bool const is_whole = (passable_count <= 1)
+		                   || ((Topology::DIRECTION_COUNT != 4) && (run_count <= 1));
+
+		if (!is_whole)
+		{
+			build(thread_count);
+			return;
+		}
+
+		int const root = find(labels[tile]);
+
+		labels[tile] = -1;
+
+		if (!--sizes[root])
+		{
+			--component_count;
+		}
+	}
+
+	template <typename Topology>
+	bool ComponentIndex::isNeighborConnected(int row, int column, int goal_tile, Topology) const
+	{
+		TileMapView const view = tile_map->getView();
+		int const (*offsets)[2] = Topology::getOffsets(row);
+
+		for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+		{
+			int const neighbor_row = row + offsets[direction][0];
+			int const neighbor_column = column + offsets[direction][1];
+
+			if (view.getWeight(neighbor_row, neighbor_column)
+			 && isConnected(view.getIndex(neighbor_row, neighbor_column), goal_tile))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool ComponentIndex::isUnreachable(int start_tile, int goal_tile) const
+	{
+		if (!isCurrent() || (start_tile == goal_tile))
+		{
+			return false;
+		}
+
+		if (labels[start_tile] >= 0)
+		{
+			return !isConnected(start_tile, goal_tile);
+		}
+
+		// An impassable start is left for its neighbours without being charged for.
+		int const row = start_tile / tile_map->getColumnCount();
+		int const column = start_tile % tile_map->getColumnCount();
+
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			return !isNeighborConnected(row, column, goal_tile, HexEvenRowTopology());
+		case SQUARE_FOUR:
+			return !isNeighborConnected(row, column, goal_tile, SquareFourTopology());
+		case SQUARE_EIGHT:
+			return !isNeighborConnected(row, column, goal_tile, SquareEightTopology());
+		default:
+			return !isNeighborConnected(row, column, goal_tile, HexOddRowTopology());
+		}
+	}
+
+	void ComponentIndex::onTileWeightChanged(int row, int column, unsigned char old_weight)
+	{
+		unsigned char const new_weight = tile_map->getTile(row, column)->getWeight();
+
+		// The index can only follow a single edit made since it was last brought up to date.
+		if ((labels.size() != static_cast<size_t>(tile_map->getRowCount())
+		                      * tile_map->getColumnCount())
+		 || (map_version + 1 != tile_map->getVersion()))
+		{
+			if (!isCurrent())
+			{
+				build(thread_count);
+			}
+
+			return;
+		}
+
+		map_version = tile_map->getVersion();
+
+		// A change of weight between two passable values leaves every component as it was.
+		if (!old_weight == !new_weight)
+		{
+			return;
+		}
+
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			onTileWeightChanged(row, column, new_weight, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			onTileWeightChanged(row, column, new_weight, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			onTileWeightChanged(row, column, new_weight, SquareEightTopology());
+			break;
+		default:
+			onTileWeightChanged(row, column, new_weight, HexOddRowTopology());
+		}
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,151 @@
+//! \file ComponentIndex.h
+//! \brief Defines the <code>fullsail_ai::algorithms::ComponentIndex</code> class.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "GridTopology.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Labels every passable tile of a map with its connected component, so that a
+	//! query between two components can be rejected without searching.
+	//!
+	//! Without it, an engine proves a goal unreachable only by expanding every tile the start
+	//! can reach.  With it, <code>enter()</code> compares two labels.
+	//!
+	//! <code>build()</code> runs a union-find over bands of rows on several threads, then
+	//! stitches the bands together.  Edits reported through <code>onTileWeightChanged()</code>
+	//! are applied in place when they can only join components or shrink one; only an edit
+	//! that may split a component rebuilds the index.  A tile is made passable by giving it a
+	//! new union-find node, so nodes of tiles made impassable linger until the next rebuild.
+	//!
+	//! Tile indices are <code>row * column_count + column</code>, as in <code>PathCache</code>.
+	//! The queries only read the index, so any number of engines on any number of threads may
+	//! share it as long as nothing edits the map meanwhile.
+	class ComponentIndex
+	{
+		TileMap const* tile_map;
+		unsigned int map_version;
+		std::size_t thread_count;
+		std::vector<int> labels;
+		std::vector<int> parents;
+		std::vector<int> sizes;
+		std::size_t component_count;
+		unsigned int rebuild_count;
+
+		ComponentIndex(ComponentIndex const&);
+		ComponentIndex& operator=(ComponentIndex const&);
+
+		inline int findRoot(int node) const
+		{
+			while (parents[node] != node)
+			{
+				node = parents[node];
+			}
+
+			return node;
+		}
+
+		int find(int node);
+		bool unite(int node, int other_node);
+		template <typename Topology>
+		void uniteRow(int row, int first_row, Topology);
+		template <typename Topology>
+		void buildBand(int first_row, int end_row, Topology);
+		void flattenBand(int first_index, int end_index, std::vector<int>& roots) const;
+		template <typename Topology>
+		void label(Topology);
+		template <typename Topology>
+		void onTileWeightChanged(int row, int column, unsigned char new_weight, Topology);
+		template <typename Topology>
+		bool isNeighborConnected(int row, int column, int goal_tile, Topology) const;
+
+	public:
+		//! \brief Constructs an empty index over the specified tile map.  Call
+		//! <code>build()</code> before the first query.
+		DLLEXPORT explicit ComponentIndex(TileMap const& tile_map);
+
+		//! \brief Labels every tile of the map from scratch.
+		//!
+		//! \param   thread_count  the number of threads to build with, or zero for one per
+		//!                        hardware thread.  Rebuilds caused by edits use as many.
+		DLLEXPORT void build(std::size_t thread_count = 0);
+
+		//! \brief Updates the index after <code>TileMap::setTileWeight()</code> has changed the
+		//! weight of a single tile.
+		//!
+		//! A tile made passable joins the components of its passable neighbours.  A tile made
+		//! impassable leaves its component, which stays whole if the passable neighbours of the
+		//! tile touch one another in a single run around it; otherwise the index is rebuilt.
+		//! If more than one edit has been made to the map since the index was last brought up
+		//! to date, the index is rebuilt as well.
+		//!
+		//! \param   row         the row-coordinate of the changed tile.
+		//! \param   column      the column-coordinate of the changed tile.
+		//! \param   old_weight  the weight the tile had before the change.
+		DLLEXPORT void onTileWeightChanged(int row, int column, unsigned char old_weight);
+
+		//! \brief Returns <code>true</code> if the index reflects the map as it is now,
+		//! <code>false</code> if the map has changed in a way the index was not told about.
+		inline bool isCurrent() const
+		{
+			return tile_map && (map_version == tile_map->getVersion())
+			    && (labels.size() == static_cast<std::size_t>(tile_map->getRowCount())
+			                         * tile_map->getColumnCount());
+		}
+
+		//! \brief Returns the label of the component of the specified tile, or -1 if the tile
+		//! is impassable.  Two tiles are connected if and only if their labels are equal.
+		inline int getComponent(int tile) const
+		{
+			return (labels[tile] < 0) ? -1 : findRoot(labels[tile]);
+		}
+
+		//! \brief Returns the number of tiles in the component of the specified tile, or zero
+		//! if the tile is impassable.
+		inline std::size_t getComponentSize(int tile) const
+		{
+			return (labels[tile] < 0) ? 0 : static_cast<std::size_t>(sizes[findRoot(labels[tile])]);
+		}
+
+		//! \brief Returns <code>true</code> if a path joins the specified tiles, both of which
+		//! must be passable, <code>false</code> otherwise.
+		inline bool isConnected(int tile, int other_tile) const
+		{
+			return (labels[tile] >= 0) && (labels[other_tile] >= 0)
+			    && (findRoot(labels[tile]) == findRoot(labels[other_tile]));
+		}
+
+		//! \brief Returns <code>true</code> if the index is current and proves that no path
+		//! joins the specified tiles, <code>false</code> if a path may exist.
+		//!
+		//! This is the test the engines run in <code>enter()</code>, so it answers as their
+		//! searches would: a start equal to the goal is always reached, and since the weight
+		//! of the start is never charged, an impassable start reaches the goal if any of its
+		//! passable neighbours does.
+		DLLEXPORT bool isUnreachable(int start_tile, int goal_tile) const;
+
+		//! \brief Returns the number of components, not counting impassable tiles.
+		inline std::size_t getComponentCount() const
+		{
+			return component_count;
+		}
+
+		//! \brief Returns the number of times the index has been built, whether by
+		//! <code>build()</code> or by an edit that may have split a component.
+		inline unsigned int getRebuildCount() const
+		{
+			return rebuild_count;
+		}
+
+		//! \brief Returns the number of bytes held by the labels and the union-find nodes.
+		inline std::size_t getMemoryUsage() const
+		{
+			return (labels.capacity() + parents.capacity() + sizes.capacity()) * sizeof(int);
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
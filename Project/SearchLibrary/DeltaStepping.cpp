@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "DeltaStepping.h"
+#include "GridTopology.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	unsigned int const DeltaStepping::UNREACHABLE;
+	unsigned int const DeltaStepping::DEFAULT_BUCKET_WIDTH;
+
+	namespace {
+
+		size_t const NO_BUCKET = ~static_cast<size_t>(0);
+
+		// The largest weight a tile can have, and so the largest cost of a single step.
+		unsigned int const MAX_STEP_COST = 255;
+
+		class Barrier
+		{
+			mutex barrier_mutex;
+			condition_variable released;
+			size_t thread_count;
+			size_t waiting_count;
+			unsigned long long generation;
+
+		public:
+			explicit Barrier(size_t count)
+				: barrier_mutex(), released(), thread_count(count), waiting_count(0), generation(0)
+			{
+			}
+
+			void wait()
+			{
+				unique_lock<mutex> lock(barrier_mutex);
+				unsigned long long const arrival = generation;
+
+				if (++waiting_count == thread_count)
+				{
+					waiting_count = 0;
+					++generation;
+					released.notify_all();
+					return;
+				}
+
+				while (arrival == generation)
+				{
+					released.wait(lock);
+				}
+			}
+		};
+
+		struct Relaxation
+		{
+			int tile;
+			unsigned int distance;
+		};
+
+		// What one thread owns: a band of rows and the buckets of the tiles in it.
+		struct Band
+		{
+			int first_row;
+			int end_row;
+			vector<vector<Relaxation> > buckets;
+			vector<Relaxation> current;
+			vector<Relaxation> settled;
+			size_t first_bucket;
+			bool has_work;
+		};
+
+		class Solver
+		{
+			TileMapView view;
+			TileTopology topology;
+			unsigned int* distances;
+			DeltaStepping::Direction direction;
+			unsigned int bucket_width;
+			size_t thread_count;
+			int row_count;
+			int column_count;
+			vector<Band> bands;
+
+			// outboxes[from * thread_count + to] holds the relaxations queued by one thread
+			// for another until the next exchange.
+			vector<vector<Relaxation> > outboxes;
+			Barrier barrier;
+
+			size_t getOwner(int tile) const
+			{
+				return static_cast<size_t>(static_cast<unsigned long long>(tile / column_count)
+				                           * thread_count / row_count);
+			}
+
+			void relax(size_t thread, int tile, unsigned int distance)
+			{
+				size_t const owner = getOwner(tile);
+
+				if (owner != thread)
+				{
+					Relaxation const relaxation = { tile, distance };
+
+					outboxes[thread * thread_count + owner].push_back(relaxation);
+				}
+				else if (distance < distances[tile])
+				{
+					Band& band = bands[thread];
+					Relaxation const relaxation = { tile, distance };
+
+					distances[tile] = distance;
+					band.buckets[distance / bucket_width % band.buckets.size()].push_back(relaxation);
+				}
+			}
+
+			template <typename Topology>
+			void expand(size_t thread, Relaxation const& from, bool is_light, Topology)
+			{
+				int const row = from.tile / column_count;
+				int const column = from.tile % column_count;
+				unsigned int const weight = view.getTile(from.tile)->getWeight();
+
+				for (int direction_index = 0; direction_index < Topology::DIRECTION_COUNT;
+				     ++direction_index)
+				{
+					Tile const* const neighbor = getGridNeighbor<Topology>(view, row, column,
+					                                                       direction_index);
+
+					if (!neighbor || !neighbor->getWeight())
+					{
+						continue;
+					}
+
+					// Moving onto a tile costs its weight, whichever way the path is walked.
+					unsigned int const cost = (direction == DeltaStepping::FROM_SOURCE)
+					                        ? neighbor->getWeight() : weight;
+
+					if ((cost <= bucket_width) == is_light)
+					{
+						relax(thread, neighbor->getRow() * column_count + neighbor->getColumn(),
+						      from.distance + cost);
+					}
+				}
+			}
+
+			void receive(size_t thread)
+			{
+				for (size_t from = 0; from < thread_count; ++from)
+				{
+					vector<Relaxation>& inbox = outboxes[from * thread_count + thread];
+
+					for (size_t i = 0; i < inbox.size(); ++i)
+					{
+						relax(thread, inbox[i].tile, inbox[i].distance);
+					}
+
+					inbox.clear();
+				}
+			}
+
+			void findFirstBucket(Band& band, size_t bucket)
+			{
+				band.first_bucket = NO_BUCKET;
+
+				for (size_t i = 0; i < band.buckets.size(); ++i)
+				{
+					if (!band.buckets[(bucket + i) % band.buckets.size()].empty())
+					{
+						band.first_bucket = bucket + i;
+						break;
+					}
+				}
+			}
+
+			size_t getFirstBucket() const
+			{
+				size_t first_bucket = NO_BUCKET;
+
+				for (size_t i = 0; i < thread_count; ++i)
+				{
+					if (bands[i].first_bucket < first_bucket)
+					{
+						first_bucket = bands[i].first_bucket;
+					}
+				}
+
+				return first_bucket;
+			}
+
+			bool hasWork() const
+			{
+				for (size_t i = 0; i < thread_count; ++i)
+				{
+					if (bands[i].has_work)
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+		public:
+			size_t bucket_count;
+			size_t step_count;
+
+			Solver(TileMap const& map, unsigned int* distance_array,
+			       DeltaStepping::Direction path_direction, unsigned int width, size_t count)
+				: view(map.getView()), topology(map.getTopology()), distances(distance_array)
+				, direction(path_direction), bucket_width(width), thread_count(count), row_count(map.getRowCount())
+				, column_count(map.getColumnCount()), bands(count), outboxes(count * count)
+				, barrier(count), bucket_count(0), step_count(0)
+			{
+				for (size_t i = 0; i < thread_count; ++i)
+				{
+					// Rounded up to match getOwner().
+					bands[i].first_row = static_cast<int>((i * row_count + thread_count - 1)
+					                                      / thread_count);
+					bands[i].end_row = static_cast<int>(((i + 1) * row_count + thread_count - 1)
+					                                    / thread_count);
+
+					// Live entries never span more than one step's worth of buckets.
+					bands[i].buckets.resize(MAX_STEP_COST / bucket_width + 2);
+				}
+			}
+
+			void work(size_t thread, int source_row, int source_column)
+			{
+				TraceScope scope("deltaStepping", static_cast<long long>(thread));
+
+				switch (topology)
+				{
+				case HEX_EVEN_ROWS:
+					run(thread, source_row, source_column, HexEvenRowTopology());
+					break;
+				case SQUARE_FOUR:
+					run(thread, source_row, source_column, SquareFourTopology());
+					break;
+				case SQUARE_EIGHT:
+					run(thread, source_row, source_column, SquareEightTopology());
+					break;
+				default:
+					run(thread, source_row, source_column, HexOddRowTopology());
+				}
+			}
+
+			template <typename Topology>
+			void run(size_t thread, int source_row, int source_column, Topology)
+			{
+				Band& band = bands[thread];
+				unsigned int* const begin = distances + band.first_row * column_count;
+				unsigned int* const end = distances + band.end_row * column_count;
+
+				fill(begin, end, DeltaStepping::UNREACHABLE);
+
+				int const source = source_row * column_count + source_column;
+
+				if ((getOwner(source) == thread)
+				 && view.getTile(source)->getWeight())
+				{
+					relax(thread, source, 0);
+				}
+
+				findFirstBucket(band, 0);
+				barrier.wait();
+
+				for (size_t bucket = getFirstBucket(); bucket != NO_BUCKET; bucket = getFirstBucket())
+				{
+					vector<Relaxation>& slot = band.buckets[bucket % band.buckets.size()];
+
+					// Light edges, until the bucket stays empty on every thread.
+					do
+					{
+						band.current.swap(slot);
+
+						for (size_t i = 0; i < band.current.size(); ++i)
+						{
+							Relaxation const& relaxation = band.current[i];
+
+							// Skip entries superseded by a cheaper relaxation of the same tile.
+							if (relaxation.distance == distances[relaxation.tile])
+							{
+								band.settled.push_back(relaxation);
+								expand(thread, relaxation, true, Topology());
+							}
+						}
+
+						band.current.clear();
+						barrier.wait();
+						receive(thread);
+						band.has_work = !slot.empty();
+						barrier.wait();
+
+						if (!thread)
+						{
+							++step_count;
+						}
+					}
+					while (hasWork());
+
+					// Heavy edges, once per tile at its final distance.
+					for (size_t i = 0; i < band.settled.size(); ++i)
+					{
+						if (band.settled[i].distance == distances[band.settled[i].tile])
+						{
+							expand(thread, band.settled[i], false, Topology());
+						}
+					}
+
+					band.settled.clear();
+					barrier.wait();
+					receive(thread);
+					findFirstBucket(band, bucket + 1);
+					barrier.wait();
+
+					if (!thread)
+					{
+						++step_count;
+						++bucket_count;
+					}
+				}
+			}
+		};
+	}
+
+	DeltaStepping::DeltaStepping(size_t count, unsigned int width)
+		: thread_count(count), bucket_width(width ? width : 1), bucket_count(0), step_count(0)
+	{
+		if (!thread_count)
+		{
+			thread_count = thread::hardware_concurrency() ? thread::hardware_concurrency() : 1;
+		}
+	}
+
+	void DeltaStepping::compute(TileMap const& tile_map, int source_row, int source_column,
+	                            unsigned int* distances, Direction direction)
+	{
+		TraceScope scope("compute");
+
+		size_t const row_count = static_cast<size_t>(tile_map.getRowCount());
+		size_t const count = (thread_count < row_count) ? thread_count : row_count;
+
+		if (!count)
+		{
+			bucket_count = step_count = 0;
+			return;
+		}
+
+		Solver solver(tile_map, distances, direction, bucket_width, count);
+		vector<thread> threads;
+
+		for (size_t i = 1; i < count; ++i)
+		{
+			threads.push_back(thread(&Solver::work, &solver, i, source_row, source_column));
+		}
+
+		solver.work(0, source_row, source_column);
+
+		for (size_t i = 0; i < threads.size(); ++i)
+		{
+			threads[i].join();
+		}
+
+		bucket_count = solver.bucket_count;
+		step_count = solver.step_count;
+	}
+}}  // namespace fullsail_ai::algorithms
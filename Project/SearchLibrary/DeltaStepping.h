@@ -0,0 +1,95 @@
+//! \file DeltaStepping.h
+//! \brief Defines the <code>fullsail_ai::algorithms::DeltaStepping</code> class.
+#pragma once
+
+#include <cstddef>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Parallel single-source shortest paths over a whole tile map.
+	//!
+	//! Delta-stepping sorts tiles into buckets <code>getBucketWidth()</code> cost units wide and
+	//! settles one bucket at a time, relaxing every tile in the bucket at once: first the light
+	//! edges, which may land back in the same bucket, until the bucket stays empty, then the
+	//! heavy ones, which cannot.  A width of 1 visits tiles in Dijkstra's order; wider buckets
+	//! give the threads more work per step at the price of tiles settled more than once.
+	//!
+	//! Each thread owns a band of rows and is the only one to write the distances of its tiles.
+	//! Relaxations of tiles in another band are queued for their owner and handed over between
+	//! steps, so the distance array needs neither locks nor atomic operations.
+	class DeltaStepping
+	{
+	public:
+		//! \brief The distance stored for tiles that cannot be reached.
+		static unsigned int const UNREACHABLE = ~0u;
+
+		//! \brief The bucket width used unless another is specified.
+		static unsigned int const DEFAULT_BUCKET_WIDTH = 16;
+
+		//! \brief Which way along each path the distances are measured.
+		enum Direction
+		{
+			//! The cost of the cheapest path from the source to each tile, as returned by the
+			//! search engines.
+			FROM_SOURCE,
+
+			//! The cost of the cheapest path from each tile to the source, as stored by
+			//! <code>FlowField</code>.
+			TO_SOURCE
+		};
+
+	private:
+		std::size_t thread_count;
+		unsigned int bucket_width;
+		std::size_t bucket_count;
+		std::size_t step_count;
+
+	public:
+		//! \brief Constructs a solver that uses the specified number of threads, or one per
+		//! hardware thread if zero.
+		DLLEXPORT explicit DeltaStepping(std::size_t thread_count = 0,
+		                                 unsigned int bucket_width = DEFAULT_BUCKET_WIDTH);
+
+		//! \brief Writes the distance between the specified source and every tile of the map
+		//! to <code>distances</code>, which is indexed by <code>row * column count + column</code>.
+		//!
+		//! Impassable tiles, tiles that cannot be reached and every tile when the source itself
+		//! is impassable get <code>UNREACHABLE</code>.  The calling thread is one of the
+		//! workers.
+		//!
+		//! \pre
+		//!   - The source coordinates must be in bounds.
+		//!   - <code>distances</code> must hold one element per tile of the map.
+		DLLEXPORT void compute(TileMap const& tile_map, int source_row, int source_column,
+		                       unsigned int* distances, Direction direction = FROM_SOURCE);
+
+		//! \brief Returns the number of threads <code>compute()</code> runs on, at most one per
+		//! row of the map.
+		inline std::size_t getThreadCount() const
+		{
+			return thread_count;
+		}
+
+		//! \brief Returns the width of each bucket, in cost units.
+		inline unsigned int getBucketWidth() const
+		{
+			return bucket_width;
+		}
+
+		//! \brief Returns the number of buckets the last call to <code>compute()</code> settled.
+		inline std::size_t getBucketCount() const
+		{
+			return bucket_count;
+		}
+
+		//! \brief Returns the number of times the threads of the last call to
+		//! <code>compute()</code> exchanged relaxations.
+		inline std::size_t getStepCount() const
+		{
+			return step_count;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <functional>
+
+#include "FlowField.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	typedef pair<unsigned int, int> FrontierEntry;
+
+	static inline void pushFrontier(vector<FrontierEntry>& frontier, unsigned int cost, int index)
+	{
+		frontier.push_back(FrontierEntry(cost, index));
+		push_heap(frontier.begin(), frontier.end(), greater<FrontierEntry>());
+	}
+
+	unsigned int const FlowField::UNREACHABLE;
+
+	FlowField::FlowField()
+		: tile_map(0), goal_row(0), goal_column(0), map_version(0), costs(), directions()
+	{
+	}
+
+	void FlowField::build(TileMap const& map, int row, int column)
+	{
+		int const column_count = map.getColumnCount();
+		int const goal_index = row * column_count + column;
+		vector<FrontierEntry> frontier;
+
+		tile_map = &map;
+		goal_row = row;
+		goal_column = column;
+		map_version = map.getVersion();
+		costs.assign(map.getRowCount() * column_count, UNREACHABLE);
+		directions.assign(costs.size(), -1);
+
+		if (map.getTile(row, column)->getWeight())
+		{
+			costs[goal_index] = 0;
+			pushFrontier(frontier, 0, goal_index);
+		}
+
+		switch (map.getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			propagate(frontier, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			propagate(frontier, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			propagate(frontier, SquareEightTopology());
+			break;
+		default:
+			propagate(frontier, HexOddRowTopology());
+		}
+	}
+
+	template <typename Topology>
+	void FlowField::propagate(vector<FrontierEntry>& frontier, Topology)
+	{
+		TileMapView const view = tile_map->getView();
+		int const column_count = view.getColumnCount();
+
+		while (!frontier.empty())
+		{
+			pop_heap(frontier.begin(), frontier.end(), greater<FrontierEntry>());
+
+			FrontierEntry const entry = frontier.back();
+
+			frontier.pop_back();
+
+			// Skip entries superseded by a cheaper push of the same tile.
+			if (entry.first != costs[entry.second])
+			{
+				continue;
+			}
+
+			int const row = entry.second / column_count;
+			int const column = entry.second % column_count;
+
+			// Every neighbour reaches the goal through this tile by paying to enter it.
+			unsigned int const cost = entry.first + view.getTile(entry.second)->getWeight();
+
+			for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+			{
+				Tile const* neighbor = getGridNeighbor<Topology>(view, row, column, direction);
+
+				if (!neighbor || !neighbor->getWeight())
+				{
+					continue;
+				}
+
+				int const index = neighbor->getRow() * column_count + neighbor->getColumn();
+
+				if (cost < costs[index])
+				{
+					costs[index] = cost;
+					directions[index] = static_cast<signed char>(getOppositeDirection<Topology>(direction));
+					pushFrontier(frontier, cost, index);
+				}
+			}
+		}
+	}
+
+	void FlowField::repair(int row, int column, unsigned char old_weight)
+	{
+		if (!tile_map || isCurrent())
+		{
+			return;
+		}
+
+		// Changes to the goal shift every cost, and a gap in the version history means edits
+		// we were not told about, so start over in both cases.
+		if ((map_version + 1 != tile_map->getVersion())
+		 || ((row == goal_row) && (column == goal_column)))
+		{
+			build(*tile_map, goal_row, goal_column);
+			return;
+		}
+
+		map_version = tile_map->getVersion();
+
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			repair(row, column, old_weight, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			repair(row, column, old_weight, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			repair(row, column, old_weight, SquareEightTopology());
+			break;
+		default:
+			repair(row, column, old_weight, HexOddRowTopology());
+		}
+	}
+
+	template <typename Topology>
+	void FlowField::repair(int row, int column, unsigned char old_weight, Topology)
+	{
+		TileMapView const view = tile_map->getView();
+		int const column_count = view.getColumnCount();
+		int const changed_index = row * column_count + column;
+		unsigned char const new_weight = view.getTile(changed_index)->getWeight();
+		vector<FrontierEntry> frontier;
+
+		if (!new_weight || (old_weight && (old_weight < new_weight)))
+		{
+			// Every tile whose best path runs through the changed tile may now be too cheap.
+			vector<int> stale;
+			size_t next = 0;
+			int parent = changed_index;
+
+			if (!new_weight)
+			{
+				stale.push_back(changed_index);
+				next = 1;
+			}
+
+			for (;;)
+			{
+				int const parent_row = parent / column_count;
+				int const parent_column = parent % column_count;
+
+				for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+				{
+					Tile const* child = getGridNeighbor<Topology>(view, parent_row, parent_column,
+					                                              direction);
+
+					if (child && (directions[child->getRow() * column_count + child->getColumn()]
+					          == getOppositeDirection<Topology>(direction)))
+					{
+						stale.push_back(child->getRow() * column_count + child->getColumn());
+					}
+				}
+
+				if (next == stale.size())
+				{
+					break;
+				}
+
+				parent = stale[next++];
+			}
+
+			for (size_t i = 0; i < stale.size(); ++i)
+			{
+				costs[stale[i]] = UNREACHABLE;
+				directions[stale[i]] = -1;
+			}
+
+			// Reseed the stale region from its up-to-date border.
+			for (size_t i = 0; i < stale.size(); ++i)
+			{
+				int const stale_row = stale[i] / column_count;
+				int const stale_column = stale[i] % column_count;
+
+				if (!view.getTile(stale[i])->getWeight())
+				{
+					continue;
+				}
+
+				for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+				{
+					Tile const* neighbor = getGridNeighbor<Topology>(view, stale_row, stale_column,
+					                                                 direction);
+
+					if (!neighbor || !neighbor->getWeight())
+					{
+						continue;
+					}
+
+					unsigned int const cost
+						= costs[neighbor->getRow() * column_count + neighbor->getColumn()];
+
+					if ((cost != UNREACHABLE) && (cost + neighbor->getWeight() < costs[stale[i]]))
+					{
+						costs[stale[i]] = cost + neighbor->getWeight();
+						directions[stale[i]] = static_cast<signed char>(direction);
+					}
+				}
+
+				if (costs[stale[i]] != UNREACHABLE)
+				{
+					pushFrontier(frontier, costs[stale[i]], stale[i]);
+				}
+			}
+		}
+		else
+		{
+			// The tile got cheaper or became passable, so its neighbours may improve.
+			if (!old_weight)
+			{
+				for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+				{
+					Tile const* neighbor = getGridNeighbor<Topology>(view, row, column, direction);
+
+					if (!neighbor || !neighbor->getWeight())
+					{
+						continue;
+					}
+
+					unsigned int const cost
+						= costs[neighbor->getRow() * column_count + neighbor->getColumn()];
+
+					if ((cost != UNREACHABLE) && (cost + neighbor->getWeight() < costs[changed_index]))
+					{
+						costs[changed_index] = cost + neighbor->getWeight();
+						directions[changed_index] = static_cast<signed char>(direction);
+					}
+				}
+			}
+
+			if (costs[changed_index] != UNREACHABLE)
+			{
+				pushFrontier(frontier, costs[changed_index], changed_index);
+			}
+		}
+
+		propagate(frontier, Topology());
+	}
+
+	void FlowField::clear()
+	{
+		tile_map = 0;
+		vector<unsigned int>().swap(costs);
+		vector<signed char>().swap(directions);
+	}
+
+	FlowFieldCache::FlowFieldCache(TileMap const& map, size_t budget)
+		: tile_map(&map), byte_budget(budget), bytes_used(0), fields(), lookup()
+		, hit_count(0), miss_count(0), eviction_count(0)
+	{
+	}
+
+	FlowField const& FlowFieldCache::acquire(int goal_row, int goal_column)
+	{
+		int const key = goal_row * tile_map->getColumnCount() + goal_column;
+		unordered_map<int, FieldList::iterator>::iterator itr = lookup.find(key);
+
+		if (itr == lookup.end())
+		{
+			fields.push_front(KeyedField(key, FlowField()));
+			lookup[key] = fields.begin();
+		}
+		else
+		{
+			fields.splice(fields.begin(), fields, itr->second);
+
+			FlowField const& field = fields.front().second;
+
+			if (field.isCurrent()
+			 && (field.getGoalRow() == goal_row) && (field.getGoalColumn() == goal_column))
+			{
+				++hit_count;
+				return field;
+			}
+
+			bytes_used -= field.getMemoryUsage();
+		}
+
+		FlowField& field = fields.front().second;
+
+		++miss_count;
+		field.build(*tile_map, goal_row, goal_column);
+		bytes_used += field.getMemoryUsage();
+		evict();
+		return field;
+	}
+
+	void FlowFieldCache::evict()
+	{
+		while ((byte_budget < bytes_used) && (1 < fields.size()))
+		{
+			bytes_used -= fields.back().second.getMemoryUsage();
+			lookup.erase(fields.back().first);
+			fields.pop_back();
+			++eviction_count;
+		}
+	}
+
+	void FlowFieldCache::onTileWeightChanged(int row, int column, unsigned char old_weight)
+	{
+		for (FieldList::iterator itr = fields.begin(); itr != fields.end(); ++itr)
+		{
+			bytes_used -= itr->second.getMemoryUsage();
+			itr->second.repair(row, column, old_weight);
+			bytes_used += itr->second.getMemoryUsage();
+		}
+	}
+
+	void FlowFieldCache::clear()
+	{
+		lookup.clear();
+		fields.clear();
+		bytes_used = 0;
+	}
+}}  // namespace fullsail_ai::algorithms
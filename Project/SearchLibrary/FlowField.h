@@ -0,0 +1,193 @@
+//! \file FlowField.h
+//! \brief Defines the <code>fullsail_ai::algorithms::FlowField</code> and
+//! <code>fullsail_ai::algorithms::FlowFieldCache</code> classes.
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <vector>
+#include <unordered_map>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "GridTopology.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Cost-to-goal field over an entire tile map.
+	//!
+	//! A single reverse Dijkstra search from the goal stores, for every tile, the cost of the
+	//! cheapest path to the goal and the direction of the first step along that path.  Any
+	//! number of agents heading to the same goal can then read their next step in constant
+	//! time.  Entering a tile costs its weight, so the cost of a path is the sum of the weights
+	//! of every tile on it except the first.
+	class FlowField
+	{
+	public:
+		//! \brief The cost stored for tiles that cannot reach the goal.
+		static unsigned int const UNREACHABLE = ~0u;
+
+	private:
+		TileMap const* tile_map;
+		int goal_row;
+		int goal_column;
+		unsigned int map_version;
+		std::vector<unsigned int> costs;
+		std::vector<signed char> directions;
+
+		template <typename Topology>
+		void propagate(std::vector<std::pair<unsigned int, int> >& frontier, Topology);
+		template <typename Topology>
+		void repair(int row, int column, unsigned char old_weight, Topology);
+
+	public:
+		//! \brief Constructs an empty field.
+		DLLEXPORT FlowField();
+
+		//! \brief Computes the cost-to-goal and best direction of every tile in the map.
+		//!
+		//! \pre
+		//!   - The goal coordinates must be in bounds.
+		DLLEXPORT void build(TileMap const& tile_map, int goal_row, int goal_column);
+
+		//! \brief Updates the field after <code>TileMap::setTileWeight()</code> has changed
+		//! the weight of a single tile.
+		//!
+		//! Only the tiles whose costs can be affected by the change are recomputed.  If more
+		//! than one edit has been made to the map since the field was last brought up to
+		//! date, the whole field is rebuilt instead.
+		//!
+		//! \param   row         the row-coordinate of the changed tile.
+		//! \param   column      the column-coordinate of the changed tile.
+		//! \param   old_weight  the weight the tile had before the change.
+		DLLEXPORT void repair(int row, int column, unsigned char old_weight);
+
+		//! \brief Releases the field's storage.
+		DLLEXPORT void clear();
+
+		//! \brief Returns <code>true</code> if the field was built against the current
+		//! weights of its tile map, <code>false</code> otherwise.
+		inline bool isCurrent() const
+		{
+			return tile_map && (map_version == tile_map->getVersion());
+		}
+
+		//! \brief Returns the row-coordinate of the goal.
+		inline int getGoalRow() const
+		{
+			return goal_row;
+		}
+
+		//! \brief Returns the column-coordinate of the goal.
+		inline int getGoalColumn() const
+		{
+			return goal_column;
+		}
+
+		//! \brief Returns the cost of the cheapest path from the specified location to the
+		//! goal, or <code>UNREACHABLE</code>.
+		inline unsigned int getCost(int row, int column) const
+		{
+			return costs[row * tile_map->getColumnCount() + column];
+		}
+
+		//! \brief Returns the direction (see <code>getGridOffsets()</code>) of the next step
+		//! towards the goal, or -1 at the goal and at tiles that cannot reach it.
+		inline int getDirection(int row, int column) const
+		{
+			return directions[row * tile_map->getColumnCount() + column];
+		}
+
+		//! \brief Returns the next tile on the cheapest path from the specified tile to the
+		//! goal, or <code>NULL</code> at the goal and at tiles that cannot reach it.
+		inline Tile* getNextTile(Tile const* tile) const
+		{
+			int const row = tile->getRow();
+			int const column = tile->getColumn();
+			int const direction = getDirection(row, column);
+
+			return (direction < 0) ? 0 : getGridNeighbor(*tile_map, row, column, direction);
+		}
+
+		//! \brief Returns the number of bytes held by the field's per-tile tables.
+		inline std::size_t getMemoryUsage() const
+		{
+			return costs.capacity() * sizeof(unsigned int)
+			     + directions.capacity() * sizeof(signed char);
+		}
+	};
+
+	//! \brief Least-recently-used cache of flow fields keyed by goal.
+	//!
+	//! Fields are evicted, oldest first, whenever their combined memory usage exceeds the byte
+	//! budget.  The most recently acquired field is never evicted, so a budget smaller than a
+	//! single field still works.
+	class FlowFieldCache
+	{
+		// Each field is stored with its lookup key so that eviction does not depend on the
+		// current dimensions of the tile map.
+		typedef std::pair<int, FlowField> KeyedField;
+		typedef std::list<KeyedField> FieldList;
+
+		TileMap const* tile_map;
+		std::size_t byte_budget;
+		std::size_t bytes_used;
+		FieldList fields;
+		std::unordered_map<int, FieldList::iterator> lookup;
+		unsigned int hit_count;
+		unsigned int miss_count;
+		unsigned int eviction_count;
+
+		void evict();
+
+	public:
+		//! \brief Constructs a cache that keeps at most <code>byte_budget</code> bytes of
+		//! fields computed over the specified tile map.
+		DLLEXPORT FlowFieldCache(TileMap const& tile_map, std::size_t byte_budget);
+
+		//! \brief Returns the field for the specified goal, building it if it is not cached
+		//! or if the map has changed in a way the cache was not told about.
+		//!
+		//! The returned reference remains valid until the next call to
+		//! <code>acquire()</code> or <code>clear()</code>.
+		DLLEXPORT FlowField const& acquire(int goal_row, int goal_column);
+
+		//! \brief Repairs every cached field after <code>TileMap::setTileWeight()</code> has
+		//! changed the weight of a single tile.
+		DLLEXPORT void onTileWeightChanged(int row, int column, unsigned char old_weight);
+
+		//! \brief Discards every cached field.  Call this after reloading the tile map.
+		DLLEXPORT void clear();
+
+		//! \brief Returns the number of fields currently cached.
+		inline std::size_t getFieldCount() const
+		{
+			return fields.size();
+		}
+
+		//! \brief Returns the number of bytes held by the cached fields.
+		inline std::size_t getMemoryUsage() const
+		{
+			return bytes_used;
+		}
+
+		//! \brief Returns the number of calls to <code>acquire()</code> that found a current
+		//! field in the cache.
+		inline unsigned int getHitCount() const
+		{
+			return hit_count;
+		}
+
+		//! \brief Returns the number of calls to <code>acquire()</code> that built a field.
+		inline unsigned int getMissCount() const
+		{
+			return miss_count;
+		}
+
+		//! \brief Returns the number of fields discarded to stay within the byte budget.
+		inline unsigned int getEvictionCount() const
+		{
+			return eviction_count;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
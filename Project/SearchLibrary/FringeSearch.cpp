@@ -0,0 +1,362 @@
+#include <chrono>
+
+#include "FringeSearch.h"
+#include "ComponentIndex.h"
+#include "GridTopology.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	static size_t const INITIAL_SLOT_COUNT = 1024;
+	static unsigned int const NO_THRESHOLD = ~0u;
+
+	static inline size_t hashTile(int tile)
+	{
+		unsigned int key = static_cast<unsigned int>(tile);
+
+		key ^= key >> 16;
+		key *= 0x45d9f3bu;
+		return key ^ (key >> 16);
+	}
+
+	FringeSearch::FringeSearch()
+		: tile_map(0), entries(), slots(), fringe_head(-1), cursor(-1), threshold(0)
+		, next_threshold(NO_THRESHOLD), goal_index(-1), goal_row(0), goal_column(0), is_done(false)
+		, solution(), component_index(0), peak_memory(0), expansion_count(0)
+	{
+	}
+
+	FringeSearch::~FringeSearch()
+	{
+		shutdown();
+	}
+
+	void FringeSearch::initialize(TileMap* map)
+	{
+		tile_map = map;
+	}
+
+	int FringeSearch::find(int tile) const
+	{
+		size_t const mask = slots.size() - 1;
+
+		for (size_t slot = hashTile(tile) & mask; slots[slot] != -1; slot = (slot + 1) & mask)
+		{
+			if (entries[slots[slot]].tile == tile)
+			{
+				return slots[slot];
+			}
+		}
+
+		return -1;
+	}
+
+	int FringeSearch::insert(int tile)
+	{
+		// Keep the open-addressed index at most half full.
+		if (slots.size() < (entries.size() + 1) * 2)
+		{
+			slots.assign(slots.size() * 2, -1);
+
+			size_t const mask = slots.size() - 1;
+
+			for (size_t i = 0; i < entries.size(); ++i)
+			{
+				size_t slot = hashTile(entries[i].tile) & mask;
+
+				while (slots[slot] != -1)
+				{
+					slot = (slot + 1) & mask;
+				}
+
+				slots[slot] = static_cast<int>(i);
+			}
+		}
+
+		size_t const mask = slots.size() - 1;
+		size_t slot = hashTile(tile) & mask;
+
+		while (slots[slot] != -1)
+		{
+			slot = (slot + 1) & mask;
+		}
+
+		CacheEntry entry;
+
+		entry.tile = tile;
+		entry.parent = -1;
+		entry.given_cost = 0;
+		entry.previous = entry.next = -1;
+		entry.is_in_fringe = false;
+		slots[slot] = static_cast<int>(entries.size());
+		entries.push_back(entry);
+		return slots[slot];
+	}
+
+	void FringeSearch::unlink(int entry)
+	{
+		CacheEntry& node = entries[entry];
+
+		if (node.previous == -1)
+		{
+			fringe_head = node.next;
+		}
+		else
+		{
+			entries[node.previous].next = node.next;
+		}
+
+		if (node.next != -1)
+		{
+			entries[node.next].previous = node.previous;
+		}
+
+		node.previous = node.next = -1;
+		node.is_in_fringe = false;
+	}
+
+	void FringeSearch::linkAfter(int entry, int previous)
+	{
+		CacheEntry& node = entries[entry];
+
+		node.previous = previous;
+		node.next = entries[previous].next;
+		node.is_in_fringe = true;
+
+		if (node.next != -1)
+		{
+			entries[node.next].previous = entry;
+		}
+
+		entries[previous].next = entry;
+	}
+
+	template <typename Topology>
+	inline unsigned int FringeSearch::estimate(int tile, Topology) const
+	{
+		int const column_count = tile_map->getColumnCount();
+
+		return Topology::getDistance(tile / column_count, tile % column_count, goal_row,
+		                             goal_column);
+	}
+
+	void FringeSearch::enter(int start_row, int start_column, int goal_r, int goal_c)
+	{
+		TraceScope scope("enter");
+
+		int const start_index = start_row * tile_map->getColumnCount() + start_column;
+
+		entries.clear();
+		slots.assign(INITIAL_SLOT_COUNT, -1);
+		solution.clear();
+		goal_row = goal_r;
+		goal_column = goal_c;
+		goal_index = goal_row * tile_map->getColumnCount() + goal_column;
+		fringe_head = cursor = insert(start_index);
+		entries[fringe_head].is_in_fringe = true;
+		threshold = getGridDistance(tile_map->getTopology(), start_row, start_column, goal_row,
+		                            goal_column);
+		next_threshold = NO_THRESHOLD;
+		is_done = false;
+		peak_memory = getMemoryUsage();
+		expansion_count = 0;
+
+		if (component_index && component_index->isUnreachable(start_index, goal_index))
+		{
+			// The start is in place, so exit() cleans up after this search as after any other.
+			is_done = true;
+		}
+	}
+
+	template <typename Topology>
+	void FringeSearch::expand(int entry, Topology)
+	{
+		TileMapView const view = tile_map->getView();
+		int const column_count = view.getColumnCount();
+		int const tile = entries[entry].tile;
+		int const row = tile / column_count;
+		int const column = tile % column_count;
+
+		// Link the children in reverse so that they are visited in direction order.
+		for (int direction = Topology::DIRECTION_COUNT; direction--; )
+		{
+			Tile const* neighbor = getGridNeighbor<Topology>(view, row, column, direction);
+
+			if (!neighbor || !neighbor->getWeight())
+			{
+				continue;
+			}
+
+			int const neighbor_index = neighbor->getRow() * column_count + neighbor->getColumn();
+			unsigned int const given_cost = entries[entry].given_cost + neighbor->getWeight();
+			int child = find(neighbor_index);
+
+			if (child == -1)
+			{
+				child = insert(neighbor_index);
+			}
+			else if (entries[child].given_cost <= given_cost)
+			{
+				continue;
+			}
+			else if (entries[child].is_in_fringe)
+			{
+				unlink(child);
+			}
+
+			entries[child].given_cost = given_cost;
+			entries[child].parent = entry;
+			linkAfter(child, entry);
+		}
+
+		cursor = entries[entry].next;
+		unlink(entry);
+	}
+
+	void FringeSearch::update(long timeslice)
+	{
+		TraceScope scope("update", timeslice);
+
+		run(timeslice, 0);
+	}
+
+	void FringeSearch::updateExpansions(size_t expansion_budget)
+	{
+		TraceScope scope("updateExpansions", static_cast<long long>(expansion_budget));
+
+		if (expansion_budget)
+		{
+			run(0, expansion_budget);
+		}
+	}
+
+	void FringeSearch::run(long timeslice, size_t expansion_budget)
+	{
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			run(timeslice, expansion_budget, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			run(timeslice, expansion_budget, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			run(timeslice, expansion_budget, SquareEightTopology());
+			break;
+		default:
+			run(timeslice, expansion_budget, HexOddRowTopology());
+		}
+	}
+
+	template <typename Topology>
+	void FringeSearch::run(long timeslice, size_t expansion_budget, Topology)
+	{
+		// An expansion budget replaces the clock entirely.
+		chrono::steady_clock::time_point const deadline = expansion_budget
+			? chrono::steady_clock::time_point()
+			: chrono::steady_clock::now() + chrono::milliseconds(timeslice);
+
+		while (!is_done)
+		{
+			if (cursor == -1)
+			{
+				// The pass is over.  Start the next one with the smallest f-cost that was cut.
+				if ((fringe_head == -1) || (next_threshold == NO_THRESHOLD))
+				{
+					is_done = true;
+					break;
+				}
+
+				threshold = next_threshold;
+				next_threshold = NO_THRESHOLD;
+				cursor = fringe_head;
+				continue;
+			}
+
+			CacheEntry const& node = entries[cursor];
+			unsigned int const final_cost = node.given_cost + estimate(node.tile, Topology());
+
+			if (threshold < final_cost)
+			{
+				if (final_cost < next_threshold)
+				{
+					next_threshold = final_cost;
+				}
+
+				cursor = node.next;
+				continue;
+			}
+
+			if (node.tile == goal_index)
+			{
+				int const column_count = tile_map->getColumnCount();
+
+				for (int entry = cursor; entry != -1; entry = entries[entry].parent)
+				{
+					solution.push_back(tile_map->getTile(entries[entry].tile / column_count,
+					                                     entries[entry].tile % column_count));
+				}
+
+				is_done = true;
+				break;
+			}
+
+			expand(cursor, Topology());
+			++expansion_count;
+
+			size_t const memory = getMemoryUsage();
+
+			if (peak_memory < memory)
+			{
+				peak_memory = memory;
+			}
+
+			if (expansion_budget ? !--expansion_budget
+			                     : (!timeslice || (deadline <= chrono::steady_clock::now())))
+			{
+				break;
+			}
+		}
+	}
+
+	void FringeSearch::exit()
+	{
+		TraceScope scope("exit");
+
+		vector<CacheEntry>().swap(entries);
+		vector<int>().swap(slots);
+		fringe_head = cursor = -1;
+	}
+
+	void FringeSearch::shutdown()
+	{
+		exit();
+		solution.clear();
+		tile_map = 0;
+		is_done = false;
+	}
+
+	bool FringeSearch::isDone() const
+	{
+		return is_done;
+	}
+
+	vector<Tile const*> const FringeSearch::getSolution() const
+	{
+		TraceScope scope("getSolution");
+
+		return solution;
+	}
+
+	void FringeSearch::setComponentIndex(ComponentIndex const* index)
+	{
+		component_index = index;
+	}
+
+	size_t FringeSearch::getMemoryUsage() const
+	{
+		return entries.capacity() * sizeof(CacheEntry) + slots.capacity() * sizeof(int);
+	}
+}}  // namespace fullsail_ai::algorithms
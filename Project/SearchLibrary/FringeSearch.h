@@ -0,0 +1,133 @@
+//! \file FringeSearch.h
+//! \brief Defines the <code>fullsail_ai::algorithms::FringeSearch</code> class.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "PathView.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	class ComponentIndex;
+
+	//! \brief Time-sliced Fringe Search over a tile map of any <code>TileTopology</code>.
+	//!
+	//! Fringe Search visits nodes in the same order as IDA*, but keeps the frontier of each
+	//! iteration in a linked list so that nothing is searched twice, and needs no priority
+	//! queue.  Unlike <code>PathSearch</code>, it allocates nothing per tile of the map: the
+	//! fringe and the cache of visited nodes only grow with the part of the map the search
+	//! actually touches.  Costs and the heuristic are the same as for <code>PathSearch</code>,
+	//! so both return paths of the same cost.
+	class FringeSearch
+	{
+		struct CacheEntry
+		{
+			int tile;
+			int parent;
+			unsigned int given_cost;
+			int previous;
+			int next;
+			bool is_in_fringe;
+		};
+
+		TileMap* tile_map;
+		std::vector<CacheEntry> entries;
+		std::vector<int> slots;
+		int fringe_head;
+		int cursor;
+		unsigned int threshold;
+		unsigned int next_threshold;
+		int goal_index;
+		int goal_row;
+		int goal_column;
+		bool is_done;
+		std::vector<Tile const*> solution;
+		ComponentIndex const* component_index;
+		std::size_t peak_memory;
+		std::size_t expansion_count;
+
+		int find(int tile) const;
+		int insert(int tile);
+		void unlink(int entry);
+		void linkAfter(int entry, int previous);
+		template <typename Topology>
+		unsigned int estimate(int tile, Topology) const;
+		template <typename Topology>
+		void expand(int entry, Topology);
+		void run(long timeslice, std::size_t expansion_budget);
+		template <typename Topology>
+		void run(long timeslice, std::size_t expansion_budget, Topology);
+
+	public:
+		//! \brief Constructs a search that is not yet bound to a tile map.
+		DLLEXPORT FringeSearch();
+
+		//! \brief Releases all memory held by the search.
+		DLLEXPORT ~FringeSearch();
+
+		//! \brief Binds the search to the specified tile map.
+		DLLEXPORT void initialize(TileMap* tile_map);
+
+		//! \brief Begins a new search between the specified locations.
+		//!
+		//! If a current component index shows the goal to be unreachable, the search finishes
+		//! immediately.
+		DLLEXPORT void enter(int start_row, int start_column, int goal_row, int goal_column);
+
+		//! \brief Runs the search for roughly <code>timeslice</code> milliseconds, or for a
+		//! single expansion if <code>timeslice</code> is zero.
+		DLLEXPORT void update(long timeslice);
+
+		//! \brief Runs the search for at most <code>expansion_budget</code> expansions without
+		//! reading the clock, so the same inputs always make the same progress.
+		DLLEXPORT void updateExpansions(std::size_t expansion_budget);
+
+		//! \brief Releases the fringe and the cache of the current search.
+		//!
+		//! <code>isDone()</code> keeps reporting the outcome of the search that was exited.
+		DLLEXPORT void exit();
+
+		//! \brief Unbinds the search from its tile map.
+		DLLEXPORT void shutdown();
+
+		//! \brief Returns <code>true</code> if the current search has either found the goal or
+		//! proven it unreachable, <code>false</code> otherwise.
+		DLLEXPORT bool isDone() const;
+
+		//! \brief Returns the path found by the current search, goal first and start last, or
+		//! an empty vector if the goal is unreachable.
+		DLLEXPORT std::vector<Tile const*> const getSolution() const;
+
+		//! \brief Returns the same path as <code>getSolution()</code> without copying it.
+		//!
+		//! The view stays valid until the next call to <code>enter()</code> or
+		//! <code>shutdown()</code>.
+		inline PathView getSolutionView() const
+		{
+			return PathView(solution);
+		}
+
+		//! \brief Attaches an index that <code>enter()</code> consults to reject unreachable
+		//! goals without searching, or detaches the index if <code>NULL</code>.
+		DLLEXPORT void setComponentIndex(ComponentIndex const* component_index);
+
+		//! \brief Returns the number of bytes currently held by the fringe and the cache.
+		DLLEXPORT std::size_t getMemoryUsage() const;
+
+		//! \brief Returns the largest value <code>getMemoryUsage()</code> has reached since the
+		//! last call to <code>enter()</code>.
+		inline std::size_t getPeakMemoryUsage() const
+		{
+			return peak_memory;
+		}
+
+		//! \brief Returns the number of nodes expanded since the last call to <code>enter()</code>.
+		inline std::size_t getExpansionCount() const
+		{
+			return expansion_count;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,225 @@
+//! \file GridTopology.h
+//! \brief Compile-time adjacency policies for every <code>fullsail_ai::TileTopology</code>.
+#pragma once
+
+#include <cstdlib>
+#include "../TileLibrary/TileMap.h"
+#include "HexGrid.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief The largest number of tiles adjacent to an interior tile, over every topology.
+	static constexpr int MAX_DIRECTION_COUNT = 8;
+
+	//! \brief Row and column offsets of the six neighbours on a map whose even rows are drawn
+	//! half a tile to the right, indexed by row parity and direction.
+	static constexpr int HEX_EVEN_ROW_OFFSETS[2][HEX_DIRECTION_COUNT][2] =
+	{
+		{ { 0, 1 }, { -1, 1 }, { -1, 0 }, { 0, -1 }, { 1, 0 }, { 1, 1 } },
+		{ { 0, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }, { 1, 0 } }
+	};
+
+	//! \brief Row and column offsets of the four edge neighbours of a square, E, N, W, S.
+	//!
+	//! Square grids do not depend on row parity; both halves of the table are the same so that
+	//! every policy is indexed the same way.
+	static constexpr int SQUARE_FOUR_OFFSETS[2][4][2] =
+	{
+		{ { 0, 1 }, { -1, 0 }, { 0, -1 }, { 1, 0 } },
+		{ { 0, 1 }, { -1, 0 }, { 0, -1 }, { 1, 0 } }
+	};
+
+	//! \brief Row and column offsets of the eight neighbours of a square, E, NE, N, NW, W, SW,
+	//! S, SE.
+	static constexpr int SQUARE_EIGHT_OFFSETS[2][8][2] =
+	{
+		{ { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }, { 1, 0 }, { 1, 1 } },
+		{ { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }, { 1, 0 }, { 1, 1 } }
+	};
+
+	//! \brief Topology policy for <code>HEX_ODD_ROWS</code>, the layout of every map in Data.
+	//!
+	//! A search templated on a topology policy reads only these members:
+	//!   - <code>TOPOLOGY</code>, the enumerator the policy stands for.
+	//!   - <code>DIRECTION_COUNT</code>, the number of neighbours of an interior tile.
+	//!   - <code>getOffsets(row)</code>, the row and column offset of each neighbour of a tile
+	//!     in the specified row.  The table is picked by row parity alone, never by a branch.
+	//!   - <code>getDistance()</code>, the minimum number of steps between two locations, which
+	//!     is an admissible heuristic since every passable tile weighs at least one.
+	struct HexOddRowTopology
+	{
+		static constexpr TileTopology TOPOLOGY = HEX_ODD_ROWS;
+		static constexpr int DIRECTION_COUNT = HEX_DIRECTION_COUNT;
+
+		static inline int const (*getOffsets(int row))[2]
+		{
+			return HEX_DIRECTION_OFFSETS[row & 1];
+		}
+
+		static inline int getDistance(int from_row, int from_column, int to_row, int to_column)
+		{
+			return getHexDistance(from_row, from_column, to_row, to_column);
+		}
+	};
+
+	//! \brief Topology policy for <code>HEX_EVEN_ROWS</code>.
+	struct HexEvenRowTopology
+	{
+		static constexpr TileTopology TOPOLOGY = HEX_EVEN_ROWS;
+		static constexpr int DIRECTION_COUNT = HEX_DIRECTION_COUNT;
+
+		static inline int const (*getOffsets(int row))[2]
+		{
+			return HEX_EVEN_ROW_OFFSETS[row & 1];
+		}
+
+		static inline int getDistance(int from_row, int from_column, int to_row, int to_column)
+		{
+			// The cube x-coordinate of an even-row layout rounds the half rows up, not down.
+			int const from_x = from_column - ((from_row + (from_row & 1)) >> 1);
+			int const to_x = to_column - ((to_row + (to_row & 1)) >> 1);
+			int const dx = std::abs(to_x - from_x);
+			int const dz = std::abs(to_row - from_row);
+			int const dy = std::abs((to_x + to_row) - (from_x + from_row));
+
+			return (dx < dy) ? ((dy < dz) ? dz : dy) : ((dx < dz) ? dz : dx);
+		}
+	};
+
+	//! \brief Topology policy for <code>SQUARE_FOUR</code>.
+	struct SquareFourTopology
+	{
+		static constexpr TileTopology TOPOLOGY = SQUARE_FOUR;
+		static constexpr int DIRECTION_COUNT = 4;
+
+		static inline int const (*getOffsets(int row))[2]
+		{
+			return SQUARE_FOUR_OFFSETS[row & 1];
+		}
+
+		static inline int getDistance(int from_row, int from_column, int to_row, int to_column)
+		{
+			return std::abs(to_row - from_row) + std::abs(to_column - from_column);
+		}
+	};
+
+	//! \brief Topology policy for <code>SQUARE_EIGHT</code>.
+	//!
+	//! A diagonal step enters one tile, as any other step does, so it costs no more.
+	struct SquareEightTopology
+	{
+		static constexpr TileTopology TOPOLOGY = SQUARE_EIGHT;
+		static constexpr int DIRECTION_COUNT = 8;
+
+		static inline int const (*getOffsets(int row))[2]
+		{
+			return SQUARE_EIGHT_OFFSETS[row & 1];
+		}
+
+		static inline int getDistance(int from_row, int from_column, int to_row, int to_column)
+		{
+			int const row_distance = std::abs(to_row - from_row);
+			int const column_distance = std::abs(to_column - from_column);
+
+			return (row_distance < column_distance) ? column_distance : row_distance;
+		}
+	};
+
+	//! \brief Returns the tile adjacent to the specified location in the specified direction,
+	//! or <code>NULL</code> if that neighbour lies off the map.
+	template <typename Topology>
+	inline Tile* getGridNeighbor(TileMapView const& view, int row, int column, int direction)
+	{
+		int const* offset = Topology::getOffsets(row)[direction];
+
+		return view.getTile(row + offset[0], column + offset[1]);
+	}
+
+	//! \brief Returns the direction pointing back the way the specified direction went.
+	template <typename Topology>
+	inline int getOppositeDirection(int direction)
+	{
+		return (direction + Topology::DIRECTION_COUNT / 2) % Topology::DIRECTION_COUNT;
+	}
+
+	//! \brief Returns <code>Topology::DIRECTION_COUNT</code> for the specified topology.
+	//!
+	//! The functions below pick the policy at run time, for code outside the inner loop of a
+	//! search; inner loops should be templated on the policy instead.
+	inline int getDirectionCount(TileTopology topology)
+	{
+		switch (topology)
+		{
+		case HEX_EVEN_ROWS:
+			return HexEvenRowTopology::DIRECTION_COUNT;
+		case SQUARE_FOUR:
+			return SquareFourTopology::DIRECTION_COUNT;
+		case SQUARE_EIGHT:
+			return SquareEightTopology::DIRECTION_COUNT;
+		default:
+			return HexOddRowTopology::DIRECTION_COUNT;
+		}
+	}
+
+	//! \brief Returns <code>Topology::getOffsets(row)</code> for the specified topology.
+	inline int const (*getGridOffsets(TileTopology topology, int row))[2]
+	{
+		switch (topology)
+		{
+		case HEX_EVEN_ROWS:
+			return HexEvenRowTopology::getOffsets(row);
+		case SQUARE_FOUR:
+			return SquareFourTopology::getOffsets(row);
+		case SQUARE_EIGHT:
+			return SquareEightTopology::getOffsets(row);
+		default:
+			return HexOddRowTopology::getOffsets(row);
+		}
+	}
+
+	//! \brief Returns <code>Topology::getDistance()</code> for the specified topology.
+	inline int getGridDistance(TileTopology topology, int from_row, int from_column, int to_row,
+	                           int to_column)
+	{
+		switch (topology)
+		{
+		case HEX_EVEN_ROWS:
+			return HexEvenRowTopology::getDistance(from_row, from_column, to_row, to_column);
+		case SQUARE_FOUR:
+			return SquareFourTopology::getDistance(from_row, from_column, to_row, to_column);
+		case SQUARE_EIGHT:
+			return SquareEightTopology::getDistance(from_row, from_column, to_row, to_column);
+		default:
+			return HexOddRowTopology::getDistance(from_row, from_column, to_row, to_column);
+		}
+	}
+
+	//! \brief Returns the tile adjacent to the specified location in the specified direction
+	//! of the map's topology, or <code>NULL</code> if that neighbour lies off the map.
+	inline Tile* getGridNeighbor(TileMap const& tile_map, int row, int column, int direction)
+	{
+		int const* offset = getGridOffsets(tile_map.getTopology(), row)[direction];
+
+		return tile_map.getView().getTile(row + offset[0], column + offset[1]);
+	}
+
+	//! \brief Returns the direction of the map's topology leading from the first location to
+	//! the second, or -1 if the two locations are not adjacent.
+	inline int getGridDirection(TileMap const& tile_map, int from_row, int from_column,
+	                            int to_row, int to_column)
+	{
+		int const (*offsets)[2] = getGridOffsets(tile_map.getTopology(), from_row);
+		int const direction_count = getDirectionCount(tile_map.getTopology());
+
+		for (int direction = 0; direction < direction_count; ++direction)
+		{
+			if ((offsets[direction][0] == to_row - from_row)
+			 && (offsets[direction][1] == to_column - from_column))
+			{
+				return direction;
+			}
+		}
+
+		return -1;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,618 @@
+#include <algorithm>
+
+#include "HDAStarSearch.h"
+#include "ComponentIndex.h"
+#include "GridTopology.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	size_t const HDAStarSearch::BATCH_SIZE;
+
+	static unsigned int const NO_COST = ~0u;
+
+	// How many turns of a worker's loop pass between two reads of the clock.
+	static size_t const CLOCK_POLL_MASK = 63;
+
+	bool HDAStarSearch::isWorse(OpenEntry const& a, OpenEntry const& b)
+	{
+		// Break ties towards the node farther from the start, as PathSearch does.
+		return (a.final_cost > b.final_cost)
+		    || ((a.final_cost == b.final_cost) && (a.given_cost < b.given_cost));
+	}
+
+	HDAStarSearch::HDAStarSearch(size_t worker_count)
+		: tile_map(0), workers(), given_costs(), parents(), generations(), generation(0)
+		, start_index(-1), goal_index(-1), goal_row(0), goal_column(0), is_done(false), solution()
+		, component_index(0), peak_memory(0), best_cost(NO_COST), work_count(0), is_stopping(false)
+		, is_exhausted(false), slice_expansion_count(0), deadline(), expansion_budget(0), mutex()
+		, slice_started(), slice_ended(), slice(0), stopped_count(0), is_shutting_down(false)
+	{
+		if (!worker_count)
+		{
+			worker_count = thread::hardware_concurrency() ? thread::hardware_concurrency() : 1;
+		}
+
+		for (size_t i = 0; i < worker_count; ++i)
+		{
+			workers.push_back(unique_ptr<Worker>(new Worker()));
+			workers.back()->inbox = 0;
+			workers.back()->outgoing.resize(worker_count);
+			workers.back()->expansion_count = 0;
+			workers.back()->expansions_since_flush = 0;
+			workers.back()->is_idle = true;
+		}
+
+		// Start the threads only once every worker they may message exists.
+		for (size_t i = 0; i < worker_count; ++i)
+		{
+			workers[i]->thread = thread(&HDAStarSearch::work, this, i);
+		}
+	}
+
+	HDAStarSearch::~HDAStarSearch()
+	{
+		{
+			lock_guard<std::mutex> lock(mutex);
+
+			is_shutting_down = true;
+		}
+
+		slice_started.notify_all();
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			workers[i]->thread.join();
+		}
+
+		shutdown();
+	}
+
+	void HDAStarSearch::initialize(TileMap* map)
+	{
+		size_t const tile_count = static_cast<size_t>(map->getRowCount()) * map->getColumnCount();
+
+		tile_map = map;
+		given_costs.assign(tile_count, 0);
+		parents.assign(tile_count, -1);
+		generations.assign(tile_count, 0);
+		generation = 0;
+	}
+
+	size_t HDAStarSearch::getOwner(int tile) const
+	{
+		// Scatter neighbouring tiles over the workers so that every open list stays busy.
+		unsigned int key = static_cast<unsigned int>(tile);
+
+		key ^= key >> 16;
+		key *= 0x45d9f3bu;
+		key ^= key >> 16;
+		return key % workers.size();
+	}
+
+	template <typename Topology>
+	inline unsigned int HDAStarSearch::estimate(int tile, Topology) const
+	{
+		int const column_count = tile_map->getColumnCount();
+
+		return Topology::getDistance(tile / column_count, tile % column_count, goal_row,
+		                             goal_column);
+	}
+
+	void HDAStarSearch::enter(int start_row, int start_column, int goal_r, int goal_c)
+	{
+		TraceScope scope("enter");
+
+		exit();
+
+		// Stamp the per-tile arrays instead of clearing them.
+		if (!++generation)
+		{
+			fill(generations.begin(), generations.end(), 0u);
+			generation = 1;
+		}
+
+		start_index = start_row * tile_map->getColumnCount() + start_column;
+		goal_row = goal_r;
+		goal_column = goal_c;
+		goal_index = goal_row * tile_map->getColumnCount() + goal_column;
+		solution.clear();
+		is_done = false;
+		is_exhausted = false;
+		best_cost = NO_COST;
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			workers[i]->expansion_count = 0;
+			workers[i]->expansions_since_flush = 0;
+			workers[i]->is_idle = true;
+		}
+
+		if (component_index && component_index->isUnreachable(start_index, goal_index))
+		{
+			is_done = true;
+			peak_memory = getMemoryUsage();
+			return;
+		}
+
+		// The workers are asleep, so the start can be handed straight to its owner.
+		Worker& owner = *workers[getOwner(start_index)];
+
+		owner.is_idle = false;
+		work_count = 1;
+
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			relax(owner, start_index, -1, 0, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			relax(owner, start_index, -1, 0, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			relax(owner, start_index, -1, 0, SquareEightTopology());
+			break;
+		default:
+			relax(owner, start_index, -1, 0, HexOddRowTopology());
+		}
+
+		peak_memory = getMemoryUsage();
+	}
+
+	template <typename Topology>
+	void HDAStarSearch::relax(Worker& worker, int tile, int parent, unsigned int given_cost,
+	                          Topology)
+	{
+		if ((generations[tile] == generation) && (given_costs[tile] <= given_cost))
+		{
+			return;
+		}
+
+		generations[tile] = generation;
+		given_costs[tile] = given_cost;
+		parents[tile] = parent;
+
+		if (tile == goal_index)
+		{
+			unsigned int cost = best_cost.load(memory_order_relaxed);
+
+			while ((given_cost < cost) && !best_cost.compare_exchange_weak(cost, given_cost))
+			{
+			}
+
+			return;
+		}
+
+		OpenEntry entry;
+
+		entry.given_cost = given_cost;
+		entry.final_cost = given_cost + estimate(tile, Topology());
+		entry.tile = tile;
+
+		if (entry.final_cost < best_cost.load(memory_order_relaxed))
+		{
+			worker.open.push_back(entry);
+			push_heap(worker.open.begin(), worker.open.end(), isWorse);
+		}
+	}
+
+	template <typename Topology>
+	bool HDAStarSearch::expandNext(Worker& worker, size_t index, Topology)
+	{
+		while (!worker.open.empty())
+		{
+			OpenEntry const entry = worker.open.front();
+
+			pop_heap(worker.open.begin(), worker.open.end(), isWorse);
+			worker.open.pop_back();
+
+			// Skip entries superseded by a cheaper path to the same tile.
+			if (given_costs[entry.tile] != entry.given_cost)
+			{
+				continue;
+			}
+
+			// Nothing left on this open list can lead to a cheaper path than the best one.
+			if (best_cost.load(memory_order_relaxed) <= entry.final_cost)
+			{
+				worker.open.clear();
+				return false;
+			}
+
+			TileMapView const view = tile_map->getView();
+			int const column_count = view.getColumnCount();
+			int const row = entry.tile / column_count;
+			int const column = entry.tile % column_count;
+
+			for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+			{
+				Tile const* const neighbor = getGridNeighbor<Topology>(view, row, column,
+				                                                       direction);
+
+				if (!neighbor || !neighbor->getWeight())
+				{
+					continue;
+				}
+
+				int const neighbor_index = neighbor->getRow() * column_count + neighbor->getColumn();
+				unsigned int const given_cost = entry.given_cost + neighbor->getWeight();
+
+				if (best_cost.load(memory_order_relaxed)
+				 <= given_cost + estimate(neighbor_index, Topology()))
+				{
+					continue;
+				}
+
+				size_t const owner = getOwner(neighbor_index);
+
+				if (owner == index)
+				{
+					relax(worker, neighbor_index, entry.tile, given_cost, Topology());
+					continue;
+				}
+
+				Message message;
+
+				message.tile = neighbor_index;
+				message.parent = entry.tile;
+				message.given_cost = given_cost;
+				worker.outgoing[owner].push_back(message);
+
+				if (BATCH_SIZE <= worker.outgoing[owner].size())
+				{
+					send(worker, owner);
+				}
+			}
+
+			++worker.expansion_count;
+			return true;
+		}
+
+		return false;
+	}
+
+	void HDAStarSearch::send(Worker& worker, size_t destination)
+	{
+		Batch* const batch = new Batch();
+		atomic<Batch*>& inbox = workers[destination]->inbox;
+
+		batch->messages.swap(worker.outgoing[destination]);
+		worker.outgoing[destination].reserve(BATCH_SIZE);
+
+		// Count the batch before it can be seen, so that the work count never drops to zero
+		// while it is in flight.
+		work_count.fetch_add(1);
+		batch->next = inbox.load(memory_order_relaxed);
+
+		while (!inbox.compare_exchange_weak(batch->next, batch, memory_order_release,
+		                                    memory_order_relaxed))
+		{
+		}
+	}
+
+	void HDAStarSearch::flush(Worker& worker)
+	{
+		for (size_t i = 0; i < worker.outgoing.size(); ++i)
+		{
+			if (!worker.outgoing[i].empty())
+			{
+				send(worker, i);
+			}
+		}
+
+		worker.expansions_since_flush = 0;
+	}
+
+	template <typename Topology>
+	bool HDAStarSearch::receive(Worker& worker, Topology)
+	{
+		Batch* batch = worker.inbox.exchange(0, memory_order_acquire);
+
+		if (!batch)
+		{
+			return false;
+		}
+
+		// Become busy before the batches stop counting, for the same reason as in send().
+		if (worker.is_idle)
+		{
+			work_count.fetch_add(1);
+			worker.is_idle = false;
+		}
+
+		while (batch)
+		{
+			Batch* const next = batch->next;
+
+			for (size_t i = 0; i < batch->messages.size(); ++i)
+			{
+				Message const& message = batch->messages[i];
+
+				relax(worker, message.tile, message.parent, message.given_cost, Topology());
+			}
+
+			delete batch;
+			work_count.fetch_sub(1);
+			batch = next;
+		}
+
+		return true;
+	}
+
+	void HDAStarSearch::runSlice(Worker& worker, size_t index)
+	{
+		TraceScope scope("slice", static_cast<long long>(index));
+
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			runSlice(worker, index, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			runSlice(worker, index, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			runSlice(worker, index, SquareEightTopology());
+			break;
+		default:
+			runSlice(worker, index, HexOddRowTopology());
+		}
+	}
+
+	template <typename Topology>
+	void HDAStarSearch::runSlice(Worker& worker, size_t index, Topology)
+	{
+		for (size_t turn = 1; !is_stopping.load(memory_order_relaxed); ++turn)
+		{
+			receive(worker, Topology());
+
+			if (!worker.is_idle)
+			{
+				if (!expandNext(worker, index, Topology()))
+				{
+					// Hand over everything generated before going idle.
+					flush(worker);
+					worker.is_idle = true;
+					work_count.fetch_sub(1);
+				}
+				else
+				{
+					if (BATCH_SIZE <= ++worker.expansions_since_flush)
+					{
+						flush(worker);
+					}
+
+					if (expansion_budget
+					 && (expansion_budget <= slice_expansion_count.fetch_add(1) + 1))
+					{
+						is_stopping = true;
+					}
+				}
+			}
+			else if (!work_count.load())
+			{
+				// Every worker is idle and no batch is in flight, and only a batch could make a
+				// worker busy again, so the search is over.
+				is_exhausted = true;
+				is_stopping = true;
+			}
+			else
+			{
+				this_thread::yield();
+			}
+
+			if (!expansion_budget && !(turn & CLOCK_POLL_MASK) && (deadline <= Clock::now()))
+			{
+				is_stopping = true;
+			}
+		}
+
+		// Let the other workers start the next slice with whatever this one generated.
+		if (!worker.is_idle)
+		{
+			flush(worker);
+		}
+	}
+
+	void HDAStarSearch::work(size_t index)
+	{
+		Worker& worker = *workers[index];
+		unsigned long long last_slice = 0;
+
+		for (;;)
+		{
+			{
+				unique_lock<std::mutex> lock(mutex);
+
+				while (!is_shutting_down && (slice == last_slice))
+				{
+					slice_started.wait(lock);
+				}
+
+				if (is_shutting_down)
+				{
+					return;
+				}
+
+				last_slice = slice;
+			}
+
+			runSlice(worker, index);
+
+			{
+				lock_guard<std::mutex> lock(mutex);
+
+				++stopped_count;
+			}
+
+			slice_ended.notify_all();
+		}
+	}
+
+	void HDAStarSearch::update(long timeslice)
+	{
+		TraceScope scope("update", timeslice);
+
+		run(timeslice, timeslice ? 0 : 1);
+	}
+
+	void HDAStarSearch::updateExpansions(size_t budget)
+	{
+		TraceScope scope("updateExpansions", static_cast<long long>(budget));
+
+		if (budget)
+		{
+			run(0, budget);
+		}
+	}
+
+	void HDAStarSearch::run(long timeslice, size_t budget)
+	{
+		if (is_done)
+		{
+			return;
+		}
+
+		{
+			unique_lock<std::mutex> lock(mutex);
+
+			deadline = Clock::now() + chrono::milliseconds(timeslice);
+			expansion_budget = budget;
+			slice_expansion_count = 0;
+			is_stopping = false;
+			stopped_count = 0;
+			++slice;
+			slice_started.notify_all();
+
+			while (stopped_count < workers.size())
+			{
+				slice_ended.wait(lock);
+			}
+		}
+
+		size_t const memory = getMemoryUsage();
+
+		if (peak_memory < memory)
+		{
+			peak_memory = memory;
+		}
+
+		if (!is_exhausted)
+		{
+			return;
+		}
+
+		if (best_cost != NO_COST)
+		{
+			int const column_count = tile_map->getColumnCount();
+
+			for (int tile = goal_index; tile != -1; tile = parents[tile])
+			{
+				solution.push_back(tile_map->getTile(tile / column_count, tile % column_count));
+			}
+		}
+
+		is_done = true;
+	}
+
+	void HDAStarSearch::discardMessages()
+	{
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			Batch* batch = workers[i]->inbox.exchange(0);
+
+			while (batch)
+			{
+				Batch* const next = batch->next;
+
+				delete batch;
+				batch = next;
+			}
+		}
+	}
+
+	void HDAStarSearch::exit()
+	{
+		TraceScope scope("exit");
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			Worker& worker = *workers[i];
+
+			vector<OpenEntry>().swap(worker.open);
+
+			for (size_t j = 0; j < worker.outgoing.size(); ++j)
+			{
+				vector<Message>().swap(worker.outgoing[j]);
+			}
+
+			worker.is_idle = true;
+		}
+
+		discardMessages();
+		work_count = 0;
+	}
+
+	void HDAStarSearch::shutdown()
+	{
+		exit();
+		vector<unsigned int>().swap(given_costs);
+		vector<int>().swap(parents);
+		vector<unsigned int>().swap(generations);
+		solution.clear();
+		tile_map = 0;
+		is_done = false;
+	}
+
+	bool HDAStarSearch::isDone() const
+	{
+		return is_done;
+	}
+
+	vector<Tile const*> const HDAStarSearch::getSolution() const
+	{
+		TraceScope scope("getSolution");
+
+		return solution;
+	}
+
+	void HDAStarSearch::setComponentIndex(ComponentIndex const* index)
+	{
+		component_index = index;
+	}
+
+	size_t HDAStarSearch::getMemoryUsage() const
+	{
+		size_t memory = given_costs.capacity() * sizeof(unsigned int)
+		              + parents.capacity() * sizeof(int)
+		              + generations.capacity() * sizeof(unsigned int);
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			Worker const& worker = *workers[i];
+
+			memory += worker.open.capacity() * sizeof(OpenEntry);
+
+			for (size_t j = 0; j < worker.outgoing.size(); ++j)
+			{
+				memory += worker.outgoing[j].capacity() * sizeof(Message);
+			}
+		}
+
+		return memory;
+	}
+
+	size_t HDAStarSearch::getExpansionCount() const
+	{
+		size_t expansion_count = 0;
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			expansion_count += workers[i]->expansion_count;
+		}
+
+		return expansion_count;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,209 @@
+//! \file HDAStarSearch.h
+//! \brief Defines the <code>fullsail_ai::algorithms::HDAStarSearch</code> class.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "PathView.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	class ComponentIndex;
+
+	//! \brief Hash-distributed A* (HDA*): one query searched by several threads at once.
+	//!
+	//! Every tile is owned by one worker, chosen by hashing its index.  Each worker keeps its
+	//! own open list and is the only thread that reads or writes the costs and parents of the
+	//! tiles it owns, so the per-tile arrays need no locks.  A worker that generates a tile it
+	//! does not own batches it up and pushes the batch onto the owner's lock-free inbox, which
+	//! any number of workers can push onto and only the owner drains.
+	//!
+	//! Workers expand nodes out of order with respect to each other, so a tile may be expanded
+	//! more than once; the search only ends once no worker holds a node cheaper than the best
+	//! path found so far and no batch is in flight, which keeps the result optimal.  Paths have
+	//! the same cost as those of <code>PathSearch</code>, though ties may be broken differently.
+	//!
+	//! The workers are started by the constructor and only run inside <code>update()</code>
+	//! and <code>updateExpansions()</code>; between calls they sleep.
+	class HDAStarSearch
+	{
+		struct Message
+		{
+			int tile;
+			int parent;
+			unsigned int given_cost;
+		};
+
+		struct Batch
+		{
+			Batch* next;
+			std::vector<Message> messages;
+		};
+
+		struct OpenEntry
+		{
+			unsigned int final_cost;
+			unsigned int given_cost;
+			int tile;
+		};
+
+		struct Worker
+		{
+			std::thread thread;
+			std::atomic<Batch*> inbox;
+			std::vector<OpenEntry> open;
+			std::vector<std::vector<Message> > outgoing;
+			std::size_t expansion_count;
+			std::size_t expansions_since_flush;
+			bool is_idle;
+		};
+
+		typedef std::chrono::steady_clock Clock;
+
+		TileMap* tile_map;
+		std::vector<std::unique_ptr<Worker> > workers;
+		std::vector<unsigned int> given_costs;
+		std::vector<int> parents;
+		std::vector<unsigned int> generations;
+		unsigned int generation;
+		int start_index;
+		int goal_index;
+		int goal_row;
+		int goal_column;
+		bool is_done;
+		std::vector<Tile const*> solution;
+		ComponentIndex const* component_index;
+		std::size_t peak_memory;
+
+		// Shared by the workers while a slice runs.
+		std::atomic<unsigned int> best_cost;
+		std::atomic<long> work_count;
+		std::atomic<bool> is_stopping;
+		std::atomic<bool> is_exhausted;
+		std::atomic<std::size_t> slice_expansion_count;
+		Clock::time_point deadline;
+		std::size_t expansion_budget;
+
+		// Hands slices to the workers and collects them when they stop.
+		std::mutex mutex;
+		std::condition_variable slice_started;
+		std::condition_variable slice_ended;
+		unsigned long long slice;
+		std::size_t stopped_count;
+		bool is_shutting_down;
+
+		HDAStarSearch(HDAStarSearch const&);
+		HDAStarSearch& operator=(HDAStarSearch const&);
+
+		static bool isWorse(OpenEntry const& a, OpenEntry const& b);
+
+		std::size_t getOwner(int tile) const;
+		template <typename Topology>
+		unsigned int estimate(int tile, Topology) const;
+		template <typename Topology>
+		void relax(Worker& worker, int tile, int parent, unsigned int given_cost, Topology);
+		template <typename Topology>
+		bool expandNext(Worker& worker, std::size_t index, Topology);
+		void send(Worker& worker, std::size_t destination);
+		void flush(Worker& worker);
+		template <typename Topology>
+		bool receive(Worker& worker, Topology);
+		void runSlice(Worker& worker, std::size_t index);
+		template <typename Topology>
+		void runSlice(Worker& worker, std::size_t index, Topology);
+		void work(std::size_t index);
+		void run(long timeslice, std::size_t expansion_budget);
+		void discardMessages();
+
+	public:
+		//! \brief The number of messages a worker collects for another before pushing them.
+		static std::size_t const BATCH_SIZE = 64;
+
+		//! \brief Starts the specified number of workers, or one per hardware thread if zero.
+		//! The search is not yet bound to a tile map.
+		DLLEXPORT explicit HDAStarSearch(std::size_t worker_count = 0);
+
+		//! \brief Stops the workers and releases all memory held by the search.
+		DLLEXPORT ~HDAStarSearch();
+
+		//! \brief Binds the search to the specified tile map and sizes its per-tile arrays.
+		DLLEXPORT void initialize(TileMap* tile_map);
+
+		//! \brief Begins a new search between the specified locations.
+		//!
+		//! If a current component index shows the goal to be unreachable, the search finishes
+		//! immediately.
+		DLLEXPORT void enter(int start_row, int start_column, int goal_row, int goal_column);
+
+		//! \brief Runs every worker for roughly <code>timeslice</code> milliseconds, or for a
+		//! single expansion between them if <code>timeslice</code> is zero.
+		DLLEXPORT void update(long timeslice);
+
+		//! \brief Runs the workers until they have made about <code>expansion_budget</code>
+		//! expansions between them.
+		//!
+		//! Each worker may overshoot the budget by one expansion.  Unlike the single-threaded
+		//! engines, the same budget does not always make the same progress, since the workers
+		//! race each other.
+		DLLEXPORT void updateExpansions(std::size_t expansion_budget);
+
+		//! \brief Empties the open lists and drops every message still in flight.
+		//!
+		//! <code>isDone()</code> keeps reporting the outcome of the search that was exited.
+		DLLEXPORT void exit();
+
+		//! \brief Releases the per-tile arrays and unbinds the search from its tile map.
+		DLLEXPORT void shutdown();
+
+		//! \brief Returns <code>true</code> if the current search has either found the goal or
+		//! proven it unreachable, <code>false</code> otherwise.
+		DLLEXPORT bool isDone() const;
+
+		//! \brief Returns the path found by the current search, goal first and start last, or
+		//! an empty vector if the goal is unreachable.
+		DLLEXPORT std::vector<Tile const*> const getSolution() const;
+
+		//! \brief Returns the same path as <code>getSolution()</code> without copying it.
+		//!
+		//! The view stays valid until the next call to <code>enter()</code> or
+		//! <code>shutdown()</code>.
+		inline PathView getSolutionView() const
+		{
+			return PathView(solution);
+		}
+
+		//! \brief Attaches an index that <code>enter()</code> consults to reject unreachable
+		//! goals without searching, or detaches the index if <code>NULL</code>.
+		DLLEXPORT void setComponentIndex(ComponentIndex const* component_index);
+
+		//! \brief Returns the number of bytes currently held by the per-tile arrays, the open
+		//! lists and the outgoing batches.
+		DLLEXPORT std::size_t getMemoryUsage() const;
+
+		//! \brief Returns the largest value <code>getMemoryUsage()</code> has reached since the
+		//! last call to <code>enter()</code>, sampled between slices.
+		inline std::size_t getPeakMemoryUsage() const
+		{
+			return peak_memory;
+		}
+
+		//! \brief Returns the number of nodes expanded by all workers since the last call to
+		//! <code>enter()</code>, re-expansions included.
+		DLLEXPORT std::size_t getExpansionCount() const;
+
+		//! \brief Returns the number of worker threads.
+		inline std::size_t getWorkerCount() const
+		{
+			return workers.size();
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
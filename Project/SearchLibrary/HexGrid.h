@@ -0,0 +1,83 @@
+//! \file HexGrid.h
+//! \brief Adjacency helpers for the hexagonal layout used by <code>fullsail_ai::Tile</code>.
+#pragma once
+
+#include <cstdlib>
+#include "../TileLibrary/TileMap.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief The number of tiles adjacent to an interior tile.
+	static constexpr int HEX_DIRECTION_COUNT = 6;
+
+	//! \brief Row and column offsets of the six neighbours, indexed by row parity and direction.
+	//!
+	//! Odd rows are drawn half a tile to the right of even rows (see the <code>Tile</code>
+	//! constructor), so the diagonal neighbours of a tile depend on the parity of its row.
+	//! Directions run counter-clockwise from east: E, NE, NW, W, SW, SE.
+	static constexpr int HEX_DIRECTION_OFFSETS[2][HEX_DIRECTION_COUNT][2] =
+	{
+		{ { 0, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }, { 1, 0 } },
+		{ { 0, 1 }, { -1, 1 }, { -1, 0 }, { 0, -1 }, { 1, 0 }, { 1, 1 } }
+	};
+
+	//! \brief Offsets of the six neighbours in cube coordinates, x then z, indexed by direction.
+	//!
+	//! In cube coordinates, x is <code>column - (row - (row & 1)) / 2</code> and z is the row.
+	//! Unlike <code>HEX_DIRECTION_OFFSETS</code>, these do not depend on the parity of the row.
+	static constexpr int HEX_CUBE_OFFSETS[2][HEX_DIRECTION_COUNT] =
+	{
+		{ 1, 1, 0, -1, -1, 0 },
+		{ 0, -1, -1, 0, 1, 1 }
+	};
+
+	//! \brief Returns the tile adjacent to the specified location in the specified direction,
+	//! or <code>NULL</code> if that neighbour lies off the map.
+	inline Tile* getHexNeighbor(TileMapView const& view, int row, int column, int direction)
+	{
+		int const* offset = HEX_DIRECTION_OFFSETS[row & 1][direction];
+
+		return view.getTile(row + offset[0], column + offset[1]);
+	}
+
+	//! \brief Same as above, without the exported call to <code>TileMap::getTile()</code>.
+	//!
+	//! Loops over many tiles should take one view before the loop and pass it instead.
+	inline Tile* getHexNeighbor(TileMap const& tile_map, int row, int column, int direction)
+	{
+		return getHexNeighbor(tile_map.getView(), row, column, direction);
+	}
+
+	//! \brief Returns the direction leading from the first location to the second, or -1 if
+	//! the two locations are not adjacent.
+	inline int getHexDirection(int from_row, int from_column, int to_row, int to_column)
+	{
+		int const row_offset = to_row - from_row;
+		int const column_offset = to_column - from_column;
+
+		for (int direction = 0; direction < HEX_DIRECTION_COUNT; ++direction)
+		{
+			int const* offset = HEX_DIRECTION_OFFSETS[from_row & 1][direction];
+
+			if ((offset[0] == row_offset) && (offset[1] == column_offset))
+			{
+				return direction;
+			}
+		}
+
+		return -1;
+	}
+
+	//! \brief Returns the minimum number of steps between two locations, ignoring weights.
+	inline int getHexDistance(int from_row, int from_column, int to_row, int to_column)
+	{
+		// Convert the offset coordinates to cube coordinates (x + y + z == 0).
+		int const from_x = from_column - ((from_row - (from_row & 1)) >> 1);
+		int const to_x = to_column - ((to_row - (to_row & 1)) >> 1);
+		int const dx = std::abs(to_x - from_x);
+		int const dz = std::abs(to_row - from_row);
+		int const dy = std::abs((to_x + to_row) - (from_x + from_row));
+
+		return (dx < dy) ? ((dy < dz) ? dz : dy) : ((dx < dz) ? dz : dx);
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,270 @@
+//! \file HexNeighborKernel.h
+//! \brief Defines the <code>fullsail_ai::algorithms::HexNeighborKernel</code> class.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#if !defined(PATHSEARCH_NO_SIMD) \
+ && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (2 <= _M_IX86_FP)))
+#define PATHSEARCH_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "../TileLibrary/TileMap.h"
+#include "HexGrid.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+#ifdef PATHSEARCH_HAS_SSE2
+	//! \brief The index of the lowest set bit of every mask of six directions.
+	static int const HEX_LOWEST_DIRECTIONS[1 << HEX_DIRECTION_COUNT] =
+	{
+		0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+		4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+		5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+		4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0
+	};
+#endif
+
+	//! \brief The passable neighbours of one tile, as evaluated by <code>HexNeighborKernel</code>.
+	struct HexNeighbors
+	{
+		//! \brief The number of passable neighbours; only that many entries of each array are set.
+		int count;
+
+		//! \brief The direction (see <code>HEX_DIRECTION_OFFSETS</code>) of each neighbour.
+		int directions[HEX_DIRECTION_COUNT];
+
+		//! \brief The cost of reaching each neighbour through the expanded tile.
+		unsigned int given_costs[HEX_DIRECTION_COUNT];
+
+		//! \brief The number of steps between each neighbour and the goal.
+		unsigned int estimates[HEX_DIRECTION_COUNT];
+	};
+
+	//! \brief Evaluates the six neighbours of a tile in one pass, for the inner loop of a search.
+	//!
+	//! The kernel keeps its own copy of the tile weights, one byte per tile in row-major order
+	//! and framed by a border of impassable tiles, so that a neighbour needs neither a bounds
+	//! check nor a <code>Tile</code> pointer to be looked at.  The heuristic is computed in cube
+	//! coordinates, where the offset of each direction does not depend on the row.
+	//!
+	//! With SSE2 (every x86-64 target), the weights, costs, estimates and the passability mask
+	//! of all six neighbours are computed in 32-bit lanes of two registers; otherwise, or when
+	//! <code>PATHSEARCH_NO_SIMD</code> is defined, <code>evaluate()</code> falls back to
+	//! <code>evaluateScalar()</code>.  Both return the same neighbours in the same order.
+	class HexNeighborKernel
+	{
+		TileMap const* tile_map;
+		std::vector<unsigned char> weights;
+		int row_count;
+		int column_count;
+		int stride;
+		unsigned int map_version;
+		int goal_x;
+		int goal_z;
+
+		// The row and column of a tile in cube coordinates are x and z.
+		static inline int getCubeX(int row, int column)
+		{
+			return column - ((row - (row & 1)) >> 1);
+		}
+
+		inline int getOffset(int parity, int direction) const
+		{
+			int const* offset = HEX_DIRECTION_OFFSETS[parity][direction];
+
+			return offset[0] * stride + offset[1];
+		}
+
+#ifdef PATHSEARCH_HAS_SSE2
+		static inline __m128i getAbsolute(__m128i value)
+		{
+			__m128i const sign = _mm_srai_epi32(value, 31);
+
+			return _mm_sub_epi32(_mm_xor_si128(value, sign), sign);
+		}
+
+		static inline __m128i getMaximum(__m128i a, __m128i b)
+		{
+			__m128i const is_greater = _mm_cmpgt_epi32(a, b);
+
+			return _mm_or_si128(_mm_and_si128(is_greater, a), _mm_andnot_si128(is_greater, b));
+		}
+#endif
+
+	public:
+		//! \brief Constructs a kernel with no weights.
+		inline HexNeighborKernel()
+			: tile_map(0), weights(), row_count(0), column_count(0), stride(0), map_version(0)
+			, goal_x(0), goal_z(0)
+		{
+		}
+
+		//! \brief Copies the weights of the specified tile map.
+		inline void build(TileMap const& map)
+		{
+			tile_map = &map;
+			row_count = map.getRowCount();
+			column_count = map.getColumnCount();
+			stride = column_count + 2;
+			map_version = map.getVersion();
+
+			TileMapView const view = map.getView();
+
+			weights.assign(static_cast<std::size_t>(row_count + 2) * stride, 0);
+
+			for (int row = 0; row < row_count; ++row)
+			{
+				unsigned char* const weight_row = &weights[(row + 1) * stride + 1];
+				int const first_tile = view.getIndex(row, 0);
+
+				for (int column = 0; column < column_count; ++column)
+				{
+					weight_row[column] = view.getTile(first_tile + column)->getWeight();
+				}
+			}
+		}
+
+		//! \brief Returns <code>true</code> if the kernel holds the current weights of the
+		//! specified tile map, <code>false</code> if it must be built again.
+		inline bool isCurrent(TileMap const& map) const
+		{
+			return (tile_map == &map) && (map_version == map.getVersion())
+			    && (row_count == map.getRowCount()) && (column_count == map.getColumnCount());
+		}
+
+		//! \brief Sets the location the estimates are measured to.
+		inline void setGoal(int row, int column)
+		{
+			goal_x = getCubeX(row, column);
+			goal_z = row;
+		}
+
+		//! \brief Writes the passable neighbours of the specified tile to <code>neighbors</code>.
+		//!
+		//! \param   given_cost  the cost of reaching the specified tile.
+		//! \return  the number of passable neighbours.
+		inline int evaluate(int row, int column, unsigned int given_cost,
+		                    HexNeighbors& neighbors) const
+		{
+#ifdef PATHSEARCH_HAS_SSE2
+			return evaluateSse2(row, column, given_cost, neighbors);
+#else
+			return evaluateScalar(row, column, given_cost, neighbors);
+#endif
+		}
+
+		//! \brief Same as <code>evaluate()</code>, one neighbour at a time.
+		inline int evaluateScalar(int row, int column, unsigned int given_cost,
+		                          HexNeighbors& neighbors) const
+		{
+			unsigned char const* const center = &weights[(row + 1) * stride + column + 1];
+			int const parity = row & 1;
+			int const x = getCubeX(row, column) - goal_x;
+			int const z = row - goal_z;
+			int count = 0;
+
+			for (int direction = 0; direction < HEX_DIRECTION_COUNT; ++direction)
+			{
+				unsigned int const weight = center[getOffset(parity, direction)];
+
+				if (!weight)
+				{
+					continue;
+				}
+
+				int const dx = x + HEX_CUBE_OFFSETS[0][direction];
+				int const dz = z + HEX_CUBE_OFFSETS[1][direction];
+				int const ax = (dx < 0) ? -dx : dx;
+				int const az = (dz < 0) ? -dz : dz;
+				int const ay = (dx + dz < 0) ? -(dx + dz) : (dx + dz);
+				int const estimate = (ax < ay) ? ((ay < az) ? az : ay) : ((ax < az) ? az : ax);
+
+				neighbors.directions[count] = direction;
+				neighbors.given_costs[count] = given_cost + weight;
+				neighbors.estimates[count] = static_cast<unsigned int>(estimate);
+				++count;
+			}
+
+			neighbors.count = count;
+			return count;
+		}
+
+#ifdef PATHSEARCH_HAS_SSE2
+		//! \brief Same as <code>evaluate()</code>, all six neighbours at once in SSE2 lanes.
+		inline int evaluateSse2(int row, int column, unsigned int given_cost,
+		                        HexNeighbors& neighbors) const
+		{
+			unsigned char const* const center = &weights[(row + 1) * stride + column + 1];
+			int const parity = row & 1;
+
+			// Lanes 0-3 hold directions 0-3 and lanes 4-5 of the second register directions 4-5.
+			__m128i const weights_low = _mm_setr_epi32(
+				center[getOffset(parity, 0)], center[getOffset(parity, 1)]
+			  , center[getOffset(parity, 2)], center[getOffset(parity, 3)]
+			);
+			__m128i const weights_high = _mm_setr_epi32(
+				center[getOffset(parity, 4)], center[getOffset(parity, 5)], 0, 0
+			);
+			__m128i const zero = _mm_setzero_si128();
+			int const impassable
+				= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(weights_low, zero)))
+				| (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(weights_high, zero))) << 4);
+			int const passable = ~impassable & ((1 << HEX_DIRECTION_COUNT) - 1);
+
+			__m128i const given = _mm_set1_epi32(static_cast<int>(given_cost));
+			__m128i const x = _mm_set1_epi32(getCubeX(row, column) - goal_x);
+			__m128i const z = _mm_set1_epi32(row - goal_z);
+			int const* const offsets_x = HEX_CUBE_OFFSETS[0];
+			int const* const offsets_z = HEX_CUBE_OFFSETS[1];
+			__m128i dx[2], dz[2];
+
+			dx[0] = _mm_add_epi32(x, _mm_loadu_si128(reinterpret_cast<__m128i const*>(offsets_x)));
+			dx[1] = _mm_add_epi32(x, _mm_setr_epi32(offsets_x[4], offsets_x[5], 0, 0));
+			dz[0] = _mm_add_epi32(z, _mm_loadu_si128(reinterpret_cast<__m128i const*>(offsets_z)));
+			dz[1] = _mm_add_epi32(z, _mm_setr_epi32(offsets_z[4], offsets_z[5], 0, 0));
+
+			union
+			{
+				__m128i vectors[2];
+				unsigned int lanes[8];
+			} given_costs, estimates;
+
+			given_costs.vectors[0] = _mm_add_epi32(given, weights_low);
+			given_costs.vectors[1] = _mm_add_epi32(given, weights_high);
+
+			for (int i = 0; i < 2; ++i)
+			{
+				estimates.vectors[i] = getMaximum(
+					getMaximum(getAbsolute(dx[i]), getAbsolute(dz[i]))
+				  , getAbsolute(_mm_add_epi32(dx[i], dz[i]))
+				);
+			}
+
+			int count = 0;
+
+			// Visit the set bits of the mask only, lowest first.
+			for (int mask = passable; mask; mask &= mask - 1)
+			{
+				int const direction = HEX_LOWEST_DIRECTIONS[mask];
+
+				neighbors.directions[count] = direction;
+				neighbors.given_costs[count] = given_costs.lanes[direction];
+				neighbors.estimates[count] = estimates.lanes[direction];
+				++count;
+			}
+
+			neighbors.count = count;
+			return count;
+		}
+#endif
+
+		//! \brief Returns the number of bytes held by the copy of the weights.
+		inline std::size_t getMemoryUsage() const
+		{
+			return weights.capacity();
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,301 @@
+#include <chrono>
+
+#include "IDAStarSearch.h"
+#include "ComponentIndex.h"
+#include "GridTopology.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	static unsigned int const NO_THRESHOLD = ~0u;
+
+	static inline size_t hashTile(int tile)
+	{
+		unsigned int key = static_cast<unsigned int>(tile);
+
+		key ^= key >> 16;
+		key *= 0x45d9f3bu;
+		return key ^ (key >> 16);
+	}
+
+	IDAStarSearch::IDAStarSearch(size_t table_size)
+		: tile_map(0), stack(), table(), start_index(-1), goal_index(-1), goal_row(0), goal_column(0)
+		, threshold(0), next_threshold(NO_THRESHOLD), iteration(0), is_done(false), solution()
+		, component_index(0), peak_memory(0), expansion_count(0)
+	{
+		size_t size = 1;
+
+		while (size < table_size)
+		{
+			size <<= 1;
+		}
+
+		TableEntry empty;
+
+		empty.tile = -1;
+		empty.given_cost = 0;
+		empty.iteration = 0;
+		table.assign(size, empty);
+	}
+
+	IDAStarSearch::~IDAStarSearch()
+	{
+		shutdown();
+	}
+
+	void IDAStarSearch::initialize(TileMap* map)
+	{
+		tile_map = map;
+	}
+
+	template <typename Topology>
+	inline unsigned int IDAStarSearch::estimate(int tile, Topology) const
+	{
+		int const column_count = tile_map->getColumnCount();
+
+		return Topology::getDistance(tile / column_count, tile % column_count, goal_row,
+		                             goal_column);
+	}
+
+	bool IDAStarSearch::isTransposition(int tile, unsigned int given_cost)
+	{
+		TableEntry& entry = table[hashTile(tile) & (table.size() - 1)];
+
+		if ((entry.tile == tile) && (entry.iteration == iteration) && (entry.given_cost <= given_cost))
+		{
+			return true;
+		}
+
+		entry.tile = tile;
+		entry.given_cost = given_cost;
+		entry.iteration = iteration;
+		return false;
+	}
+
+	void IDAStarSearch::push(int tile, unsigned int given_cost)
+	{
+		Frame frame;
+
+		frame.tile = tile;
+		frame.given_cost = given_cost;
+		frame.direction = 0;
+		stack.push_back(frame);
+	}
+
+	void IDAStarSearch::enter(int start_row, int start_column, int goal_r, int goal_c)
+	{
+		TraceScope scope("enter");
+
+		start_index = start_row * tile_map->getColumnCount() + start_column;
+		goal_row = goal_r;
+		goal_column = goal_c;
+		goal_index = goal_row * tile_map->getColumnCount() + goal_column;
+		stack.clear();
+		solution.clear();
+		threshold = getGridDistance(tile_map->getTopology(), start_row, start_column, goal_row,
+		                            goal_column);
+		next_threshold = NO_THRESHOLD;
+		is_done = false;
+
+		// Entries stamped by earlier searches must not prune this one.
+		if (!++iteration)
+		{
+			for (size_t i = 0; i < table.size(); ++i)
+			{
+				table[i].tile = -1;
+			}
+
+			iteration = 1;
+		}
+
+		isTransposition(start_index, 0);
+		push(start_index, 0);
+		peak_memory = getMemoryUsage();
+		expansion_count = 0;
+
+		if (component_index && component_index->isUnreachable(start_index, goal_index))
+		{
+			is_done = true;
+		}
+	}
+
+	void IDAStarSearch::update(long timeslice)
+	{
+		TraceScope scope("update", timeslice);
+
+		run(timeslice, 0);
+	}
+
+	void IDAStarSearch::updateExpansions(size_t expansion_budget)
+	{
+		TraceScope scope("updateExpansions", static_cast<long long>(expansion_budget));
+
+		if (expansion_budget)
+		{
+			run(0, expansion_budget);
+		}
+	}
+
+	void IDAStarSearch::run(long timeslice, size_t expansion_budget)
+	{
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			run(timeslice, expansion_budget, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			run(timeslice, expansion_budget, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			run(timeslice, expansion_budget, SquareEightTopology());
+			break;
+		default:
+			run(timeslice, expansion_budget, HexOddRowTopology());
+		}
+	}
+
+	template <typename Topology>
+	void IDAStarSearch::run(long timeslice, size_t expansion_budget, Topology)
+	{
+		// An expansion budget replaces the clock entirely.
+		chrono::steady_clock::time_point const deadline = expansion_budget
+			? chrono::steady_clock::time_point()
+			: chrono::steady_clock::now() + chrono::milliseconds(timeslice);
+		TileMapView const view = tile_map->getView();
+		int const column_count = view.getColumnCount();
+
+		while (!is_done)
+		{
+			if (stack.empty())
+			{
+				// The iteration is over.  Deepen to the smallest f-cost that was cut.
+				if (next_threshold == NO_THRESHOLD)
+				{
+					is_done = true;
+					break;
+				}
+
+				threshold = next_threshold;
+				next_threshold = NO_THRESHOLD;
+
+				if (!++iteration)
+				{
+					iteration = 1;
+				}
+
+				isTransposition(start_index, 0);
+				push(start_index, 0);
+				continue;
+			}
+
+			Frame& frame = stack.back();
+
+			if (!frame.direction && (frame.tile == goal_index))
+			{
+				for (size_t i = stack.size(); i--; )
+				{
+					solution.push_back(view.getTile(stack[i].tile));
+				}
+
+				is_done = true;
+				break;
+			}
+
+			if (frame.direction == Topology::DIRECTION_COUNT)
+			{
+				stack.pop_back();
+				continue;
+			}
+
+			Tile const* neighbor = getGridNeighbor<Topology>(view, frame.tile / column_count,
+			                                                frame.tile % column_count,
+			                                                frame.direction++);
+
+			if (!neighbor || !neighbor->getWeight())
+			{
+				continue;
+			}
+
+			int const neighbor_index = neighbor->getRow() * column_count + neighbor->getColumn();
+
+			// Never step straight back to where we came from.
+			if ((1 < stack.size()) && (stack[stack.size() - 2].tile == neighbor_index))
+			{
+				continue;
+			}
+
+			unsigned int const given_cost = frame.given_cost + neighbor->getWeight();
+			unsigned int const final_cost = given_cost + estimate(neighbor_index, Topology());
+
+			if (threshold < final_cost)
+			{
+				if (final_cost < next_threshold)
+				{
+					next_threshold = final_cost;
+				}
+
+				continue;
+			}
+
+			if (isTransposition(neighbor_index, given_cost))
+			{
+				continue;
+			}
+
+			push(neighbor_index, given_cost);
+			++expansion_count;
+
+			size_t const memory = getMemoryUsage();
+
+			if (peak_memory < memory)
+			{
+				peak_memory = memory;
+			}
+
+			if (expansion_budget ? !--expansion_budget
+			                     : (!timeslice || (deadline <= chrono::steady_clock::now())))
+			{
+				break;
+			}
+		}
+	}
+
+	void IDAStarSearch::exit()
+	{
+		TraceScope scope("exit");
+
+		vector<Frame>().swap(stack);
+	}
+
+	void IDAStarSearch::shutdown()
+	{
+		exit();
+		solution.clear();
+		tile_map = 0;
+		is_done = false;
+	}
+
+	bool IDAStarSearch::isDone() const
+	{
+		return is_done;
+	}
+
+	vector<Tile const*> const IDAStarSearch::getSolution() const
+	{
+		TraceScope scope("getSolution");
+
+		return solution;
+	}
+
+	void IDAStarSearch::setComponentIndex(ComponentIndex const* index)
+	{
+		component_index = index;
+	}
+
+	size_t IDAStarSearch::getMemoryUsage() const
+	{
+		return stack.capacity() * sizeof(Frame) + table.capacity() * sizeof(TableEntry);
+	}
+}}  // namespace fullsail_ai::algorithms
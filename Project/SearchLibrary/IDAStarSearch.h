@@ -0,0 +1,135 @@
+//! \file IDAStarSearch.h
+//! \brief Defines the <code>fullsail_ai::algorithms::IDAStarSearch</code> class.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "PathView.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	class ComponentIndex;
+
+	//! \brief Time-sliced iterative-deepening A* with a fixed-size transposition table.
+	//!
+	//! Each iteration is a depth-first search bounded by an f-cost threshold, so the only
+	//! memory that grows with the query is the stack of the current path.  A direct-mapped
+	//! transposition table remembers the cheapest cost at which each tile was reached during
+	//! the current iteration and prunes costlier revisits; when two tiles collide, the newer
+	//! one wins, which costs time but never correctness.  Costs and the heuristic are the same
+	//! as for <code>PathSearch</code>.
+	class IDAStarSearch
+	{
+		struct Frame
+		{
+			int tile;
+			unsigned int given_cost;
+			int direction;
+		};
+
+		struct TableEntry
+		{
+			int tile;
+			unsigned int given_cost;
+			unsigned int iteration;
+		};
+
+		TileMap* tile_map;
+		std::vector<Frame> stack;
+		std::vector<TableEntry> table;
+		int start_index;
+		int goal_index;
+		int goal_row;
+		int goal_column;
+		unsigned int threshold;
+		unsigned int next_threshold;
+		unsigned int iteration;
+		bool is_done;
+		std::vector<Tile const*> solution;
+		ComponentIndex const* component_index;
+		std::size_t peak_memory;
+		std::size_t expansion_count;
+
+		template <typename Topology>
+		unsigned int estimate(int tile, Topology) const;
+		bool isTransposition(int tile, unsigned int given_cost);
+		void push(int tile, unsigned int given_cost);
+		void run(long timeslice, std::size_t expansion_budget);
+		template <typename Topology>
+		void run(long timeslice, std::size_t expansion_budget, Topology);
+
+	public:
+		//! \brief Constructs a search whose transposition table holds at least
+		//! <code>table_size</code> entries, rounded up to a power of two.
+		DLLEXPORT explicit IDAStarSearch(std::size_t table_size = 1 << 16);
+
+		//! \brief Releases all memory held by the search.
+		DLLEXPORT ~IDAStarSearch();
+
+		//! \brief Binds the search to the specified tile map.
+		DLLEXPORT void initialize(TileMap* tile_map);
+
+		//! \brief Begins a new search between the specified locations.
+		//!
+		//! If a current component index shows the goal to be unreachable, the search finishes
+		//! immediately.
+		DLLEXPORT void enter(int start_row, int start_column, int goal_row, int goal_column);
+
+		//! \brief Runs the search for roughly <code>timeslice</code> milliseconds, or until it
+		//! generates a single node if <code>timeslice</code> is zero.
+		DLLEXPORT void update(long timeslice);
+
+		//! \brief Runs the search until it has generated at most <code>expansion_budget</code>
+		//! nodes, without reading the clock, so the same inputs always make the same progress.
+		DLLEXPORT void updateExpansions(std::size_t expansion_budget);
+
+		//! \brief Releases the path stack of the current search.
+		//!
+		//! <code>isDone()</code> keeps reporting the outcome of the search that was exited.
+		DLLEXPORT void exit();
+
+		//! \brief Unbinds the search from its tile map.
+		DLLEXPORT void shutdown();
+
+		//! \brief Returns <code>true</code> if the current search has either found the goal or
+		//! proven it unreachable, <code>false</code> otherwise.
+		DLLEXPORT bool isDone() const;
+
+		//! \brief Returns the path found by the current search, goal first and start last, or
+		//! an empty vector if the goal is unreachable.
+		DLLEXPORT std::vector<Tile const*> const getSolution() const;
+
+		//! \brief Returns the same path as <code>getSolution()</code> without copying it.
+		//!
+		//! The view stays valid until the next call to <code>enter()</code> or
+		//! <code>shutdown()</code>.
+		inline PathView getSolutionView() const
+		{
+			return PathView(solution);
+		}
+
+		//! \brief Attaches an index that <code>enter()</code> consults to reject unreachable
+		//! goals without searching, or detaches the index if <code>NULL</code>.
+		DLLEXPORT void setComponentIndex(ComponentIndex const* component_index);
+
+		//! \brief Returns the number of bytes currently held by the stack and the table.
+		DLLEXPORT std::size_t getMemoryUsage() const;
+
+		//! \brief Returns the largest value <code>getMemoryUsage()</code> has reached since the
+		//! last call to <code>enter()</code>.
+		inline std::size_t getPeakMemoryUsage() const
+		{
+			return peak_memory;
+		}
+
+		//! \brief Returns the number of nodes expanded since the last call to <code>enter()</code>,
+		//! counting every iteration.
+		inline std::size_t getExpansionCount() const
+		{
+			return expansion_count;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
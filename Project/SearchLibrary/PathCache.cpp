@@ -0,0 +1,409 @@
+#include <algorithm>
+
+#include "PathCache.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	static inline unsigned long long makeKey(int start, int goal)
+	{
+		return (static_cast<unsigned long long>(static_cast<unsigned int>(start)) << 32)
+		     | static_cast<unsigned int>(goal);
+	}
+
+	// Scrambles the bits of a key so that neighbouring tiles land in different shards.
+	static inline unsigned long long mix(unsigned long long key)
+	{
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdULL;
+		key ^= key >> 33;
+		key *= 0xc4ceb9fe1a85ec53ULL;
+		return key ^ (key >> 33);
+	}
+
+	PathCache::PathCache(size_t byte_budget, unsigned int shard_count)
+		: shards(shard_count ? shard_count : 1), shard_budget(byte_budget / shards.size())
+		, current_version(0), oldest_valid_version(0), hit_count(0), subpath_hit_count(0)
+		, miss_count(0), insertion_count(0), eviction_count(0), invalidation_count(0)
+	{
+		for (size_t i = 0; i < shards.size(); ++i)
+		{
+			shards[i] = new Shard();
+			shards[i]->bytes_used = 0;
+		}
+	}
+
+	PathCache::~PathCache()
+	{
+		for (size_t i = 0; i < shards.size(); ++i)
+		{
+			delete shards[i];
+		}
+	}
+
+	PathCache::Shard& PathCache::getEntryShard(int start, int goal) const
+	{
+		return *shards[mix(makeKey(start, goal)) % shards.size()];
+	}
+
+	PathCache::Shard& PathCache::getTileShard(int tile) const
+	{
+		return *shards[mix(static_cast<unsigned int>(tile)) % shards.size()];
+	}
+
+	bool PathCache::isValid(Entry const& entry) const
+	{
+		return !entry.is_invalid.load() && (oldest_valid_version.load() <= entry.version);
+	}
+
+	void PathCache::synchronize(unsigned int version)
+	{
+		unsigned int current = current_version.load();
+
+		// A newer version that nobody reported could hide any kind of change.
+		while (current < version)
+		{
+			if (current_version.compare_exchange_weak(current, version))
+			{
+				unsigned int oldest = oldest_valid_version.load();
+
+				while ((oldest < version) && !oldest_valid_version.compare_exchange_weak(oldest, version))
+				{
+				}
+
+				break;
+			}
+		}
+	}
+
+	void PathCache::addCrossings(EntryPointer const& entry)
+	{
+		vector<vector<size_t> > positions(shards.size());
+
+		for (size_t i = 0; i < entry->path.size(); ++i)
+		{
+			positions[mix(static_cast<unsigned int>(entry->path[i])) % shards.size()].push_back(i);
+		}
+
+		for (size_t s = 0; s < shards.size(); ++s)
+		{
+			if (positions[s].empty())
+			{
+				continue;
+			}
+
+			lock_guard<mutex> lock(shards[s]->mutex);
+
+			for (size_t i = 0; i < positions[s].size(); ++i)
+			{
+				Crossing crossing;
+
+				crossing.entry = entry;
+				crossing.position = positions[s][i];
+				shards[s]->crossings[entry->path[crossing.position]].push_back(crossing);
+			}
+		}
+	}
+
+	void PathCache::removeCrossings(Entry const& entry)
+	{
+		vector<vector<int> > tiles(shards.size());
+
+		for (size_t i = 0; i < entry.path.size(); ++i)
+		{
+			tiles[mix(static_cast<unsigned int>(entry.path[i])) % shards.size()].push_back(entry.path[i]);
+		}
+
+		for (size_t s = 0; s < shards.size(); ++s)
+		{
+			if (tiles[s].empty())
+			{
+				continue;
+			}
+
+			lock_guard<mutex> lock(shards[s]->mutex);
+
+			for (size_t i = 0; i < tiles[s].size(); ++i)
+			{
+				unordered_map<int, vector<Crossing> >::iterator itr
+					= shards[s]->crossings.find(tiles[s][i]);
+
+				if (itr == shards[s]->crossings.end())
+				{
+					continue;
+				}
+
+				vector<Crossing>& crossings = itr->second;
+
+				for (size_t c = crossings.size(); c--; )
+				{
+					EntryPointer const crossed = crossings[c].entry.lock();
+
+					if (!crossed || (crossed.get() == &entry))
+					{
+						crossings[c] = crossings.back();
+						crossings.pop_back();
+					}
+				}
+
+				if (crossings.empty())
+				{
+					shards[s]->crossings.erase(itr);
+				}
+			}
+		}
+	}
+
+	void PathCache::erase(EntryPointer const& entry)
+	{
+		{
+			Shard& shard = getEntryShard(entry->start, entry->goal);
+			lock_guard<mutex> lock(shard.mutex);
+			unordered_map<unsigned long long, EntryList::iterator>::iterator itr
+				= shard.lookup.find(makeKey(entry->start, entry->goal));
+
+			if ((itr == shard.lookup.end()) || (*itr->second != entry))
+			{
+				// Someone else already erased or replaced this entry.
+				return;
+			}
+
+			shard.bytes_used -= entry->bytes;
+			shard.entries.erase(itr->second);
+			shard.lookup.erase(itr);
+		}
+
+		removeCrossings(*entry);
+	}
+
+	bool PathCache::lookup(int start, int goal, unsigned int version, vector<int>& path)
+	{
+		synchronize(version);
+
+		if (version == current_version.load())
+		{
+			EntryPointer stale;
+
+			{
+				Shard& shard = getEntryShard(start, goal);
+				lock_guard<mutex> lock(shard.mutex);
+				unordered_map<unsigned long long, EntryList::iterator>::iterator itr
+					= shard.lookup.find(makeKey(start, goal));
+
+				if (itr != shard.lookup.end())
+				{
+					if (isValid(**itr->second))
+					{
+						shard.entries.splice(shard.entries.begin(), shard.entries, itr->second);
+						path = shard.entries.front()->path;
+						++hit_count;
+						return true;
+					}
+
+					stale = *itr->second;
+				}
+			}
+
+			if (stale)
+			{
+				erase(stale);
+			}
+
+			if (lookupSubpath(start, goal, path))
+			{
+				++subpath_hit_count;
+				return true;
+			}
+		}
+
+		++miss_count;
+		return false;
+	}
+
+	bool PathCache::lookupSubpath(int start, int goal, vector<int>& path)
+	{
+		vector<pair<EntryPointer, size_t> > candidates;
+
+		{
+			Shard& shard = getTileShard(start);
+			lock_guard<mutex> lock(shard.mutex);
+			unordered_map<int, vector<Crossing> >::const_iterator itr = shard.crossings.find(start);
+
+			if (itr == shard.crossings.end())
+			{
+				return false;
+			}
+
+			for (size_t c = 0; c < itr->second.size(); ++c)
+			{
+				if (EntryPointer entry = itr->second[c].entry.lock())
+				{
+					candidates.push_back(make_pair(entry, itr->second[c].position));
+				}
+			}
+		}
+
+		// Paths are immutable once cached, so they can be read without holding any lock.
+		for (size_t c = 0; c < candidates.size(); ++c)
+		{
+			Entry const& entry = *candidates[c].first;
+			vector<int>::const_iterator const start_itr = entry.path.begin() + candidates[c].second;
+			vector<int>::const_iterator const goal_itr = find(entry.path.begin(), start_itr, goal);
+
+			if ((goal_itr != start_itr) && isValid(entry))
+			{
+				path.assign(goal_itr, start_itr + 1);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void PathCache::insert(int start, int goal, unsigned int version, vector<int> const& path)
+	{
+		synchronize(version);
+
+		if (version != current_version.load())
+		{
+			return;
+		}
+
+		EntryPointer entry(new Entry());
+		vector<EntryPointer> evicted;
+
+		entry->start = start;
+		entry->goal = goal;
+		entry->version = version;
+		entry->is_invalid = false;
+		entry->path = path;
+		entry->bytes = sizeof(Entry) + path.size() * (sizeof(int) + sizeof(Crossing));
+
+		{
+			Shard& shard = getEntryShard(start, goal);
+			lock_guard<mutex> lock(shard.mutex);
+			unsigned long long const key = makeKey(start, goal);
+			unordered_map<unsigned long long, EntryList::iterator>::iterator itr = shard.lookup.find(key);
+
+			if (itr != shard.lookup.end())
+			{
+				evicted.push_back(*itr->second);
+				shard.bytes_used -= (*itr->second)->bytes;
+				shard.entries.erase(itr->second);
+			}
+
+			shard.entries.push_front(entry);
+			shard.lookup[key] = shard.entries.begin();
+			shard.bytes_used += entry->bytes;
+
+			while ((shard_budget < shard.bytes_used) && (1 < shard.entries.size()))
+			{
+				EntryPointer const& oldest = shard.entries.back();
+
+				shard.bytes_used -= oldest->bytes;
+				shard.lookup.erase(makeKey(oldest->start, oldest->goal));
+				evicted.push_back(oldest);
+				shard.entries.pop_back();
+				++eviction_count;
+			}
+		}
+
+		addCrossings(entry);
+		++insertion_count;
+
+		for (size_t i = 0; i < evicted.size(); ++i)
+		{
+			removeCrossings(*evicted[i]);
+		}
+
+		// An invalidation that ran before our crossings were visible could not have seen us.
+		if (version != current_version.load())
+		{
+			entry->is_invalid = true;
+			erase(entry);
+		}
+	}
+
+	void PathCache::onTileWeightChanged(int tile, unsigned char old_weight, unsigned char new_weight,
+	                                    unsigned int new_version)
+	{
+		unsigned int expected = new_version - 1;
+
+		if ((new_weight && (!old_weight || (new_weight < old_weight)))
+		 || !current_version.compare_exchange_strong(expected, new_version))
+		{
+			// The tile got cheaper, so any cached path may have been beaten, or we missed an
+			// edit and cannot tell what else changed.
+			synchronize(new_version);
+			invalidation_count += getStatistics().entry_count;
+			clear();
+			return;
+		}
+
+		vector<EntryPointer> crossed;
+
+		{
+			Shard& shard = getTileShard(tile);
+			lock_guard<mutex> lock(shard.mutex);
+			unordered_map<int, vector<Crossing> >::const_iterator itr = shard.crossings.find(tile);
+
+			if (itr != shard.crossings.end())
+			{
+				for (size_t c = 0; c < itr->second.size(); ++c)
+				{
+					if (EntryPointer entry = itr->second[c].entry.lock())
+					{
+						crossed.push_back(entry);
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < crossed.size(); ++i)
+		{
+			if (!crossed[i]->is_invalid.exchange(true))
+			{
+				++invalidation_count;
+				erase(crossed[i]);
+			}
+		}
+	}
+
+	void PathCache::clear()
+	{
+		for (size_t s = 0; s < shards.size(); ++s)
+		{
+			lock_guard<mutex> lock(shards[s]->mutex);
+
+			shards[s]->entries.clear();
+			shards[s]->lookup.clear();
+			shards[s]->crossings.clear();
+			shards[s]->bytes_used = 0;
+		}
+	}
+
+	PathCache::Statistics PathCache::getStatistics() const
+	{
+		Statistics statistics;
+
+		statistics.hit_count = hit_count.load();
+		statistics.subpath_hit_count = subpath_hit_count.load();
+		statistics.miss_count = miss_count.load();
+		statistics.insertion_count = insertion_count.load();
+		statistics.eviction_count = eviction_count.load();
+		statistics.invalidation_count = invalidation_count.load();
+		statistics.entry_count = 0;
+		statistics.bytes_used = 0;
+
+		for (size_t s = 0; s < shards.size(); ++s)
+		{
+			lock_guard<mutex> lock(shards[s]->mutex);
+
+			statistics.entry_count += shards[s]->entries.size();
+			statistics.bytes_used += shards[s]->bytes_used;
+		}
+
+		return statistics;
+	}
+}}  // namespace fullsail_ai::algorithms
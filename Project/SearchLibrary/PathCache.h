@@ -0,0 +1,146 @@
+//! \file PathCache.h
+//! \brief Defines the <code>fullsail_ai::algorithms::PathCache</code> class.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Thread-safe cache of optimal paths, keyed by start index, goal index and the map
+	//! version each path was computed against.
+	//!
+	//! Tile indices are <code>row * column_count + column</code>, and paths are stored goal
+	//! first, in the same order as <code>PathSearch::getSolution()</code>.  Entries are spread
+	//! over independently locked shards, and each shard evicts its least recently used entries
+	//! once it exceeds its share of the byte budget.
+	//!
+	//! Any stretch of an optimal path is itself optimal, so a query whose start and goal both
+	//! lie, in that order, on a cached path is answered from that path.
+	//!
+	//! The cache only trusts entries made since the last change it could not account for.
+	//! A weight increase reported through <code>onTileWeightChanged()</code> only invalidates
+	//! the paths that cross the changed tile, because no other path can have become cheaper
+	//! than a cached one.  Any other change, reported or not, invalidates every entry.
+	class PathCache
+	{
+	public:
+		//! \brief Snapshot of the cache's counters.
+		struct Statistics
+		{
+			unsigned long long hit_count;
+			unsigned long long subpath_hit_count;
+			unsigned long long miss_count;
+			unsigned long long insertion_count;
+			unsigned long long eviction_count;
+			unsigned long long invalidation_count;
+			std::size_t entry_count;
+			std::size_t bytes_used;
+
+			//! \brief Returns the fraction of lookups answered from the cache.
+			inline double getHitRate() const
+			{
+				unsigned long long const hits = hit_count + subpath_hit_count;
+
+				return (hits + miss_count) ? static_cast<double>(hits) / (hits + miss_count) : 0.0;
+			}
+		};
+
+	private:
+		struct Entry
+		{
+			int start;
+			int goal;
+			unsigned int version;
+			std::size_t bytes;
+			std::atomic<bool> is_invalid;
+			std::vector<int> path;
+		};
+
+		typedef std::shared_ptr<Entry> EntryPointer;
+		typedef std::list<EntryPointer> EntryList;
+
+		// Where an entry's path crosses a tile.
+		struct Crossing
+		{
+			std::weak_ptr<Entry> entry;
+			std::size_t position;
+		};
+
+		struct Shard
+		{
+			std::mutex mutex;
+			EntryList entries;
+			std::unordered_map<unsigned long long, EntryList::iterator> lookup;
+			std::unordered_map<int, std::vector<Crossing> > crossings;
+			std::size_t bytes_used;
+		};
+
+		std::vector<Shard*> shards;
+		std::size_t shard_budget;
+		std::atomic<unsigned int> current_version;
+		std::atomic<unsigned int> oldest_valid_version;
+		std::atomic<unsigned long long> hit_count;
+		std::atomic<unsigned long long> subpath_hit_count;
+		std::atomic<unsigned long long> miss_count;
+		std::atomic<unsigned long long> insertion_count;
+		std::atomic<unsigned long long> eviction_count;
+		std::atomic<unsigned long long> invalidation_count;
+
+		PathCache(PathCache const&);
+		PathCache& operator=(PathCache const&);
+
+		Shard& getEntryShard(int start, int goal) const;
+		Shard& getTileShard(int tile) const;
+		bool isValid(Entry const& entry) const;
+		void synchronize(unsigned int version);
+		void addCrossings(EntryPointer const& entry);
+		void removeCrossings(Entry const& entry);
+		void erase(EntryPointer const& entry);
+		bool lookupSubpath(int start, int goal, std::vector<int>& path);
+
+	public:
+		//! \brief Constructs a cache that holds at most roughly <code>byte_budget</code> bytes
+		//! of paths, spread over <code>shard_count</code> independently locked shards.
+		DLLEXPORT explicit PathCache(std::size_t byte_budget, unsigned int shard_count = 16);
+
+		//! \brief Destroys the cache and every entry in it.
+		DLLEXPORT ~PathCache();
+
+		//! \brief Looks up the optimal path between the specified tiles.
+		//!
+		//! \param   start    the index of the start tile.
+		//! \param   goal     the index of the goal tile.
+		//! \param   version  the current version of the tile map.
+		//! \param   path     receives the path, goal first, if the lookup succeeds.
+		//! \return  <code>true</code> if the path was found, <code>false</code> otherwise.
+		DLLEXPORT bool lookup(int start, int goal, unsigned int version, std::vector<int>& path);
+
+		//! \brief Stores an optimal path, goal first, computed against the specified version
+		//! of the tile map.  Paths computed against an out-of-date version are ignored.
+		DLLEXPORT void insert(int start, int goal, unsigned int version, std::vector<int> const& path);
+
+		//! \brief Invalidates the entries affected by a single
+		//! <code>TileMap::setTileWeight()</code> call.
+		//!
+		//! \param   tile         the index of the changed tile.
+		//! \param   old_weight   the weight the tile had before the change.
+		//! \param   new_weight   the weight the tile has now.
+		//! \param   new_version  the version of the tile map after the change.
+		DLLEXPORT void onTileWeightChanged(int tile, unsigned char old_weight,
+		                                   unsigned char new_weight, unsigned int new_version);
+
+		//! \brief Discards every entry.  The counters are left untouched.
+		DLLEXPORT void clear();
+
+		//! \brief Returns a snapshot of the cache's counters.
+		DLLEXPORT Statistics getStatistics() const;
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,451 @@
+#include <chrono>
+
+#include "PathSearch.h"
+#include "PathCache.h"
+#include "ComponentIndex.h"
+#include "GridTopology.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	template <typename Counters>
+	BasicPathSearch<Counters>::BasicPathSearch()
+		: tile_map(0), nodes(), open(isCostlier), start_tile(0), goal_tile(0), generation(0)
+		, map_version(0), is_done(false), solution(), path_cache(0), component_index(0)
+		, peak_open_size(0), expansion_count(0), counters(), slice_monitor(), neighbor_kernel()
+	{
+	}
+
+	template <typename Counters>
+	BasicPathSearch<Counters>::~BasicPathSearch()
+	{
+		shutdown();
+	}
+
+	template <typename Counters>
+	bool BasicPathSearch<Counters>::isCostlier(SearchNode* const& lhs, SearchNode* const& rhs)
+	{
+		// Among equally promising nodes, prefer the one closest to the goal.
+		return (lhs->final_cost == rhs->final_cost)
+		     ? (lhs->given_cost < rhs->given_cost)
+		     : (rhs->final_cost < lhs->final_cost);
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::initialize(TileMap* map)
+	{
+		size_t const old_capacity = nodes.capacity();
+
+		tile_map = map;
+		nodes.clear();
+		nodes.resize(tile_map->getRowCount() * tile_map->getColumnCount());
+		generation = 0;
+
+		if (old_capacity < nodes.capacity())
+		{
+			counters.countAllocation((nodes.capacity() - old_capacity) * sizeof(SearchNode));
+		}
+	}
+
+	template <typename Counters>
+	typename BasicPathSearch<Counters>::SearchNode*
+		BasicPathSearch<Counters>::getNode(int row, int column, bool& is_new)
+	{
+		TileMapView const view = tile_map->getView();
+		int const index = view.getIndex(row, column);
+		SearchNode* node = &nodes[index];
+
+		// Nodes stamped by an earlier search have not been seen by this one.
+		is_new = (node->generation != generation);
+
+		if (is_new)
+		{
+			node->tile = view.getTile(index);
+			node->parent = 0;
+			node->generation = generation;
+			node->is_closed = false;
+		}
+
+		return node;
+	}
+
+	template <typename Counters>
+	double BasicPathSearch<Counters>::estimate(Tile const* tile)
+	{
+		typename Counters::Stopwatch stopwatch(counters, &SearchCounters::heuristic_nanoseconds);
+
+		return getGridDistance(tile_map->getTopology(), tile->getRow(), tile->getColumn(),
+		                       goal_tile->getRow(), goal_tile->getColumn());
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::enter(int start_row, int start_column, int goal_row,
+	                                      int goal_column)
+	{
+		TraceScope scope("enter");
+
+		if (nodes.size() != static_cast<size_t>(tile_map->getRowCount() * tile_map->getColumnCount()))
+		{
+			initialize(tile_map);
+		}
+
+		// Bump the stamp so that every node left over from the previous search reads as unseen.
+		if (!++generation)
+		{
+			nodes.assign(nodes.size(), SearchNode());
+			generation = 1;
+		}
+
+		// Only the hexagonal layout of the maps in Data has a kernel; see expand().
+		if ((tile_map->getTopology() == HEX_ODD_ROWS) && !neighbor_kernel.isCurrent(*tile_map))
+		{
+			neighbor_kernel.build(*tile_map);
+			counters.countAllocation(neighbor_kernel.getMemoryUsage());
+		}
+
+		neighbor_kernel.setGoal(goal_row, goal_column);
+		open.clear();
+		solution.clear();
+		start_tile = tile_map->getTile(start_row, start_column);
+		goal_tile = tile_map->getTile(goal_row, goal_column);
+		map_version = tile_map->getVersion();
+		is_done = false;
+		peak_open_size = 0;
+		expansion_count = 0;
+		counters.beginQuery();
+
+		int const start_index = start_row * tile_map->getColumnCount() + start_column;
+		int const goal_index = goal_row * tile_map->getColumnCount() + goal_column;
+
+		if (component_index && component_index->isUnreachable(start_index, goal_index))
+		{
+			is_done = true;
+			return;
+		}
+
+		if (path_cache)
+		{
+			vector<int> path;
+
+			if (path_cache->lookup(start_index, goal_index, map_version, path))
+			{
+				finishFromCache(path);
+				return;
+			}
+		}
+
+		bool is_new;
+		SearchNode* start_node = getNode(start_row, start_column, is_new);
+
+		start_node->given_cost = 0.0;
+		start_node->final_cost = estimate(start_tile);
+		open.push(start_node);
+		counters.countGeneration();
+		counters.countPush();
+	}
+
+	template <typename Counters>
+	inline void BasicPathSearch<Counters>::relax(SearchNode* node, int row, int column,
+	                                             double given_cost, double estimate)
+	{
+		bool is_new;
+		SearchNode* successor = getNode(row, column, is_new);
+
+		if (successor->is_closed)
+		{
+			// The heuristic is consistent, so a closed node already has its best cost.
+			return;
+		}
+		else if (is_new)
+		{
+			successor->given_cost = given_cost;
+			successor->final_cost = given_cost + estimate;
+			successor->parent = node;
+			open.push(successor);
+			counters.countGeneration();
+			counters.countPush();
+		}
+		else if (given_cost < successor->given_cost)
+		{
+			open.remove(successor);
+			successor->final_cost += given_cost - successor->given_cost;
+			successor->given_cost = given_cost;
+			successor->parent = node;
+			open.push(successor);
+			counters.countReopening();
+			counters.countRemoval();
+			counters.countPush();
+		}
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::expand(SearchNode* node, HexOddRowTopology)
+	{
+		typename Counters::Stopwatch stopwatch(counters, &SearchCounters::expansion_nanoseconds);
+		int const row = node->tile->getRow();
+		int const column = node->tile->getColumn();
+		HexNeighbors neighbors;
+
+		neighbor_kernel.evaluate(row, column, static_cast<unsigned int>(node->given_cost), neighbors);
+
+		for (int i = 0; i < neighbors.count; ++i)
+		{
+			int const* offset = HEX_DIRECTION_OFFSETS[row & 1][neighbors.directions[i]];
+
+			relax(node, row + offset[0], column + offset[1], neighbors.given_costs[i],
+			      neighbors.estimates[i]);
+		}
+	}
+
+	template <typename Counters>
+	template <typename Topology>
+	void BasicPathSearch<Counters>::expand(SearchNode* node, Topology)
+	{
+		typename Counters::Stopwatch stopwatch(counters, &SearchCounters::expansion_nanoseconds);
+		TileMapView const view = tile_map->getView();
+		int const row = node->tile->getRow();
+		int const column = node->tile->getColumn();
+		int const goal_row = goal_tile->getRow();
+		int const goal_column = goal_tile->getColumn();
+		int const (*offsets)[2] = Topology::getOffsets(row);
+
+		for (int direction = 0; direction < Topology::DIRECTION_COUNT; ++direction)
+		{
+			int const successor_row = row + offsets[direction][0];
+			int const successor_column = column + offsets[direction][1];
+			Tile const* const tile = view.getTile(successor_row, successor_column);
+
+			if (tile && tile->getWeight())
+			{
+				relax(node, successor_row, successor_column, node->given_cost + tile->getWeight(),
+				      Topology::getDistance(successor_row, successor_column, goal_row, goal_column));
+			}
+		}
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::update(long timeslice)
+	{
+		TraceScope scope("update", timeslice);
+
+		run(timeslice, 0);
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::updateExpansions(size_t expansion_budget)
+	{
+		TraceScope scope("updateExpansions", static_cast<long long>(expansion_budget));
+
+		if (expansion_budget)
+		{
+			run(0, expansion_budget);
+		}
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::run(long timeslice, size_t expansion_budget)
+	{
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			run(timeslice, expansion_budget, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			run(timeslice, expansion_budget, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			run(timeslice, expansion_budget, SquareEightTopology());
+			break;
+		default:
+			run(timeslice, expansion_budget, HexOddRowTopology());
+		}
+	}
+
+	template <typename Counters>
+	template <typename Topology>
+	void BasicPathSearch<Counters>::run(long timeslice, size_t expansion_budget, Topology)
+	{
+		// An expansion budget replaces the clock entirely, slice statistics included.
+		bool const is_timed = !expansion_budget;
+		chrono::steady_clock::time_point const start
+			= is_timed ? chrono::steady_clock::now() : chrono::steady_clock::time_point();
+		chrono::steady_clock::time_point const deadline = start + chrono::milliseconds(timeslice);
+		size_t const poll_interval = slice_monitor.getPollInterval();
+		size_t until_poll = poll_interval;
+		size_t slice_expansion_count = 0;
+		bool is_deadline_reached = false;
+
+		while (!is_done)
+		{
+			if (open.empty())
+			{
+				// Every reachable tile has been closed without finding the goal.
+				is_done = true;
+				break;
+			}
+
+			SearchNode* node = open.front();
+
+			open.pop();
+			counters.countPop();
+
+			if (node->tile == goal_tile)
+			{
+				buildSolution(node);
+				is_done = true;
+				break;
+			}
+
+			node->is_closed = true;
+			expand(node, Topology());
+			++expansion_count;
+			++slice_expansion_count;
+			counters.countExpansion();
+
+			if (peak_open_size < open.size())
+			{
+				// The open list is rebuilt by every search, so each new peak is fresh memory.
+				counters.countAllocation((open.size() - peak_open_size) * sizeof(SearchNode*));
+				counters.countOpenSize(open.size());
+				peak_open_size = open.size();
+			}
+
+			if (!is_timed)
+			{
+				if (!--expansion_budget)
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			if (!timeslice)
+			{
+				break;
+			}
+
+			if (--until_poll)
+			{
+				continue;
+			}
+
+			until_poll = poll_interval;
+
+			if (deadline <= chrono::steady_clock::now())
+			{
+				is_deadline_reached = true;
+				break;
+			}
+		}
+
+		if (!is_timed)
+		{
+			return;
+		}
+
+		slice_monitor.recordSlice(
+			timeslice
+		  , chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()
+		  , slice_expansion_count
+		  , is_deadline_reached
+		);
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::buildSolution(SearchNode const* node)
+	{
+		typename Counters::Stopwatch stopwatch(counters, &SearchCounters::reconstruction_nanoseconds);
+		size_t const old_capacity = solution.capacity();
+
+		for (; node; node = node->parent)
+		{
+			solution.push_back(node->tile);
+		}
+
+		if (old_capacity < solution.capacity())
+		{
+			counters.countAllocation((solution.capacity() - old_capacity) * sizeof(Tile const*));
+		}
+
+		if (path_cache)
+		{
+			vector<int> path(solution.size());
+
+			for (size_t i = 0; i < solution.size(); ++i)
+			{
+				path[i] = solution[i]->getRow() * tile_map->getColumnCount()
+				        + solution[i]->getColumn();
+			}
+
+			path_cache->insert(path.back(), path.front(), map_version, path);
+		}
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::finishFromCache(vector<int> const& path)
+	{
+		typename Counters::Stopwatch stopwatch(counters, &SearchCounters::reconstruction_nanoseconds);
+		int const column_count = tile_map->getColumnCount();
+
+		solution.resize(path.size());
+
+		for (size_t i = 0; i < path.size(); ++i)
+		{
+			solution[i] = tile_map->getTile(path[i] / column_count, path[i] % column_count);
+		}
+
+		is_done = true;
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::exit()
+	{
+		TraceScope scope("exit");
+
+		open.clear();
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::shutdown()
+	{
+		open.clear();
+		solution.clear();
+		vector<SearchNode>().swap(nodes);
+		neighbor_kernel = HexNeighborKernel();
+		tile_map = 0;
+		is_done = false;
+	}
+
+	template <typename Counters>
+	bool BasicPathSearch<Counters>::isDone() const
+	{
+		return is_done;
+	}
+
+	template <typename Counters>
+	vector<Tile const*> const BasicPathSearch<Counters>::getSolution() const
+	{
+		TraceScope scope("getSolution");
+
+		return solution;
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::setPathCache(PathCache* cache)
+	{
+		path_cache = cache;
+	}
+
+	template <typename Counters>
+	void BasicPathSearch<Counters>::setComponentIndex(ComponentIndex const* index)
+	{
+		component_index = index;
+	}
+
+	// The definitions stay in this file; these are the only policies the library ships.
+	template class BasicPathSearch<NoSearchCounters>;
+	template class BasicPathSearch<RecordingSearchCounters>;
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,229 @@
+//! \file PathSearch.h
+//! \brief Defines the <code>fullsail_ai::algorithms::PathSearch</code> class.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../platform.h"
+#include "../PriorityQueue.h"
+#include "../TileLibrary/TileMap.h"
+#include "GridTopology.h"
+#include "HexNeighborKernel.h"
+#include "PathView.h"
+#include "SearchCounters.h"
+#include "SliceStatistics.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	class ComponentIndex;
+	class PathCache;
+
+	//! \brief Time-sliced A* search over a tile map of any <code>TileTopology</code>.
+	//!
+	//! Entering a tile costs its weight, so the cost of a path is the sum of the weights of
+	//! every tile on it except the start.  Since every passable tile weighs at least one, the
+	//! number of steps between two tiles is an admissible and consistent heuristic.
+	//!
+	//! The search loop is compiled once per topology policy (see GridTopology.h) and picked
+	//! once per call to <code>update()</code>.  On <code>HEX_ODD_ROWS</code> maps, neighbours
+	//! are evaluated by a <code>HexNeighborKernel</code>, which keeps a copy of the tile
+	//! weights and refreshes it in <code>enter()</code> whenever the map has changed.
+	//!
+	//! \tparam Counters  a counter policy, either <code>NoSearchCounters</code> or
+	//!                    <code>RecordingSearchCounters</code>.  Use the
+	//!                    <code>PathSearch</code> and <code>InstrumentedPathSearch</code>
+	//!                    typedefs rather than naming this template.
+	template <typename Counters>
+	class BasicPathSearch
+	{
+		struct SearchNode
+		{
+			Tile const* tile;
+			SearchNode* parent;
+			double given_cost;
+			double final_cost;
+			unsigned int generation;
+			bool is_closed;
+		};
+
+		TileMap* tile_map;
+		std::vector<SearchNode> nodes;
+		PriorityQueue<SearchNode*> open;
+		Tile const* start_tile;
+		Tile const* goal_tile;
+		unsigned int generation;
+		unsigned int map_version;
+		bool is_done;
+		std::vector<Tile const*> solution;
+		PathCache* path_cache;
+		ComponentIndex const* component_index;
+		std::size_t peak_open_size;
+		std::size_t expansion_count;
+		Counters counters;
+		SliceMonitor slice_monitor;
+		HexNeighborKernel neighbor_kernel;
+
+		static bool isCostlier(SearchNode* const& lhs, SearchNode* const& rhs);
+
+		SearchNode* getNode(int row, int column, bool& is_new);
+		double estimate(Tile const* tile);
+		void relax(SearchNode* node, int row, int column, double given_cost, double estimate);
+		void expand(SearchNode* node, HexOddRowTopology);
+		template <typename Topology>
+		void expand(SearchNode* node, Topology);
+		void buildSolution(SearchNode const* node);
+		void finishFromCache(std::vector<int> const& path);
+		void run(long timeslice, std::size_t expansion_budget);
+		template <typename Topology>
+		void run(long timeslice, std::size_t expansion_budget, Topology);
+
+	public:
+		//! \brief Constructs a search that is not yet bound to a tile map.
+		DLLEXPORT BasicPathSearch();
+
+		//! \brief Releases all memory held by the search.
+		DLLEXPORT ~BasicPathSearch();
+
+		//! \brief Binds the search to the specified tile map and allocates its per-tile nodes.
+		//!
+		//! Call this again whenever the tile map is reloaded.
+		DLLEXPORT void initialize(TileMap* tile_map);
+
+		//! \brief Begins a new search between the specified locations.
+		//!
+		//! If a path cache is attached and already holds the answer, or a current component
+		//! index shows the goal to be unreachable, the search finishes immediately.
+		DLLEXPORT void enter(int start_row, int start_column, int goal_row, int goal_column);
+
+		//! \brief Runs the search for roughly <code>timeslice</code> milliseconds, or for a
+		//! single expansion if <code>timeslice</code> is zero.
+		//!
+		//! The clock is read only every <code>getPollInterval()</code> expansions, so the call
+		//! may overrun its budget by up to the overrun tolerance.
+		DLLEXPORT void update(long timeslice);
+
+		//! \brief Runs the search for at most <code>expansion_budget</code> expansions without
+		//! reading the clock, so the same inputs always make the same progress.
+		DLLEXPORT void updateExpansions(std::size_t expansion_budget);
+
+		//! \brief Cleans up the open list of the current search.
+		//!
+		//! <code>isDone()</code> keeps reporting the outcome of the search that was exited.
+		DLLEXPORT void exit();
+
+		//! \brief Releases the memory allocated by <code>initialize()</code>.
+		DLLEXPORT void shutdown();
+
+		//! \brief Returns <code>true</code> if the current search has either found the goal or
+		//! proven it unreachable, <code>false</code> otherwise.
+		DLLEXPORT bool isDone() const;
+
+		//! \brief Returns the path found by the current search, goal first and start last, or
+		//! an empty vector if the goal is unreachable.
+		DLLEXPORT std::vector<Tile const*> const getSolution() const;
+
+		//! \brief Returns the same path as <code>getSolution()</code> without copying it.
+		//!
+		//! The view stays valid until the next call to <code>enter()</code> or
+		//! <code>shutdown()</code>.
+		inline PathView getSolutionView() const
+		{
+			return PathView(solution);
+		}
+
+		//! \brief Attaches a cache that is consulted by <code>enter()</code> and filled in as
+		//! searches complete, or detaches the cache if <code>NULL</code>.
+		DLLEXPORT void setPathCache(PathCache* path_cache);
+
+		//! \brief Attaches an index that <code>enter()</code> consults to reject unreachable
+		//! goals without searching, or detaches the index if <code>NULL</code>.
+		DLLEXPORT void setComponentIndex(ComponentIndex const* component_index);
+
+		//! \brief Returns the number of bytes currently held by the per-tile nodes, the copy of
+		//! the weights and the open list.
+		inline std::size_t getMemoryUsage() const
+		{
+			return nodes.capacity() * sizeof(SearchNode) + neighbor_kernel.getMemoryUsage()
+			     + open.size() * sizeof(SearchNode*);
+		}
+
+		//! \brief Returns the largest value <code>getMemoryUsage()</code> has reached since the
+		//! last call to <code>enter()</code>.
+		inline std::size_t getPeakMemoryUsage() const
+		{
+			return nodes.capacity() * sizeof(SearchNode) + neighbor_kernel.getMemoryUsage()
+			     + peak_open_size * sizeof(SearchNode*);
+		}
+
+		//! \brief Returns the number of nodes expanded since the last call to <code>enter()</code>.
+		inline std::size_t getExpansionCount() const
+		{
+			return expansion_count;
+		}
+
+		//! \brief Returns the counters of the current or most recent search.
+		//!
+		//! All zero unless the counter policy records them.
+		inline SearchCounters getCounters() const
+		{
+			return counters.getQuery();
+		}
+
+		//! \brief Returns the counters of every search since construction or the last call to
+		//! <code>resetCumulativeCounters()</code>, the current one included.
+		inline SearchCounters getCumulativeCounters() const
+		{
+			return counters.getCumulative();
+		}
+
+		//! \brief Sets every counter returned by <code>getCumulativeCounters()</code> back to zero.
+		inline void resetCumulativeCounters()
+		{
+			counters.resetCumulative();
+		}
+
+		//! \brief Sets how many nanoseconds <code>update()</code> may overrun its time slice
+		//! before it starts reading the clock more often.
+		inline void setOverrunTolerance(long long nanoseconds)
+		{
+			slice_monitor.setOverrunTolerance(nanoseconds);
+		}
+
+		//! \brief Returns the number of expansions <code>update()</code> currently runs between
+		//! clock reads.
+		inline std::size_t getPollInterval() const
+		{
+			return slice_monitor.getPollInterval();
+		}
+
+		//! \brief Returns the nanoseconds by which every call to <code>update()</code> that ran
+		//! out of time overran its slice, since construction or the last call to
+		//! <code>resetSliceStatistics()</code>.
+		inline Histogram const& getOverrunHistogram() const
+		{
+			return slice_monitor.getOverruns();
+		}
+
+		//! \brief Returns the number of nodes expanded by every call to <code>update()</code>
+		//! since construction or the last call to <code>resetSliceStatistics()</code>.
+		inline Histogram const& getSliceExpansionHistogram() const
+		{
+			return slice_monitor.getExpansions();
+		}
+
+		//! \brief Empties both slice histograms.
+		inline void resetSliceStatistics()
+		{
+			slice_monitor.clear();
+		}
+	};
+
+	//! \brief The A* engine the application times and the tools run.  It pays nothing for
+	//! counters.
+	typedef BasicPathSearch<NoSearchCounters> PathSearch;
+
+	//! \brief The same A* engine, with every counter in <code>SearchCounters</code> recorded.
+	//! The application runs it once, untimed, after a timed run.
+	typedef BasicPathSearch<RecordingSearchCounters> InstrumentedPathSearch;
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,102 @@
+//! \file PathView.h
+//! \brief Defines the <code>fullsail_ai::algorithms::PathView</code> class.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../TileLibrary/Tile.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Non-owning, read-only view of a path, goal first and start last, as every engine
+	//! returns it.
+	//!
+	//! The engines hand out a view of the path they hold with <code>getSolutionView()</code>
+	//! instead of copying it.  Such a view stays valid until the next call to
+	//! <code>enter()</code> or <code>shutdown()</code> on the same engine; copy it with
+	//! <code>toVector()</code> to keep it longer.  A <code>std::vector</code> converts to a view
+	//! of its elements, so functions taking a view take vectors as well.
+	class PathView
+	{
+		Tile const* const* tiles;
+		std::size_t count;
+
+	public:
+		//! \brief Iterates over the tiles, goal first.
+		typedef Tile const* const* const_iterator;
+
+		//! \brief Constructs a view of an empty path.
+		inline PathView() : tiles(0), count(0)
+		{
+		}
+
+		//! \brief Constructs a view of the specified number of tiles.
+		inline PathView(Tile const* const* path_tiles, std::size_t tile_count)
+			: tiles(path_tiles), count(tile_count)
+		{
+		}
+
+		//! \brief Constructs a view of the tiles held by the specified vector, which stays valid
+		//! until the vector is changed.
+		inline PathView(std::vector<Tile const*> const& path)
+			: tiles(path.empty() ? 0 : &path[0]), count(path.size())
+		{
+		}
+
+		//! \brief Returns <code>true</code> if the path has no tiles, <code>false</code>
+		//! otherwise.
+		inline bool empty() const
+		{
+			return !count;
+		}
+
+		//! \brief Returns the number of tiles on the path, start and goal included.
+		inline std::size_t size() const
+		{
+			return count;
+		}
+
+		//! \brief Returns the tile at the specified position, the goal being at zero.
+		inline Tile const* operator[](std::size_t index) const
+		{
+			return tiles[index];
+		}
+
+		//! \brief Returns the goal.
+		//!
+		//! \pre
+		//!   - <code>! empty()</code>
+		inline Tile const* front() const
+		{
+			return tiles[0];
+		}
+
+		//! \brief Returns the start.
+		//!
+		//! \pre
+		//!   - <code>! empty()</code>
+		inline Tile const* back() const
+		{
+			return tiles[count - 1];
+		}
+
+		//! \brief Returns an iterator to the goal.
+		inline const_iterator begin() const
+		{
+			return tiles;
+		}
+
+		//! \brief Returns an iterator past the start.
+		inline const_iterator end() const
+		{
+			return tiles + count;
+		}
+
+		//! \brief Returns a copy of the path, which stays valid for as long as the caller keeps it.
+		inline std::vector<Tile const*> toVector() const
+		{
+			return std::vector<Tile const*>(begin(), end());
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,572 @@
+#include <chrono>
+
+#include "SMAStarSearch.h"
+#include "ComponentIndex.h"
+#include "GridTopology.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	static unsigned int const INFINITE_COST = ~0u;
+
+	// Generations allowed per budgeted node without the lowest open f-cost rising.
+	static size_t const STALL_FACTOR = 64;
+
+	// Rough per-node cost of the open and leaf sets (tree nodes) and the tile lookup (hash node
+	// plus bucket), on top of the pooled node itself.
+	static size_t const BOOKKEEPING_BYTES_PER_NODE
+		= 2 * (sizeof(pair<pair<unsigned int, int>, int>) + 4 * sizeof(void*))
+		+ sizeof(pair<int, int>) + 3 * sizeof(void*);
+
+	SMAStarSearch::SMAStarSearch(size_t node_budget)
+		: tile_map(0), pool((node_budget < 2) ? 2 : node_budget), free_nodes(), lookup(), open()
+		, leaves(), root(-1), goal_index(-1), goal_row(0), goal_column(0), is_done(false)
+		, is_out_of_memory(false), lower_bound(0), stalled_count(0), all_directions(0), solution()
+		, component_index(0), peak_node_count(0), expansion_count(0)
+	{
+		free_nodes.reserve(pool.size());
+		lookup.reserve(pool.size());
+	}
+
+	SMAStarSearch::~SMAStarSearch()
+	{
+		shutdown();
+	}
+
+	size_t SMAStarSearch::getNodeBudget(size_t byte_budget)
+	{
+		return byte_budget / (sizeof(Node) + BOOKKEEPING_BYTES_PER_NODE);
+	}
+
+	size_t SMAStarSearch::getPeakMemoryUsage() const
+	{
+		return pool.capacity() * sizeof(Node) + peak_node_count * BOOKKEEPING_BYTES_PER_NODE;
+	}
+
+	void SMAStarSearch::initialize(TileMap* map)
+	{
+		tile_map = map;
+	}
+
+	SMAStarSearch::NodeKey SMAStarSearch::getKey(int node) const
+	{
+		return NodeKey(make_pair(pool[node].final_cost, -pool[node].depth), node);
+	}
+
+	void SMAStarSearch::setOpen(int node, bool is_open)
+	{
+		if (pool[node].is_open != is_open)
+		{
+			if (is_open)
+			{
+				open.insert(getKey(node));
+			}
+			else
+			{
+				open.erase(getKey(node));
+			}
+
+			pool[node].is_open = is_open;
+		}
+	}
+
+	void SMAStarSearch::setLeaf(int node, bool is_leaf)
+	{
+		if (pool[node].is_leaf != is_leaf)
+		{
+			if (is_leaf)
+			{
+				leaves.insert(getKey(node));
+			}
+			else
+			{
+				leaves.erase(getKey(node));
+			}
+
+			pool[node].is_leaf = is_leaf;
+		}
+	}
+
+	template <typename Topology>
+	inline unsigned int SMAStarSearch::estimate(int tile, Topology) const
+	{
+		int const column_count = tile_map->getColumnCount();
+
+		return Topology::getDistance(tile / column_count, tile % column_count, goal_row,
+		                             goal_column);
+	}
+
+	int SMAStarSearch::getChild(int node, int direction) const
+	{
+		return pool[node].children[direction];
+	}
+
+	unsigned int SMAStarSearch::getBestChildCost(int node) const
+	{
+		unsigned int best = pool[node].forgotten_cost;
+
+		for (int direction = 0; direction < MAX_DIRECTION_COUNT; ++direction)
+		{
+			if (pool[node].child_mask & (1 << direction))
+			{
+				unsigned int const cost = pool[getChild(node, direction)].final_cost;
+
+				if (cost < best)
+				{
+					best = cost;
+				}
+			}
+		}
+
+		return best;
+	}
+
+	int SMAStarSearch::allocate()
+	{
+		if (free_nodes.empty())
+		{
+			return -1;
+		}
+
+		int const node = free_nodes.back();
+
+		free_nodes.pop_back();
+
+		if (peak_node_count < pool.size() - free_nodes.size())
+		{
+			peak_node_count = pool.size() - free_nodes.size();
+		}
+
+		return node;
+	}
+
+	void SMAStarSearch::release(int node)
+	{
+		setOpen(node, false);
+		setLeaf(node, false);
+
+		unordered_map<int, int>::iterator const entry = lookup.find(pool[node].tile);
+
+		if ((entry != lookup.end()) && (entry->second == node))
+		{
+			lookup.erase(entry);
+		}
+
+		free_nodes.push_back(node);
+
+		if (node == root)
+		{
+			root = -1;
+		}
+	}
+
+	void SMAStarSearch::forget(int node)
+	{
+		int const parent = pool[node].parent;
+		unsigned char const bit = static_cast<unsigned char>(1 << pool[node].direction);
+		unsigned int const cost = pool[node].final_cost;
+
+		release(node);
+		pool[parent].child_mask &= ~bit;
+		pool[parent].forgotten_mask |= bit;
+
+		if (cost < pool[parent].forgotten_cost)
+		{
+			pool[parent].forgotten_cost = cost;
+		}
+
+		onSuccessorsChanged(parent);
+	}
+
+	void SMAStarSearch::close(int node, int direction)
+	{
+		unsigned char const bit = static_cast<unsigned char>(1 << direction);
+
+		pool[node].closed_mask |= bit;
+
+		if (pool[node].forgotten_mask & bit)
+		{
+			pool[node].forgotten_mask &= ~bit;
+
+			if (!pool[node].forgotten_mask)
+			{
+				pool[node].forgotten_cost = INFINITE_COST;
+			}
+		}
+
+		onSuccessorsChanged(node);
+	}
+
+	void SMAStarSearch::onSuccessorsChanged(int node)
+	{
+		Node& current = pool[node];
+		unsigned char const pending = all_directions & ~(current.child_mask | current.closed_mask);
+
+		if (pending)
+		{
+			// Successors remain to be generated, so the node belongs on the open list.  One that
+			// was fully expanded before re-enters with the best cost among its successors.
+			if (!current.is_open)
+			{
+				unsigned int const best = getBestChildCost(node);
+
+				if (current.final_cost < best)
+				{
+					current.final_cost = best;
+
+					if (current.parent != -1)
+					{
+						backUp(current.parent);
+					}
+				}
+
+				setOpen(node, true);
+			}
+
+			setLeaf(node, !current.child_mask);
+		}
+		else if (current.child_mask)
+		{
+			setOpen(node, false);
+			setLeaf(node, false);
+			backUp(node);
+		}
+		else
+		{
+			// A dead end.  Drop it and close the direction that led here, which may in turn
+			// leave its parent a dead end.
+			int const parent = current.parent;
+			int const direction = current.direction;
+
+			release(node);
+
+			if (parent != -1)
+			{
+				pool[parent].child_mask &= static_cast<unsigned char>(~(1 << direction));
+				close(parent, direction);
+			}
+		}
+	}
+
+	void SMAStarSearch::backUp(int node)
+	{
+		for (; (node != -1) && !pool[node].is_open; node = pool[node].parent)
+		{
+			unsigned int const best = getBestChildCost(node);
+
+			if (best <= pool[node].final_cost)
+			{
+				break;
+			}
+
+			// Closed interior nodes are in neither set, so no re-keying is needed.
+			pool[node].final_cost = best;
+		}
+	}
+
+	void SMAStarSearch::enter(int start_row, int start_column, int goal_r, int goal_c)
+	{
+		TraceScope scope("enter");
+
+		exit();
+		solution.clear();
+		goal_row = goal_r;
+		goal_column = goal_c;
+		goal_index = goal_row * tile_map->getColumnCount() + goal_column;
+		is_done = false;
+		is_out_of_memory = false;
+		stalled_count = 0;
+		all_directions = static_cast<unsigned char>((1 << getDirectionCount(tile_map->getTopology()))
+		                                            - 1);
+		peak_node_count = 0;
+		expansion_count = 0;
+		root = allocate();
+
+		Node& node = pool[root];
+
+		node.tile = start_row * tile_map->getColumnCount() + start_column;
+		node.parent = -1;
+		node.depth = 0;
+		node.given_cost = 0;
+		node.final_cost = getGridDistance(tile_map->getTopology(), start_row, start_column,
+		                                  goal_row, goal_column);
+		node.forgotten_cost = INFINITE_COST;
+		node.direction = 0;
+		node.child_mask = node.closed_mask = node.forgotten_mask = 0;
+		node.is_open = node.is_leaf = false;
+		lower_bound = node.final_cost;
+		lookup[node.tile] = root;
+		setOpen(root, true);
+		setLeaf(root, true);
+
+		if (component_index && component_index->isUnreachable(node.tile, goal_index))
+		{
+			is_done = true;
+		}
+	}
+
+	template <typename Topology>
+	bool SMAStarSearch::step(Topology)
+	{
+		TileMapView const view = tile_map->getView();
+		int const column_count = view.getColumnCount();
+
+		for (;;)
+		{
+			if (open.empty())
+			{
+				return is_done = true;
+			}
+
+			int const best = open.begin()->second;
+
+			if (pool[best].tile == goal_index)
+			{
+				for (int node = best; node != -1; node = pool[node].parent)
+				{
+					solution.push_back(tile_map->getTile(pool[node].tile / column_count,
+					                                     pool[node].tile % column_count));
+				}
+
+				return is_done = true;
+			}
+
+			if (lower_bound < pool[best].final_cost)
+			{
+				lower_bound = pool[best].final_cost;
+				stalled_count = 0;
+			}
+			else if (pool.size() * STALL_FACTOR < ++stalled_count)
+			{
+				is_out_of_memory = true;
+				return is_done = true;
+			}
+
+			unsigned char const pending
+				= all_directions & ~(pool[best].child_mask | pool[best].closed_mask);
+			unsigned char candidates = pending & ~pool[best].forgotten_mask;
+
+			// Once only forgotten successors are left, the node is worth no less than the best of
+			// them.  Raise it to that cost first, and regenerate one only if it is still the best.
+			if (!candidates)
+			{
+				unsigned int const backed_up_cost = getBestChildCost(best);
+
+				if (pool[best].final_cost < backed_up_cost)
+				{
+					setOpen(best, false);
+					setLeaf(best, false);
+					pool[best].final_cost = backed_up_cost;
+					setOpen(best, true);
+					setLeaf(best, !pool[best].child_mask);
+
+					if (pool[best].parent != -1)
+					{
+						backUp(pool[best].parent);
+					}
+
+					continue;
+				}
+
+				candidates = pending;
+			}
+
+			int direction = 0;
+
+			while (!(candidates & (1 << direction)))
+			{
+				++direction;
+			}
+
+			Tile const* neighbor = getGridNeighbor<Topology>(view, pool[best].tile / column_count,
+			                                                pool[best].tile % column_count,
+			                                                direction);
+
+			if (!neighbor || !neighbor->getWeight())
+			{
+				close(best, direction);
+				continue;
+			}
+
+			int const neighbor_index = neighbor->getRow() * column_count + neighbor->getColumn();
+			unsigned int const given_cost = pool[best].given_cost + neighbor->getWeight();
+			unordered_map<int, int>::iterator const existing = lookup.find(neighbor_index);
+
+			// Ancestors always cost less, so this also stops the search from doubling back.  A
+			// costlier copy is left alone, since the costs backed up beneath it are still sound.
+			if ((existing != lookup.end()) && (pool[existing->second].given_cost <= given_cost))
+			{
+				close(best, direction);
+				continue;
+			}
+
+			int child = allocate();
+
+			if (child == -1)
+			{
+				// Make room by forgetting the worst leaf, never the node being expanded and never
+				// the root.  If nothing else is left, the path is longer than the budget.
+				set<NodeKey>::reverse_iterator victim = leaves.rbegin();
+
+				while ((victim != leaves.rend())
+				       && ((victim->second == best) || (victim->second == root)))
+				{
+					++victim;
+				}
+
+				if (victim == leaves.rend())
+				{
+					is_out_of_memory = true;
+					close(best, direction);
+					continue;
+				}
+
+				forget(victim->second);
+				child = allocate();
+			}
+
+			unsigned char const bit = static_cast<unsigned char>(1 << direction);
+			Node& parent = pool[best];
+			Node& node = pool[child];
+			unsigned int const final_cost = given_cost + estimate(neighbor_index, Topology());
+
+			node.tile = neighbor_index;
+			node.parent = best;
+			node.depth = parent.depth + 1;
+			node.given_cost = given_cost;
+			node.final_cost = (final_cost < parent.final_cost) ? parent.final_cost : final_cost;
+			node.forgotten_cost = INFINITE_COST;
+			node.direction = static_cast<unsigned char>(direction);
+			node.child_mask = node.closed_mask = node.forgotten_mask = 0;
+			node.is_open = node.is_leaf = false;
+
+			// A regenerated successor is known to cost at least as much as when it was forgotten.
+			if (parent.forgotten_mask & bit)
+			{
+				if (node.final_cost < parent.forgotten_cost)
+				{
+					node.final_cost = parent.forgotten_cost;
+				}
+
+				parent.forgotten_mask &= ~bit;
+
+				if (!parent.forgotten_mask)
+				{
+					parent.forgotten_cost = INFINITE_COST;
+				}
+			}
+
+			parent.children[direction] = child;
+			parent.child_mask |= bit;
+			lookup[neighbor_index] = child;
+			setOpen(child, true);
+			setLeaf(child, true);
+			onSuccessorsChanged(best);
+			++expansion_count;
+			return false;
+		}
+	}
+
+	void SMAStarSearch::update(long timeslice)
+	{
+		TraceScope scope("update", timeslice);
+
+		run(timeslice, 0);
+	}
+
+	void SMAStarSearch::updateExpansions(size_t expansion_budget)
+	{
+		TraceScope scope("updateExpansions", static_cast<long long>(expansion_budget));
+
+		if (expansion_budget)
+		{
+			run(0, expansion_budget);
+		}
+	}
+
+	void SMAStarSearch::run(long timeslice, size_t expansion_budget)
+	{
+		switch (tile_map->getTopology())
+		{
+		case HEX_EVEN_ROWS:
+			run(timeslice, expansion_budget, HexEvenRowTopology());
+			break;
+		case SQUARE_FOUR:
+			run(timeslice, expansion_budget, SquareFourTopology());
+			break;
+		case SQUARE_EIGHT:
+			run(timeslice, expansion_budget, SquareEightTopology());
+			break;
+		default:
+			run(timeslice, expansion_budget, HexOddRowTopology());
+		}
+	}
+
+	template <typename Topology>
+	void SMAStarSearch::run(long timeslice, size_t expansion_budget, Topology)
+	{
+		// An expansion budget replaces the clock entirely.
+		chrono::steady_clock::time_point const deadline = expansion_budget
+			? chrono::steady_clock::time_point()
+			: chrono::steady_clock::now() + chrono::milliseconds(timeslice);
+
+		while (!is_done && !step(Topology()))
+		{
+			if (expansion_budget ? !--expansion_budget
+			                     : (!timeslice || (deadline <= chrono::steady_clock::now())))
+			{
+				break;
+			}
+		}
+	}
+
+	void SMAStarSearch::exit()
+	{
+		TraceScope scope("exit");
+
+		free_nodes.clear();
+
+		for (size_t i = pool.size(); i--; )
+		{
+			free_nodes.push_back(static_cast<int>(i));
+		}
+
+		lookup.clear();
+		open.clear();
+		leaves.clear();
+		root = -1;
+	}
+
+	void SMAStarSearch::shutdown()
+	{
+		exit();
+		solution.clear();
+		tile_map = 0;
+		is_done = false;
+		is_out_of_memory = false;
+	}
+
+	bool SMAStarSearch::isDone() const
+	{
+		return is_done;
+	}
+
+	bool SMAStarSearch::isOutOfMemory() const
+	{
+		return is_out_of_memory;
+	}
+
+	vector<Tile const*> const SMAStarSearch::getSolution() const
+	{
+		TraceScope scope("getSolution");
+
+		return solution;
+	}
+
+	void SMAStarSearch::setComponentIndex(ComponentIndex const* index)
+	{
+		component_index = index;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,185 @@
+//! \file SMAStarSearch.h
+//! \brief Defines the <code>fullsail_ai::algorithms::SMAStarSearch</code> class.
+#pragma once
+
+#include <cstddef>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "GridTopology.h"
+#include "PathView.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	class ComponentIndex;
+
+	//! \brief Time-sliced simplified memory-bounded A* (SMA*) with a hard node budget.
+	//!
+	//! All search nodes come from a pool allocated up front, so a query can never hold more
+	//! than the budgeted number of nodes no matter how long it is.  Successors are generated
+	//! one at a time.  When the pool runs dry, the shallowest leaf with the highest f-cost is
+	//! forgotten and its f-cost is backed up into its parent, which regenerates it later if it
+	//! becomes promising again.  A successor is pruned when a node already held for its tile
+	//! was reached at no greater cost.
+	//!
+	//! The path returned is optimal whenever the budget is large enough to hold it.  If it is
+	//! not, branches that do not fit are given up, <code>isOutOfMemory()</code> returns
+	//! <code>true</code>, and the path returned, if any, is the best one that fit.  Pruning
+	//! duplicates depends on which nodes are held, so a budget well below the number of nodes
+	//! A* would visit can make the search churn through the same f-cost forever; it gives up
+	//! and reports running out of memory once the lowest f-cost on the open list has not risen
+	//! for many times the budget in generated nodes.  Costs and the heuristic are the same as
+	//! for <code>PathSearch</code>.
+	class SMAStarSearch
+	{
+		struct Node
+		{
+			int tile;
+			int parent;
+			int depth;
+			int children[MAX_DIRECTION_COUNT];
+			unsigned int given_cost;
+			unsigned int final_cost;
+			unsigned int forgotten_cost;
+			unsigned char direction;
+			unsigned char child_mask;
+			unsigned char closed_mask;
+			unsigned char forgotten_mask;
+			bool is_open;
+			bool is_leaf;
+		};
+
+		// Ordered by f-cost, then deepest first, then by node index.
+		typedef std::pair<std::pair<unsigned int, int>, int> NodeKey;
+
+		TileMap* tile_map;
+		std::vector<Node> pool;
+		std::vector<int> free_nodes;
+		std::unordered_map<int, int> lookup;
+		std::set<NodeKey> open;
+		std::set<NodeKey> leaves;
+		int root;
+		int goal_index;
+		int goal_row;
+		int goal_column;
+		bool is_done;
+		bool is_out_of_memory;
+		unsigned int lower_bound;
+		std::size_t stalled_count;
+		unsigned char all_directions;
+		std::vector<Tile const*> solution;
+		ComponentIndex const* component_index;
+		std::size_t peak_node_count;
+		std::size_t expansion_count;
+
+		NodeKey getKey(int node) const;
+		void setOpen(int node, bool is_open);
+		void setLeaf(int node, bool is_leaf);
+		template <typename Topology>
+		unsigned int estimate(int tile, Topology) const;
+		unsigned int getBestChildCost(int node) const;
+		int getChild(int node, int direction) const;
+		int allocate();
+		void release(int node);
+		void forget(int node);
+		void close(int node, int direction);
+		void onSuccessorsChanged(int node);
+		void backUp(int node);
+		template <typename Topology>
+		bool step(Topology);
+		void run(long timeslice, std::size_t expansion_budget);
+		template <typename Topology>
+		void run(long timeslice, std::size_t expansion_budget, Topology);
+
+	public:
+		//! \brief Constructs a search that never holds more than <code>node_budget</code>
+		//! nodes.  The budget is raised to two if it is smaller.
+		DLLEXPORT explicit SMAStarSearch(std::size_t node_budget);
+
+		//! \brief Releases all memory held by the search.
+		DLLEXPORT ~SMAStarSearch();
+
+		//! \brief Returns the number of nodes that fit in the specified number of bytes,
+		//! counting the node pool and the bookkeeping that indexes it.
+		DLLEXPORT static std::size_t getNodeBudget(std::size_t byte_budget);
+
+		//! \brief Binds the search to the specified tile map.
+		DLLEXPORT void initialize(TileMap* tile_map);
+
+		//! \brief Begins a new search between the specified locations.
+		//!
+		//! If a current component index shows the goal to be unreachable, the search finishes
+		//! immediately.
+		DLLEXPORT void enter(int start_row, int start_column, int goal_row, int goal_column);
+
+		//! \brief Runs the search for roughly <code>timeslice</code> milliseconds, or until it
+		//! generates a single node if <code>timeslice</code> is zero.
+		DLLEXPORT void update(long timeslice);
+
+		//! \brief Runs the search until it has generated at most <code>expansion_budget</code>
+		//! nodes, without reading the clock, so the same inputs always make the same progress.
+		DLLEXPORT void updateExpansions(std::size_t expansion_budget);
+
+		//! \brief Returns every node of the current search to the pool.
+		//!
+		//! <code>isDone()</code> keeps reporting the outcome of the search that was exited.
+		DLLEXPORT void exit();
+
+		//! \brief Unbinds the search from its tile map.
+		DLLEXPORT void shutdown();
+
+		//! \brief Returns <code>true</code> if the current search has found the goal, proven
+		//! it unreachable, or run out of memory, <code>false</code> otherwise.
+		DLLEXPORT bool isDone() const;
+
+		//! \brief Returns <code>true</code> if the current search had to give up a branch that
+		//! did not fit in the node budget, <code>false</code> otherwise.
+		DLLEXPORT bool isOutOfMemory() const;
+
+		//! \brief Returns the path found by the current search, goal first and start last, or
+		//! an empty vector if there is none.
+		DLLEXPORT std::vector<Tile const*> const getSolution() const;
+
+		//! \brief Returns the same path as <code>getSolution()</code> without copying it.
+		//!
+		//! The view stays valid until the next call to <code>enter()</code> or
+		//! <code>shutdown()</code>.
+		inline PathView getSolutionView() const
+		{
+			return PathView(solution);
+		}
+
+		//! \brief Attaches an index that <code>enter()</code> consults to reject unreachable
+		//! goals without searching, or detaches the index if <code>NULL</code>.
+		DLLEXPORT void setComponentIndex(ComponentIndex const* component_index);
+
+		//! \brief Returns the maximum number of nodes the search may hold.
+		inline std::size_t getNodeBudget() const
+		{
+			return pool.size();
+		}
+
+		//! \brief Returns the largest number of nodes held at once since the last call to
+		//! <code>enter()</code>.
+		inline std::size_t getPeakNodeCount() const
+		{
+			return peak_node_count;
+		}
+
+		//! \brief Returns an estimate of the most bytes held at once since the last call to
+		//! <code>enter()</code>.
+		DLLEXPORT std::size_t getPeakMemoryUsage() const;
+
+		//! \brief Returns the number of successors generated since the last call to
+		//! <code>enter()</code>.  SMA* generates one successor per step, so this is its
+		//! counterpart to the expansion count of the other engines.
+		inline std::size_t getExpansionCount() const
+		{
+			return expansion_count;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,59 @@
+#include <sstream>
+
+#include "Scenario.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	bool loadScenarios(istream& input_stream, vector<Scenario>& scenarios)
+	{
+		string line;
+		string keyword;
+		int version = 0;
+
+		if (!getline(input_stream, line) || !(istringstream(line) >> keyword >> version)
+		 || (keyword != "version") || (version != 1))
+		{
+			return false;
+		}
+
+		while (getline(input_stream, line))
+		{
+			if (line.find_first_not_of(" \t\r") == string::npos)
+			{
+				continue;
+			}
+
+			istringstream fields(line);
+			Scenario scenario;
+
+			if (!(fields >> scenario.bucket >> scenario.map_name >> scenario.column_count
+			             >> scenario.row_count >> scenario.start_column >> scenario.start_row
+			             >> scenario.goal_column >> scenario.goal_row >> scenario.optimal_cost))
+			{
+				return false;
+			}
+
+			scenarios.push_back(scenario);
+		}
+
+		return true;
+	}
+
+	void saveScenarios(ostream& output_stream, vector<Scenario> const& scenarios)
+	{
+		output_stream << "version 1\n";
+
+		for (size_t i = 0; i < scenarios.size(); ++i)
+		{
+			Scenario const& scenario = scenarios[i];
+
+			output_stream << scenario.bucket << '\t' << scenario.map_name << '\t'
+			              << scenario.column_count << '\t' << scenario.row_count << '\t'
+			              << scenario.start_column << '\t' << scenario.start_row << '\t'
+			              << scenario.goal_column << '\t' << scenario.goal_row << '\t'
+			              << scenario.optimal_cost << '\n';
+		}
+	}
+}}  // namespace fullsail_ai::algorithms
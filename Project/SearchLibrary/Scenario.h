@@ -0,0 +1,46 @@
+//! \file Scenario.h
+//! \brief Defines the <code>fullsail_ai::algorithms::Scenario</code> structure and the
+//! functions that read and write scenario files.
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief A single benchmark query: a map, a start, a goal and the optimal cost between them.
+	//!
+	//! Scenario files follow the layout of the MovingAI benchmark sets.  The first line reads
+	//! <code>version 1</code>, and every following line holds, separated by whitespace:
+	//!
+	//! <pre>bucket map columns rows start_column start_row goal_column goal_row optimal_cost</pre>
+	//!
+	//! The map is named relative to the scenario file, columns come before rows as x before y,
+	//! and the optimal cost uses the same cost model as <code>PathSearch</code>.
+	struct Scenario
+	{
+		int bucket;
+		std::string map_name;
+		int column_count;
+		int row_count;
+		int start_row;
+		int start_column;
+		int goal_row;
+		int goal_column;
+		unsigned int optimal_cost;
+	};
+
+	//! \brief Appends the scenarios read from the specified stream.
+	//!
+	//! \return <code>true</code> if the whole stream was read, <code>false</code> if the
+	//! version line is missing or a scenario line is malformed.  Scenarios before the
+	//! malformed line are kept.
+	DLLEXPORT bool loadScenarios(std::istream& input_stream, std::vector<Scenario>& scenarios);
+
+	//! \brief Writes the specified scenarios, version line first, to the specified stream.
+	DLLEXPORT void saveScenarios(std::ostream& output_stream, std::vector<Scenario> const& scenarios);
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,246 @@
+//! \file SearchCounters.h
+//! \brief Defines the counter policies that search engines can be instantiated with.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief A snapshot of what one or more searches did.
+	//!
+	//! Times are in nanoseconds.  Timing a step costs two clock reads, so the times are only
+	//! meaningful relative to each other and to the wall-clock time of the same instrumented run.
+	struct SearchCounters
+	{
+		//! \brief Nodes taken off the open list and expanded.
+		unsigned long long expanded_count;
+
+		//! \brief Successors seen for the first time and pushed onto the open list.
+		unsigned long long generated_count;
+
+		//! \brief Successors already on the open list that were pushed again at a lower cost.
+		unsigned long long reopened_count;
+
+		//! \brief The largest size the open list reached.
+		unsigned long long open_peak_size;
+
+		//! \brief Pushes onto the open list.
+		unsigned long long push_count;
+
+		//! \brief Pops off the open list.
+		unsigned long long pop_count;
+
+		//! \brief Removals from the middle of the open list.
+		unsigned long long remove_count;
+
+		//! \brief Time spent evaluating the heuristic.
+		unsigned long long heuristic_nanoseconds;
+
+		//! \brief Time spent expanding nodes, including the heuristic evaluations it made.
+		unsigned long long expansion_nanoseconds;
+
+		//! \brief Time spent building solutions.
+		unsigned long long reconstruction_nanoseconds;
+
+		//! \brief Bytes by which the search's own containers grew.
+		unsigned long long allocated_bytes;
+
+		//! \brief Constructs a snapshot with every counter at zero.
+		SearchCounters()
+			: expanded_count(0), generated_count(0), reopened_count(0), open_peak_size(0)
+			, push_count(0), pop_count(0), remove_count(0), heuristic_nanoseconds(0)
+			, expansion_nanoseconds(0), reconstruction_nanoseconds(0), allocated_bytes(0)
+		{
+		}
+
+		//! \brief Adds the specified counters to these.  Peak sizes take the larger of the two.
+		SearchCounters& operator+=(SearchCounters const& other)
+		{
+			expanded_count += other.expanded_count;
+			generated_count += other.generated_count;
+			reopened_count += other.reopened_count;
+			open_peak_size = (open_peak_size < other.open_peak_size)
+			               ? other.open_peak_size : open_peak_size;
+			push_count += other.push_count;
+			pop_count += other.pop_count;
+			remove_count += other.remove_count;
+			heuristic_nanoseconds += other.heuristic_nanoseconds;
+			expansion_nanoseconds += other.expansion_nanoseconds;
+			reconstruction_nanoseconds += other.reconstruction_nanoseconds;
+			allocated_bytes += other.allocated_bytes;
+			return *this;
+		}
+	};
+
+	//! \brief Counter policy that records nothing.
+	//!
+	//! Every member is an empty inline function, so an engine instantiated with this policy
+	//! compiles to the same code as one without any counters.
+	struct NoSearchCounters
+	{
+		//! \brief <code>false</code>: the snapshots of this policy are always zero.
+		static bool const IS_ENABLED = false;
+
+		//! \brief Times nothing.
+		struct Stopwatch
+		{
+			inline Stopwatch(NoSearchCounters&, unsigned long long SearchCounters::*)
+			{
+			}
+		};
+
+		inline void beginQuery()
+		{
+		}
+
+		inline void countExpansion()
+		{
+		}
+
+		inline void countGeneration()
+		{
+		}
+
+		inline void countReopening()
+		{
+		}
+
+		inline void countOpenSize(std::size_t)
+		{
+		}
+
+		inline void countPush()
+		{
+		}
+
+		inline void countPop()
+		{
+		}
+
+		inline void countRemoval()
+		{
+		}
+
+		inline void countAllocation(std::size_t)
+		{
+		}
+
+		inline SearchCounters getQuery() const
+		{
+			return SearchCounters();
+		}
+
+		inline SearchCounters getCumulative() const
+		{
+			return SearchCounters();
+		}
+
+		inline void resetCumulative()
+		{
+		}
+	};
+
+	//! \brief Counter policy that records every event of the current query, and folds each
+	//! query into a running total when the next one begins.
+	class RecordingSearchCounters
+	{
+		SearchCounters query;
+		SearchCounters cumulative;
+
+	public:
+		//! \brief <code>true</code>: the snapshots of this policy hold real counts.
+		static bool const IS_ENABLED = true;
+
+		//! \brief Adds the time between its construction and destruction to one counter.
+		class Stopwatch
+		{
+			unsigned long long& total;
+			std::chrono::steady_clock::time_point const start;
+
+		public:
+			inline Stopwatch(RecordingSearchCounters& counters,
+			                 unsigned long long SearchCounters::* counter)
+				: total(counters.query.*counter), start(std::chrono::steady_clock::now())
+			{
+			}
+
+			inline ~Stopwatch()
+			{
+				total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start
+				).count();
+			}
+		};
+
+		inline void beginQuery()
+		{
+			cumulative += query;
+			query = SearchCounters();
+		}
+
+		inline void countExpansion()
+		{
+			++query.expanded_count;
+		}
+
+		inline void countGeneration()
+		{
+			++query.generated_count;
+		}
+
+		inline void countReopening()
+		{
+			++query.reopened_count;
+		}
+
+		inline void countOpenSize(std::size_t size)
+		{
+			if (query.open_peak_size < size)
+			{
+				query.open_peak_size = size;
+			}
+		}
+
+		inline void countPush()
+		{
+			++query.push_count;
+		}
+
+		inline void countPop()
+		{
+			++query.pop_count;
+		}
+
+		inline void countRemoval()
+		{
+			++query.remove_count;
+		}
+
+		inline void countAllocation(std::size_t bytes)
+		{
+			query.allocated_bytes += bytes;
+		}
+
+		//! \brief Returns the counters of the current or most recent query.
+		inline SearchCounters getQuery() const
+		{
+			return query;
+		}
+
+		//! \brief Returns the counters of every query since the last reset, this one included.
+		inline SearchCounters getCumulative() const
+		{
+			SearchCounters total = cumulative;
+
+			total += query;
+			return total;
+		}
+
+		inline void resetCumulative()
+		{
+			cumulative = SearchCounters();
+			query = SearchCounters();
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
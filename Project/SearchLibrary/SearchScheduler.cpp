@@ -0,0 +1,257 @@
+#include <algorithm>
+
+#include "SearchScheduler.h"
+#include "GridTopology.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	size_t const SearchScheduler::DEFAULT_MINIMUM_SLICE;
+
+	SearchScheduler::SearchScheduler(TileMap& map, size_t engine_count, size_t budget)
+		: tile_map(&map), component_index(0), frame_budget(budget)
+		, minimum_slice(DEFAULT_MINIMUM_SLICE), engines(), free_engines(), requests(), waiting()
+		, active(), next_active(0), next_ticket(0), frame(0), last_frame_expansion_count(0)
+		, queue_depths(), latency_frames(), latency_nanoseconds()
+	{
+		for (size_t i = 0; i < engine_count; ++i)
+		{
+			engines.push_back(unique_ptr<PathSearch>(new PathSearch()));
+		}
+
+		clear();
+	}
+
+	SearchScheduler::~SearchScheduler()
+	{
+	}
+
+	SearchScheduler::Ticket SearchScheduler::submit(int start_row, int start_column, int goal_row,
+	                                                int goal_column, int priority)
+	{
+		Ticket const ticket = next_ticket++;
+		Request& request = requests[ticket];
+		Tile const* const start = tile_map->getTile(start_row, start_column);
+		Tile const* const goal = tile_map->getTile(goal_row, goal_column);
+
+		request.start_row = start_row;
+		request.start_column = start_column;
+		request.goal_row = goal_row;
+		request.goal_column = goal_column;
+		request.priority = priority;
+		request.submit_frame = frame;
+		request.submit_time = Clock::now();
+		request.engine = -1;
+		request.is_done = !start || !goal || !start->getWeight() || !goal->getWeight();
+
+		// The number of tiles within reach of a search that goes no further than the goal, but
+		// never more than the map holds passable ones.
+		size_t const distance = request.is_done
+			? 0 : getGridDistance(tile_map->getTopology(), start_row, start_column, goal_row,
+			                      goal_column);
+
+		request.expected_work = min<size_t>(3 * distance * (distance + 1) + 1,
+		                                    tile_map->getStatistics().getPassableCount());
+
+		if (!request.is_done && component_index && component_index->isCurrent())
+		{
+			int const start_index = start_row * tile_map->getColumnCount() + start_column;
+			int const goal_index = goal_row * tile_map->getColumnCount() + goal_column;
+
+			// No engine is spent proving the goal unreachable, and no search can expand more
+			// tiles than its start's component holds.
+			request.is_done = !component_index->isConnected(start_index, goal_index);
+			request.expected_work = min(request.expected_work,
+			                            component_index->getComponentSize(start_index));
+		}
+
+		if (!request.is_done)
+		{
+			waiting.insert(make_pair(-priority, ticket));
+		}
+
+		return ticket;
+	}
+
+	void SearchScheduler::admit()
+	{
+		while (!free_engines.empty() && !waiting.empty())
+		{
+			Ticket const ticket = waiting.begin()->second;
+			Request& request = requests[ticket];
+
+			waiting.erase(waiting.begin());
+			request.engine = free_engines.back();
+			free_engines.pop_back();
+			engines[request.engine]->enter(request.start_row, request.start_column,
+			                               request.goal_row, request.goal_column);
+			active.push_back(ticket);
+		}
+	}
+
+	size_t SearchScheduler::runSlice(size_t position, size_t expansion_budget)
+	{
+		Ticket const ticket = active[position];
+		Request& request = requests[ticket];
+		PathSearch& engine = *engines[request.engine];
+		size_t const expansion_count = engine.getExpansionCount();
+
+		if (!engine.isDone())
+		{
+			engine.updateExpansions(expansion_budget);
+		}
+
+		size_t const spent = engine.getExpansionCount() - expansion_count;
+
+		if (engine.isDone())
+		{
+			request.solution = engine.getSolution();
+			request.is_done = true;
+			engine.exit();
+			free_engines.push_back(request.engine);
+			request.engine = -1;
+			active.erase(active.begin() + position);
+			latency_frames.record(frame - request.submit_frame);
+			latency_nanoseconds.record(chrono::duration_cast<chrono::nanoseconds>(
+				Clock::now() - request.submit_time
+			).count());
+			admit();
+		}
+
+		return spent;
+	}
+
+	double SearchScheduler::getWeight(Request const& request, size_t expansion_count) const
+	{
+		// A search that has outrun its estimate is assumed to be two thirds of the way there.
+		size_t const remaining = (expansion_count < request.expected_work)
+		                       ? request.expected_work - expansion_count : expansion_count / 2;
+
+		return (1.0 + ((0 < request.priority) ? request.priority : 0))
+		     * (1.0 + (frame - request.submit_frame)) / (1.0 + remaining);
+	}
+
+	size_t SearchScheduler::runFrame()
+	{
+		TraceScope scope("runFrame", static_cast<long long>(frame_budget));
+
+		size_t budget = frame_budget;
+
+		++frame;
+		admit();
+		queue_depths.record(getQueueDepth());
+
+		// Minimum slices, round robin from the first search left out last frame.
+		vector<Ticket> turns(active.begin(), active.end());
+
+		rotate(turns.begin(), turns.begin() + ((next_active < turns.size()) ? next_active : 0),
+		       turns.end());
+		next_active = 0;
+
+		for (size_t i = 0; i < turns.size(); ++i)
+		{
+			if (!budget)
+			{
+				// Start next frame with this search.
+				next_active = find(active.begin(), active.end(), turns[i]) - active.begin();
+				break;
+			}
+
+			size_t const position = find(active.begin(), active.end(), turns[i]) - active.begin();
+
+			budget -= runSlice(position, (minimum_slice < budget) ? minimum_slice : budget);
+		}
+
+		// Weighted shares of the rest.  Every round either spends the budget or finishes a
+		// search, whose leftover goes to the next round.
+		while (budget && !active.empty())
+		{
+			vector<double> weights(active.size());
+			double total_weight = 0.0;
+
+			for (size_t i = 0; i < active.size(); ++i)
+			{
+				Request const& request = requests[active[i]];
+
+				weights[i] = getWeight(request, engines[request.engine]->getExpansionCount());
+				total_weight += weights[i];
+			}
+
+			size_t const round_budget = budget;
+
+			turns.assign(active.begin(), active.end());
+
+			for (size_t i = 0; budget && (i < turns.size()); ++i)
+			{
+				size_t share = static_cast<size_t>(round_budget * weights[i] / total_weight);
+
+				if (!share)
+				{
+					share = 1;
+				}
+
+				size_t const position = find(active.begin(), active.end(), turns[i]) - active.begin();
+
+				budget -= runSlice(position, (share < budget) ? share : budget);
+			}
+		}
+
+		last_frame_expansion_count = frame_budget - budget;
+		return last_frame_expansion_count;
+	}
+
+	bool SearchScheduler::isDone(Ticket ticket) const
+	{
+		unordered_map<Ticket, Request>::const_iterator itr = requests.find(ticket);
+
+		return (itr != requests.end()) && itr->second.is_done;
+	}
+
+	vector<Tile const*> const& SearchScheduler::getSolution(Ticket ticket) const
+	{
+		return requests.find(ticket)->second.solution;
+	}
+
+	void SearchScheduler::release(Ticket ticket)
+	{
+		unordered_map<Ticket, Request>::iterator itr = requests.find(ticket);
+
+		if (itr == requests.end())
+		{
+			return;
+		}
+
+		Request const& request = itr->second;
+
+		if (request.engine != -1)
+		{
+			engines[request.engine]->exit();
+			free_engines.push_back(request.engine);
+			active.erase(find(active.begin(), active.end(), ticket));
+		}
+		else if (!request.is_done)
+		{
+			waiting.erase(make_pair(-request.priority, ticket));
+		}
+
+		requests.erase(itr);
+	}
+
+	void SearchScheduler::clear()
+	{
+		requests.clear();
+		waiting.clear();
+		active.clear();
+		free_engines.clear();
+		next_active = 0;
+
+		for (size_t i = engines.size(); i--; )
+		{
+			engines[i]->exit();
+			engines[i]->initialize(tile_map);
+			free_engines.push_back(static_cast<int>(i));
+		}
+	}
+}}  // namespace fullsail_ai::algorithms
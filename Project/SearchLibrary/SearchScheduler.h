@@ -0,0 +1,195 @@
+//! \file SearchScheduler.h
+//! \brief Defines the <code>fullsail_ai::algorithms::SearchScheduler</code> class.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "ComponentIndex.h"
+#include "PathSearch.h"
+#include "SliceStatistics.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Shares a fixed number of expansions per frame among many searches.
+	//!
+	//! Requests are submitted with a priority and run on a pool of <code>PathSearch</code>
+	//! engines through the usual <code>enter()</code>, <code>updateExpansions()</code>,
+	//! <code>isDone()</code> and <code>exit()</code> calls.  Requests wait in a queue, highest
+	//! priority and then oldest first, until an engine is free.
+	//!
+	//! Each call to <code>runFrame()</code> spends at most the frame budget, counted in
+	//! expansions so that it can never be exceeded and every run is reproducible.  The budget
+	//! is handed out in two passes:
+	//!   - First every active search, in round-robin order, gets a minimum slice, so none can
+	//!     starve however low its priority.  If the budget cannot cover every search, the
+	//!     searches left out are the first to be served next frame.
+	//!   - The rest is split in proportion to a weight that grows with priority and with the
+	//!     number of frames the request has waited, and shrinks with the work the search is
+	//!     expected to have left, so short searches finish first.
+	//!
+	//! Expansions that a search does not use because it finished are given to the others
+	//! within the same frame, and freed engines admit queued requests straight away.
+	//!
+	//! With a component index attached, a request whose goal lies in another component
+	//! finishes as soon as it is submitted, and the work expected of the others is capped by
+	//! the size of their start's component.
+	class SearchScheduler
+	{
+	public:
+		//! \brief Identifies a submitted request.  Tickets are never reused.
+		typedef unsigned int Ticket;
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Request
+		{
+			int start_row;
+			int start_column;
+			int goal_row;
+			int goal_column;
+			int priority;
+			unsigned long long submit_frame;
+			Clock::time_point submit_time;
+			std::size_t expected_work;
+			int engine;
+			bool is_done;
+			std::vector<Tile const*> solution;
+		};
+
+		TileMap* tile_map;
+		ComponentIndex const* component_index;
+		std::size_t frame_budget;
+		std::size_t minimum_slice;
+		std::vector<std::unique_ptr<PathSearch> > engines;
+		std::vector<int> free_engines;
+		std::unordered_map<Ticket, Request> requests;
+		std::set<std::pair<int, Ticket> > waiting;
+		std::vector<Ticket> active;
+		std::size_t next_active;
+		Ticket next_ticket;
+		unsigned long long frame;
+		std::size_t last_frame_expansion_count;
+		Histogram queue_depths;
+		Histogram latency_frames;
+		Histogram latency_nanoseconds;
+
+		SearchScheduler(SearchScheduler const&);
+		SearchScheduler& operator=(SearchScheduler const&);
+
+		void admit();
+		std::size_t runSlice(std::size_t position, std::size_t expansion_budget);
+		double getWeight(Request const& request, std::size_t expansion_count) const;
+
+	public:
+		//! \brief The default minimum slice, in expansions.
+		static std::size_t const DEFAULT_MINIMUM_SLICE = 16;
+
+		//! \brief Constructs a scheduler over the specified tile map.
+		//!
+		//! \param   tile_map      the map every request is searched on.
+		//! \param   engine_count  the number of searches that may run at once.  Each one holds
+		//!                        a node for every tile of the map.
+		//! \param   frame_budget  the most expansions a single <code>runFrame()</code> spends.
+		DLLEXPORT SearchScheduler(TileMap& tile_map, std::size_t engine_count,
+		                          std::size_t frame_budget);
+
+		//! \brief Releases every engine and forgets every request.
+		DLLEXPORT ~SearchScheduler();
+
+		//! \brief Queues a search between the specified locations.
+		//!
+		//! \param   priority  any integer; higher priorities are admitted first and get larger
+		//!                    slices.  Negative priorities count as zero when slices are sized.
+		DLLEXPORT Ticket submit(int start_row, int start_column, int goal_row, int goal_column,
+		                        int priority);
+
+		//! \brief Runs one frame's worth of searching.
+		//!
+		//! \return  the number of expansions spent, never more than the frame budget.
+		DLLEXPORT std::size_t runFrame();
+
+		//! \brief Returns <code>true</code> if the specified request has finished.
+		DLLEXPORT bool isDone(Ticket ticket) const;
+
+		//! \brief Returns the path found for the specified finished request, goal first, or an
+		//! empty vector if the goal is unreachable.
+		//!
+		//! \pre
+		//!   - <code>isDone(ticket)</code> must return <code>true</code>.
+		DLLEXPORT std::vector<Tile const*> const& getSolution(Ticket ticket) const;
+
+		//! \brief Forgets the specified request, cancelling it if it has not finished.
+		DLLEXPORT void release(Ticket ticket);
+
+		//! \brief Cancels every request and resets the engines.  Call this after reloading the
+		//! tile map.
+		DLLEXPORT void clear();
+
+		//! \brief Attaches an index that <code>submit()</code> consults, or detaches the index
+		//! if <code>NULL</code>.  The index is ignored while it is not current.
+		inline void setComponentIndex(ComponentIndex const* index)
+		{
+			component_index = index;
+		}
+
+		//! \brief Sets the smallest slice every active search gets per frame while the budget
+		//! lasts.
+		inline void setMinimumSlice(std::size_t expansion_count)
+		{
+			minimum_slice = expansion_count ? expansion_count : 1;
+		}
+
+		//! \brief Sets the most expansions a single <code>runFrame()</code> spends.
+		inline void setFrameBudget(std::size_t expansion_count)
+		{
+			frame_budget = expansion_count;
+		}
+
+		//! \brief Returns the number of requests that are queued or running.
+		inline std::size_t getQueueDepth() const
+		{
+			return waiting.size() + active.size();
+		}
+
+		//! \brief Returns the number of requests that are waiting for an engine.
+		inline std::size_t getWaitingCount() const
+		{
+			return waiting.size();
+		}
+
+		//! \brief Returns the number of expansions the last <code>runFrame()</code> spent.
+		inline std::size_t getLastFrameExpansionCount() const
+		{
+			return last_frame_expansion_count;
+		}
+
+		//! \brief Returns the queue depth seen at the start of every frame.
+		inline Histogram const& getQueueDepths() const
+		{
+			return queue_depths;
+		}
+
+		//! \brief Returns the number of frames between the submission and the completion of
+		//! every finished request, counting the frame it finished in.
+		inline Histogram const& getLatencyFrames() const
+		{
+			return latency_frames;
+		}
+
+		//! \brief Returns the nanoseconds between the submission and the completion of every
+		//! finished request.
+		inline Histogram const& getLatencyNanoseconds() const
+		{
+			return latency_nanoseconds;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
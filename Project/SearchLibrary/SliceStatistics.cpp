@@ -0,0 +1,213 @@
+#include "SliceStatistics.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace {
+
+		// Each power of two above 2^SUB_BUCKET_BITS is split into 2^SUB_BUCKET_BITS buckets.
+		static int const SUB_BUCKET_BITS = 4;
+		static unsigned long long const SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+
+		int getMagnitude(unsigned long long value)
+		{
+			int magnitude = 0;
+
+			while (value >>= 1)
+			{
+				++magnitude;
+			}
+
+			return magnitude;
+		}
+
+		size_t getBucket(unsigned long long value)
+		{
+			if (value < 2 * SUB_BUCKET_COUNT)
+			{
+				return static_cast<size_t>(value);
+			}
+
+			int const shift = getMagnitude(value) - SUB_BUCKET_BITS;
+
+			return static_cast<size_t>(shift * SUB_BUCKET_COUNT + (value >> shift));
+		}
+
+		// The largest value that falls into the specified bucket.
+		unsigned long long getBucketLimit(size_t bucket)
+		{
+			if (bucket < 2 * SUB_BUCKET_COUNT)
+			{
+				return bucket;
+			}
+
+			int const shift = static_cast<int>(bucket / SUB_BUCKET_COUNT) - 1;
+			unsigned long long const lowest
+				= (bucket % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT) << shift;
+
+			return lowest + ((1ULL << shift) - 1);
+		}
+	}
+
+	Histogram::Histogram()
+	{
+		clear();
+	}
+
+	void Histogram::record(unsigned long long value)
+	{
+		++counts[getBucket(value)];
+
+		if (!total_count || (value < minimum))
+		{
+			minimum = value;
+		}
+
+		if (maximum < value)
+		{
+			maximum = value;
+		}
+
+		++total_count;
+		sum += static_cast<double>(value);
+	}
+
+	void Histogram::clear()
+	{
+		for (size_t i = 0; i < BUCKET_COUNT; ++i)
+		{
+			counts[i] = 0;
+		}
+
+		total_count = minimum = maximum = 0;
+		sum = 0.0;
+	}
+
+	Histogram& Histogram::operator+=(Histogram const& other)
+	{
+		if (!other.total_count)
+		{
+			return *this;
+		}
+
+		for (size_t i = 0; i < BUCKET_COUNT; ++i)
+		{
+			counts[i] += other.counts[i];
+		}
+
+		if (!total_count || (other.minimum < minimum))
+		{
+			minimum = other.minimum;
+		}
+
+		if (maximum < other.maximum)
+		{
+			maximum = other.maximum;
+		}
+
+		total_count += other.total_count;
+		sum += other.sum;
+		return *this;
+	}
+
+	unsigned long long Histogram::getValueAtPercentile(double percentile) const
+	{
+		if (!total_count)
+		{
+			return 0;
+		}
+
+		// Nearest rank, as the benchmarks compute it.
+		unsigned long long rank
+			= static_cast<unsigned long long>(percentile / 100.0 * total_count + 0.999999);
+
+		if (!rank)
+		{
+			rank = 1;
+		}
+
+		unsigned long long seen = 0;
+
+		for (size_t i = 0; i < BUCKET_COUNT; ++i)
+		{
+			seen += counts[i];
+
+			if (rank <= seen)
+			{
+				unsigned long long const limit = getBucketLimit(i);
+
+				return (maximum < limit) ? maximum : limit;
+			}
+		}
+
+		return maximum;
+	}
+
+	SliceMonitor::SliceMonitor()
+		: overruns(), expansions(), overrun_tolerance(DEFAULT_OVERRUN_TOLERANCE), poll_interval(1)
+	{
+	}
+
+	void SliceMonitor::recordSlice(long timeslice, long long elapsed_nanoseconds,
+	                               size_t expansion_count, bool is_deadline_reached)
+	{
+		long long overrun = 0;
+
+		expansions.record(expansion_count);
+
+		if (is_deadline_reached)
+		{
+			overrun = elapsed_nanoseconds - timeslice * 1000000LL;
+			overruns.record((0 < overrun) ? static_cast<unsigned long long>(overrun) : 0);
+		}
+
+		// A zero budget always expands one node, which says nothing about the clock.
+		if (!timeslice || !expansion_count)
+		{
+			return;
+		}
+
+		long long const expansion_nanoseconds = elapsed_nanoseconds / expansion_count + 1;
+		size_t target = static_cast<size_t>(overrun_tolerance / 2 / expansion_nanoseconds);
+
+		if (target < 1)
+		{
+			target = 1;
+		}
+		else if (MAX_POLL_INTERVAL < target)
+		{
+			target = MAX_POLL_INTERVAL;
+		}
+
+		if (overrun_tolerance < overrun)
+		{
+			poll_interval = (poll_interval / 2 < target) ? poll_interval / 2 : target;
+		}
+		else if (target < poll_interval)
+		{
+			poll_interval = target;
+		}
+		else
+		{
+			// Grow at most twofold per slice, so that one unusually fast slice cannot mislead it.
+			poll_interval = (poll_interval * 2 < target) ? poll_interval * 2 : target;
+		}
+
+		if (!poll_interval)
+		{
+			poll_interval = 1;
+		}
+	}
+
+	void SliceMonitor::setOverrunTolerance(long long nanoseconds)
+	{
+		overrun_tolerance = (0 < nanoseconds) ? nanoseconds : 0;
+	}
+
+	void SliceMonitor::clear()
+	{
+		overruns.clear();
+		expansions.clear();
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,143 @@
+//! \file SliceStatistics.h
+//! \brief Defines the <code>fullsail_ai::algorithms::Histogram</code> and
+//! <code>fullsail_ai::algorithms::SliceMonitor</code> classes.
+#pragma once
+
+#include <cstddef>
+
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Fixed-size histogram of non-negative integers in the style of HdrHistogram.
+	//!
+	//! Values below 32 are counted exactly.  Above that, every power of two is split into 16
+	//! equal buckets, so a reported value is never more than 1/16 above the recorded one.
+	//! Recording is a few shifts and an increment, and never allocates.
+	class Histogram
+	{
+	public:
+		//! \brief The number of buckets needed to cover every <code>unsigned long long</code>.
+		static std::size_t const BUCKET_COUNT = 976;
+
+	private:
+		unsigned long long counts[BUCKET_COUNT];
+		unsigned long long total_count;
+		unsigned long long minimum;
+		unsigned long long maximum;
+		double sum;
+
+	public:
+		//! \brief Constructs an empty histogram.
+		DLLEXPORT Histogram();
+
+		//! \brief Counts one occurrence of the specified value.
+		DLLEXPORT void record(unsigned long long value);
+
+		//! \brief Forgets every recorded value.
+		DLLEXPORT void clear();
+
+		//! \brief Adds every value recorded by the specified histogram to this one.
+		DLLEXPORT Histogram& operator+=(Histogram const& other);
+
+		//! \brief Returns the smallest value <code>v</code> such that at least
+		//! <code>percentile</code> percent of the recorded values are no greater than
+		//! <code>v</code>, to the precision of the buckets, or zero if nothing was recorded.
+		DLLEXPORT unsigned long long getValueAtPercentile(double percentile) const;
+
+		//! \brief Returns the number of recorded values.
+		inline unsigned long long getCount() const
+		{
+			return total_count;
+		}
+
+		//! \brief Returns the smallest recorded value, or zero if nothing was recorded.
+		inline unsigned long long getMinimum() const
+		{
+			return total_count ? minimum : 0;
+		}
+
+		//! \brief Returns the largest recorded value, or zero if nothing was recorded.
+		inline unsigned long long getMaximum() const
+		{
+			return maximum;
+		}
+
+		//! \brief Returns the mean of the recorded values, or zero if nothing was recorded.
+		inline double getMean() const
+		{
+			return total_count ? sum / total_count : 0.0;
+		}
+	};
+
+	//! \brief Measures how well a time-sliced engine keeps to its time slices, and decides how
+	//! often the engine reads the clock.
+	//!
+	//! An engine that reads the clock after every expansion pays for the read many thousands of
+	//! times per slice, while one that reads it too rarely overruns its slice.  The monitor
+	//! estimates the cost of one expansion from each slice and lets the engine skip as many
+	//! clock reads as it can while the worst-case overrun stays within half the tolerance.
+	//! Whenever an overrun still exceeds the tolerance, the interval is halved at once.
+	class SliceMonitor
+	{
+		Histogram overruns;
+		Histogram expansions;
+		long long overrun_tolerance;
+		std::size_t poll_interval;
+
+	public:
+		//! \brief The default overrun tolerance: 100 microseconds.
+		static long long const DEFAULT_OVERRUN_TOLERANCE = 100000;
+
+		//! \brief The largest number of expansions between two clock reads.
+		static std::size_t const MAX_POLL_INTERVAL = 4096;
+
+		//! \brief Constructs a monitor with the default tolerance that starts by reading the
+		//! clock after every expansion.
+		DLLEXPORT SliceMonitor();
+
+		//! \brief Records one call to <code>update()</code> and adapts the poll interval.
+		//!
+		//! \param   timeslice            the budget passed to <code>update()</code>, in
+		//!                               milliseconds.
+		//! \param   elapsed_nanoseconds  the time the call actually took.
+		//! \param   expansion_count      the number of nodes it expanded.
+		//! \param   is_deadline_reached  <code>true</code> if the call returned because its
+		//!                               budget ran out, rather than because the search ended
+		//!                               or the budget was zero.  Only these calls have an
+		//!                               overrun.
+		DLLEXPORT void recordSlice(long timeslice, long long elapsed_nanoseconds,
+		                           std::size_t expansion_count, bool is_deadline_reached);
+
+		//! \brief Sets the overrun, in nanoseconds, that the poll interval is adapted to stay
+		//! under.
+		DLLEXPORT void setOverrunTolerance(long long nanoseconds);
+
+		//! \brief Forgets every recorded slice but keeps the current poll interval.
+		DLLEXPORT void clear();
+
+		//! \brief Returns the overrun tolerance in nanoseconds.
+		inline long long getOverrunTolerance() const
+		{
+			return overrun_tolerance;
+		}
+
+		//! \brief Returns the number of expansions the engine should run between clock reads.
+		inline std::size_t getPollInterval() const
+		{
+			return poll_interval;
+		}
+
+		//! \brief Returns the nanoseconds by which each slice that ran out of budget overran it.
+		inline Histogram const& getOverruns() const
+		{
+			return overruns;
+		}
+
+		//! \brief Returns the number of expansions made by each slice.
+		inline Histogram const& getExpansions() const
+		{
+			return expansions;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
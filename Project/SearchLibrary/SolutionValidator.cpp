@@ -0,0 +1,213 @@
+#include <algorithm>
+
+#include "SolutionValidator.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace {
+
+		SolutionReport makeReport(SolutionReport::Error error, int step, unsigned int cost,
+		                          unsigned int optimal_cost)
+		{
+			SolutionReport report;
+
+			report.error = error;
+			report.step = step;
+			report.cost = cost;
+			report.optimal_cost = optimal_cost;
+			return report;
+		}
+
+		// Orders scenarios by goal, row first, so that those sharing a goal are adjacent.
+		struct GoalOrder
+		{
+			vector<Scenario> const* scenarios;
+
+			bool operator()(size_t lhs, size_t rhs) const
+			{
+				Scenario const& l = (*scenarios)[lhs];
+				Scenario const& r = (*scenarios)[rhs];
+
+				return (l.goal_row == r.goal_row) ? (l.goal_column < r.goal_column)
+				                                  : (l.goal_row < r.goal_row);
+			}
+		};
+	}
+
+	unsigned int const SolutionValidator::UNKNOWN_COST;
+
+	char const* getSolutionErrorName(SolutionReport::Error error)
+	{
+		switch (error)
+		{
+		case SolutionReport::VALID:           return "valid";
+		case SolutionReport::MISSING_PATH:    return "missing-path";
+		case SolutionReport::UNEXPECTED_PATH: return "unexpected-path";
+		case SolutionReport::WRONG_START:     return "wrong-start";
+		case SolutionReport::WRONG_GOAL:      return "wrong-goal";
+		case SolutionReport::FOREIGN_TILE:    return "foreign-tile";
+		case SolutionReport::IMPASSABLE_TILE: return "impassable-tile";
+		case SolutionReport::NOT_ADJACENT:    return "not-adjacent";
+		case SolutionReport::SUBOPTIMAL:      return "suboptimal";
+		case SolutionReport::BELOW_OPTIMAL:   return "below-optimal";
+		}
+
+		return "unknown";
+	}
+
+	SolutionValidator::SolutionValidator(TileMap const& map, size_t reference_byte_budget)
+		: tile_map(&map), references(map, reference_byte_budget)
+		, has_references(reference_byte_budget != 0)
+	{
+	}
+
+	SolutionReport SolutionValidator::check(PathView path, int start_row, int start_column,
+	                                        int goal_row, int goal_column,
+	                                        unsigned int optimal_cost) const
+	{
+		if (path.empty())
+		{
+			return makeReport(
+				((optimal_cost == UNKNOWN_COST) || (optimal_cost == FlowField::UNREACHABLE))
+				  ? SolutionReport::VALID : SolutionReport::MISSING_PATH
+			  , -1
+			  , 0
+			  , optimal_cost
+			);
+		}
+
+		if (optimal_cost == FlowField::UNREACHABLE)
+		{
+			return makeReport(SolutionReport::UNEXPECTED_PATH, -1, 0, optimal_cost);
+		}
+
+		int const last = static_cast<int>(path.size()) - 1;
+
+		if (path[last] != tile_map->getTile(start_row, start_column))
+		{
+			return makeReport(SolutionReport::WRONG_START, last, 0, optimal_cost);
+		}
+
+		if (path[0] != tile_map->getTile(goal_row, goal_column))
+		{
+			return makeReport(SolutionReport::WRONG_GOAL, 0, 0, optimal_cost);
+		}
+
+		unsigned int cost = 0;
+		int row = start_row;
+		int column = start_column;
+
+		// Walk from the start, which the check above has already matched to the map.
+		for (int i = last; i--; )
+		{
+			Tile const* const tile = path[i];
+			int const next_row = tile->getRow();
+			int const next_column = tile->getColumn();
+
+			if (tile_map->getTile(next_row, next_column) != tile)
+			{
+				return makeReport(SolutionReport::FOREIGN_TILE, i, 0, optimal_cost);
+			}
+
+			if (!tile->getWeight())
+			{
+				return makeReport(SolutionReport::IMPASSABLE_TILE, i, 0, optimal_cost);
+			}
+
+			if (getGridDirection(*tile_map, row, column, next_row, next_column) < 0)
+			{
+				return makeReport(SolutionReport::NOT_ADJACENT, i, 0, optimal_cost);
+			}
+
+			cost += tile->getWeight();
+			row = next_row;
+			column = next_column;
+		}
+
+		if (!path[last]->getWeight())
+		{
+			return makeReport(SolutionReport::IMPASSABLE_TILE, last, cost, optimal_cost);
+		}
+
+		SolutionReport::Error error = SolutionReport::VALID;
+
+		if (optimal_cost != UNKNOWN_COST)
+		{
+			if (optimal_cost < cost)
+			{
+				error = SolutionReport::SUBOPTIMAL;
+			}
+			else if (cost < optimal_cost)
+			{
+				error = SolutionReport::BELOW_OPTIMAL;
+			}
+		}
+
+		return makeReport(error, -1, cost, optimal_cost);
+	}
+
+	SolutionReport SolutionValidator::validate(PathView path, int start_row, int start_column,
+	                                           int goal_row, int goal_column)
+	{
+		unsigned int optimal_cost = UNKNOWN_COST;
+
+		if (has_references && tile_map->getTile(start_row, start_column)
+		                   && tile_map->getTile(goal_row, goal_column))
+		{
+			optimal_cost = references.acquire(goal_row, goal_column).getCost(start_row,
+			                                                                  start_column);
+		}
+
+		return check(path, start_row, start_column, goal_row, goal_column, optimal_cost);
+	}
+
+	SolutionReport SolutionValidator::validate(PathView path, Scenario const& scenario)
+	{
+		if (has_references)
+		{
+			return validate(path, scenario.start_row, scenario.start_column, scenario.goal_row,
+			                scenario.goal_column);
+		}
+
+		return check(path, scenario.start_row, scenario.start_column, scenario.goal_row,
+		             scenario.goal_column, scenario.optimal_cost);
+	}
+
+	size_t SolutionValidator::validate(vector<vector<Tile const*> > const& paths,
+	                                   vector<Scenario> const& scenarios,
+	                                   vector<SolutionReport>& reports)
+	{
+		vector<size_t> order(scenarios.size());
+		size_t invalid_count = 0;
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			order[i] = i;
+		}
+
+		if (has_references)
+		{
+			GoalOrder const goal_order = { &scenarios };
+
+			stable_sort(order.begin(), order.end(), goal_order);
+		}
+
+		reports.resize(scenarios.size());
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			SolutionReport& report = reports[order[i]];
+
+			report = validate(paths[order[i]], scenarios[order[i]]);
+
+			if (report.error != SolutionReport::VALID)
+			{
+				++invalid_count;
+			}
+		}
+
+		return invalid_count;
+	}
+}}  // namespace fullsail_ai::algorithms
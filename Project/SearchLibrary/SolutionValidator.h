@@ -0,0 +1,141 @@
+//! \file SolutionValidator.h
+//! \brief Defines the <code>fullsail_ai::algorithms::SolutionReport</code> structure and the
+//! <code>fullsail_ai::algorithms::SolutionValidator</code> class.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../platform.h"
+#include "../TileLibrary/TileMap.h"
+#include "FlowField.h"
+#include "PathView.h"
+#include "Scenario.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief The outcome of validating one path.
+	struct SolutionReport
+	{
+		//! \brief What, if anything, is wrong with the path.  Only the first problem found is
+		//! reported.
+		enum Error
+		{
+			//! The path is valid and, if its cost could be checked, optimal.
+			VALID,
+
+			//! The path is empty although the goal is reachable.
+			MISSING_PATH,
+
+			//! The path is not empty although the goal is unreachable.
+			UNEXPECTED_PATH,
+
+			//! The last tile of the path is not the start.
+			WRONG_START,
+
+			//! The first tile of the path is not the goal.
+			WRONG_GOAL,
+
+			//! A tile of the path does not belong to the tile map.
+			FOREIGN_TILE,
+
+			//! A tile of the path is impassable.
+			IMPASSABLE_TILE,
+
+			//! Two consecutive tiles of the path are not adjacent.
+			NOT_ADJACENT,
+
+			//! The path is valid but costlier than the optimal cost.
+			SUBOPTIMAL,
+
+			//! The path is valid but cheaper than the supposedly optimal cost, which must
+			//! therefore be wrong.
+			BELOW_OPTIMAL
+		};
+
+		//! \brief What is wrong with the path.
+		Error error;
+
+		//! \brief The index into the path of the offending tile, or -1 if the error does not
+		//! concern a single tile.
+		int step;
+
+		//! \brief The cost of the path, if every step of it is valid.
+		unsigned int cost;
+
+		//! \brief The cost the path was compared against, or
+		//! <code>FlowField::UNREACHABLE</code> if the goal is unreachable, or
+		//! <code>SolutionValidator::UNKNOWN_COST</code> if it was not compared.
+		unsigned int optimal_cost;
+	};
+
+	//! \brief Returns a short lower-case name of the specified error, such as
+	//! <code>"not-adjacent"</code>.
+	DLLEXPORT char const* getSolutionErrorName(SolutionReport::Error error);
+
+	//! \brief Checks paths returned by the search engines against a tile map.
+	//!
+	//! Paths are in the order the engines return them: goal first and start last.  A path is
+	//! valid if it runs from the start to the goal through passable tiles of the map, each
+	//! adjacent to the next, and its cost is the sum of the weights of every tile except the
+	//! start.  Adjacency is checked on integer rows and columns, so validation does no
+	//! floating-point math and allocates nothing.
+	//!
+	//! If given a reference budget, the validator also computes the optimal cost to each goal
+	//! with a reverse Dijkstra search, caches the resulting <code>FlowField</code>, and
+	//! reports paths that are costlier than it.
+	class SolutionValidator
+	{
+		TileMap const* tile_map;
+		FlowFieldCache references;
+		bool has_references;
+
+		SolutionValidator(SolutionValidator const&);
+		SolutionValidator& operator=(SolutionValidator const&);
+
+		SolutionReport check(PathView path, int start_row, int start_column, int goal_row,
+		                     int goal_column, unsigned int optimal_cost) const;
+
+	public:
+		//! \brief The <code>optimal_cost</code> of reports whose cost was not compared.
+		static unsigned int const UNKNOWN_COST = FlowField::UNREACHABLE - 1;
+
+		//! \brief Constructs a validator for paths over the specified tile map.
+		//!
+		//! \param   tile_map              the map the paths were found on.
+		//! \param   reference_byte_budget the most memory the cached reference fields may
+		//!                                hold, or zero to skip the reference costs.
+		DLLEXPORT SolutionValidator(TileMap const& tile_map, std::size_t reference_byte_budget);
+
+		//! \brief Validates a path between the specified locations.
+		//!
+		//! Compares its cost with the reference cost if the validator has a reference budget.
+		DLLEXPORT SolutionReport validate(PathView path, int start_row, int start_column,
+		                                  int goal_row, int goal_column);
+
+		//! \brief Validates a path found for the specified scenario.
+		//!
+		//! Compares its cost with the reference cost if the validator has a reference budget,
+		//! or with the optimal cost recorded in the scenario otherwise.
+		DLLEXPORT SolutionReport validate(PathView path, Scenario const& scenario);
+
+		//! \brief Validates the path found for each scenario, storing a report per path.
+		//!
+		//! Scenarios are visited goal by goal, so that each reference field is built once
+		//! however many scenarios share its goal.
+		//!
+		//! \return  the number of paths that are not <code>VALID</code>.
+		//!
+		//! \pre
+		//!   - There must be as many paths as scenarios.
+		DLLEXPORT std::size_t validate(std::vector<std::vector<Tile const*> > const& paths,
+		                               std::vector<Scenario> const& scenarios,
+		                               std::vector<SolutionReport>& reports);
+
+		//! \brief Discards every cached reference field.  Call this after reloading the map.
+		inline void clear()
+		{
+			references.clear();
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,222 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Tracer.h"
+
+using namespace std;
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace {
+
+		struct TraceEvent
+		{
+			char const* name;
+			long long begin;
+			long long end;
+			long long value;
+		};
+
+		// Chunks are allocated as a thread needs them, so an idle thread costs one table.
+		static size_t const CHUNK_SIZE = 4096;
+		static size_t const CHUNK_COUNT = 1024;
+
+		// Written only by its own thread.  The size is published with release semantics after
+		// each event is complete, so a concurrent write() never reads a half-written event.
+		struct ThreadBuffer
+		{
+			unsigned int thread_id;
+			atomic<size_t> size;
+			atomic<size_t> dropped_count;
+			atomic<TraceEvent*> chunks[CHUNK_COUNT];
+
+			explicit ThreadBuffer(unsigned int id) : thread_id(id), size(0), dropped_count(0)
+			{
+				for (size_t i = 0; i < CHUNK_COUNT; ++i)
+				{
+					chunks[i].store(0, memory_order_relaxed);
+				}
+			}
+
+			~ThreadBuffer()
+			{
+				for (size_t i = 0; i < CHUNK_COUNT; ++i)
+				{
+					delete[] chunks[i].load(memory_order_relaxed);
+				}
+			}
+		};
+
+		atomic<bool> is_enabled(false);
+		mutex registry_mutex;
+		vector<unique_ptr<ThreadBuffer> > registry;
+		chrono::steady_clock::time_point epoch;
+		bool has_epoch = false;
+		thread_local ThreadBuffer* local_buffer = 0;
+
+		ThreadBuffer& getLocalBuffer()
+		{
+			if (!local_buffer)
+			{
+				lock_guard<mutex> lock(registry_mutex);
+
+				registry.push_back(unique_ptr<ThreadBuffer>(
+					new ThreadBuffer(static_cast<unsigned int>(registry.size() + 1))
+				));
+				local_buffer = registry.back().get();
+			}
+
+			return *local_buffer;
+		}
+
+		void writeString(ostream& output, char const* text)
+		{
+			output << '"';
+
+			for (; *text; ++text)
+			{
+				if ((*text == '"') || (*text == '\\'))
+				{
+					output << '\\';
+				}
+
+				output << *text;
+			}
+
+			output << '"';
+		}
+	}
+
+	void Tracer::enable()
+	{
+		{
+			lock_guard<mutex> lock(registry_mutex);
+
+			if (!has_epoch)
+			{
+				epoch = chrono::steady_clock::now();
+				has_epoch = true;
+			}
+		}
+
+		is_enabled.store(true, memory_order_release);
+	}
+
+	void Tracer::disable()
+	{
+		is_enabled.store(false, memory_order_release);
+	}
+
+	bool Tracer::isEnabled()
+	{
+		return is_enabled.load(memory_order_acquire);
+	}
+
+	long long Tracer::now()
+	{
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+	}
+
+	void Tracer::record(char const* name, long long begin, long long end, long long value)
+	{
+		ThreadBuffer& buffer = getLocalBuffer();
+		size_t const index = buffer.size.load(memory_order_relaxed);
+
+		if (CHUNK_SIZE * CHUNK_COUNT <= index)
+		{
+			buffer.dropped_count.fetch_add(1, memory_order_relaxed);
+			return;
+		}
+
+		TraceEvent* chunk = buffer.chunks[index / CHUNK_SIZE].load(memory_order_relaxed);
+
+		if (!chunk)
+		{
+			chunk = new TraceEvent[CHUNK_SIZE];
+			buffer.chunks[index / CHUNK_SIZE].store(chunk, memory_order_release);
+		}
+
+		TraceEvent& event = chunk[index % CHUNK_SIZE];
+
+		event.name = name;
+		event.begin = begin;
+		event.end = end;
+		event.value = value;
+		buffer.size.store(index + 1, memory_order_release);
+	}
+
+	bool Tracer::write(ostream& output)
+	{
+		lock_guard<mutex> lock(registry_mutex);
+		ios::fmtflags const flags = output.flags();
+		streamsize const precision = output.precision();
+		bool is_first = true;
+
+		output.setf(ios::fixed, ios::floatfield);
+		output.precision(3);
+		output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		for (size_t b = 0; b < registry.size(); ++b)
+		{
+			ThreadBuffer const& buffer = *registry[b];
+			size_t const size = buffer.size.load(memory_order_acquire);
+
+			output << (is_first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+			       << "\"tid\":" << buffer.thread_id << ",\"args\":{\"name\":\"thread "
+			       << buffer.thread_id << "\"}}";
+			is_first = false;
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				TraceEvent const& event
+					= buffer.chunks[i / CHUNK_SIZE].load(memory_order_acquire)[i % CHUNK_SIZE];
+
+				// Complete events, with times in microseconds.
+				output << ",\n{\"name\":";
+				writeString(output, event.name);
+				output << ",\"cat\":\"search\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.thread_id
+				       << ",\"ts\":" << event.begin / 1000.0
+				       << ",\"dur\":" << (event.end - event.begin) / 1000.0;
+
+				if (event.value != NO_VALUE)
+				{
+					output << ",\"args\":{\"value\":" << event.value << '}';
+				}
+
+				output << '}';
+			}
+		}
+
+		output << "\n]}\n";
+		output.flags(flags);
+		output.precision(precision);
+		return static_cast<bool>(output.flush());
+	}
+
+	void Tracer::clear()
+	{
+		lock_guard<mutex> lock(registry_mutex);
+
+		for (size_t b = 0; b < registry.size(); ++b)
+		{
+			registry[b]->size.store(0, memory_order_relaxed);
+			registry[b]->dropped_count.store(0, memory_order_relaxed);
+		}
+	}
+
+	size_t Tracer::getDroppedCount()
+	{
+		lock_guard<mutex> lock(registry_mutex);
+		size_t count = 0;
+
+		for (size_t b = 0; b < registry.size(); ++b)
+		{
+			count += registry[b]->dropped_count.load(memory_order_relaxed);
+		}
+
+		return count;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,94 @@
+//! \file Tracer.h
+//! \brief Defines the <code>fullsail_ai::algorithms::Tracer</code> and
+//! <code>fullsail_ai::algorithms::TraceScope</code> classes.
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Process-wide recorder of timed events, written out in the Chrome trace format
+	//! that <code>chrome://tracing</code> and Perfetto load.
+	//!
+	//! Every thread appends to a buffer of its own, so recording takes no lock; a lock is
+	//! taken only the first time a thread records.  While tracing is disabled, a
+	//! <code>TraceScope</code> costs one atomic load and a branch.
+	class Tracer
+	{
+	public:
+		//! \brief Value of events that carry no argument.
+		static long long const NO_VALUE = -1;
+
+		//! \brief Starts recording events.
+		DLLEXPORT static void enable();
+
+		//! \brief Stops recording events.  Events already recorded are kept.
+		DLLEXPORT static void disable();
+
+		//! \brief Returns <code>true</code> if events are being recorded.
+		DLLEXPORT static bool isEnabled();
+
+		//! \brief Returns the number of nanoseconds since the tracer was first enabled.
+		DLLEXPORT static long long now();
+
+		//! \brief Appends a completed event to the calling thread's buffer.
+		//!
+		//! \param   name   a string that outlives the tracer, normally a literal.
+		//! \param   begin  the start of the event, as returned by <code>now()</code>.
+		//! \param   end    the end of the event, as returned by <code>now()</code>.
+		//! \param   value  an argument shown with the event, or <code>NO_VALUE</code>.
+		DLLEXPORT static void record(char const* name, long long begin, long long end,
+		                             long long value);
+
+		//! \brief Writes every recorded event as a Chrome trace JSON document.
+		//!
+		//! May run while other threads record; events they publish meanwhile may be left out.
+		DLLEXPORT static bool write(std::ostream& output);
+
+		//! \brief Discards every recorded event but keeps the buffers for reuse.
+		//!
+		//! \pre
+		//!   - No thread is recording, e.g. the tracer has been disabled and every
+		//!     <code>TraceScope</code> has ended.
+		DLLEXPORT static void clear();
+
+		//! \brief Returns the number of events dropped because a thread's buffer was full.
+		DLLEXPORT static std::size_t getDroppedCount();
+	};
+
+	//! \brief Records one event spanning the lifetime of this object, if the
+	//! <code>Tracer</code> is enabled when it is constructed.
+	class TraceScope
+	{
+		char const* name;
+		long long value;
+		long long begin;
+		bool is_recording;
+
+		TraceScope(TraceScope const&);
+		TraceScope& operator=(TraceScope const&);
+
+	public:
+		//! \brief Begins an event with the specified name and optional argument.
+		inline explicit TraceScope(char const* event_name, long long event_value = Tracer::NO_VALUE)
+			: name(event_name), value(event_value), begin(0), is_recording(Tracer::isEnabled())
+		{
+			if (is_recording)
+			{
+				begin = Tracer::now();
+			}
+		}
+
+		//! \brief Ends the event.
+		inline ~TraceScope()
+		{
+			if (is_recording)
+			{
+				Tracer::record(name, begin, Tracer::now(), value);
+			}
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
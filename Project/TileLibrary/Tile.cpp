@@ -6,9 +6,29 @@ using namespace std;  // Because the sqrt() function really belongs here.
 
 namespace fullsail_ai {
 
-	Tile::Tile(int r, int c, double radius, unsigned char data)
+	namespace {
+
+		// Returns the x-coordinate of the center of a tile, in tile radii.
+		int getHalfColumn(int r, int c, TileTopology topology)
+		{
+			switch (topology)
+			{
+			case HEX_EVEN_ROWS:
+				return (r & 1) ? ((c << 1) | 1) : ((c + 1) << 1);
+			case SQUARE_FOUR:
+			case SQUARE_EIGHT:
+				return (c << 1) | 1;
+			default:
+				return (r & 1) ? ((c + 1) << 1) : ((c << 1) | 1);
+			}
+		}
+	}
+
+	// Rows are the same distance apart in every topology, so that a map takes up the same
+	// height however its tiles are shaped.
+	Tile::Tile(int r, int c, double radius, unsigned char data, TileTopology topology)
 		: weight(data), row(r), column(c)
-		, x(((r & 1) ? ((c + 1) << 1) : ((c << 1) | 1)) * radius)
+		, x(getHalfColumn(r, c, topology) * radius)
 		, y((r * 3 + 2) * radius / sqrt(3.0))
 		, marker_color(0), outline_color(0), fill_color(0)
 	{
@@ -17,9 +37,9 @@ namespace fullsail_ai {
 	{
 		clearLines();
 	}
-	void Tile::setRadius(double radius)
+	void Tile::setRadius(double radius, TileTopology topology)
 	{
-		x = ((row & 1) ? ((column + 1) << 1) : ((column << 1) | 1)) * radius;
+		x = getHalfColumn(row, column, topology) * radius;
 		y = (row * 3 + 2) * radius / sqrt(3.0);
 	}
 }  // namespace fullsail_ai
@@ -9,11 +9,32 @@
 
 namespace fullsail_ai {
 
-	//! \brief Logical representation of a tile in a hexagonal grid.
+	//! \brief The ways in which a tile map can lay out its tiles, and so which tiles are
+	//! adjacent to each other.
+	//!
+	//! Directions run counter-clockwise from east in every layout, so the direction opposite
+	//! to any other is half the direction count away.
+	enum TileTopology
+	{
+		//! Hexagons, with odd rows drawn half a tile to the right of even rows.  Maps that do
+		//! not name their topology use this one.
+		HEX_ODD_ROWS,
+
+		//! Hexagons, with even rows drawn half a tile to the right of odd rows.
+		HEX_EVEN_ROWS,
+
+		//! Squares, each adjacent to the four that share an edge with it.
+		SQUARE_FOUR,
+
+		//! Squares, each adjacent to the eight that share an edge or a corner with it.
+		SQUARE_EIGHT
+	};
+
+	//! \brief Logical representation of a tile in a grid.
 	//!
 	//! Once a tile map is loaded, the application displays each tile as either an obstacle
-	//! (if its weight is zero) or a white/gray hexagon (otherwise).  The smaller the weight,
-	//! the lighter the color.
+	//! (if its weight is zero) or a white/gray hexagon or square (otherwise).  The smaller
+	//! the weight, the lighter the color.
 	class Tile;
 
 	struct Line
@@ -43,9 +64,9 @@ namespace fullsail_ai {
 		unsigned int marker_color, outline_color, fill_color;
 		std::vector<std::pair<const Tile*,unsigned> > lines;
 
-		Tile(int r, int c, double radius, unsigned char data);
+		Tile(int r, int c, double radius, unsigned char data, TileTopology topology);
 		~Tile();
-		void setRadius(double radius);
+		void setRadius(double radius, TileTopology topology);
 
 		// Converts between SBGR and LRGB
 		inline int convertColorModel(int color)
@@ -3,14 +3,15 @@
 namespace fullsail_ai {
 
 	TileMap::TileMap()
-		: row_count(0), column_count(0), tiles(0), tile_radius(0.0), weight_sum_squared(0)
+		: row_count(0), column_count(0), tiles(0), tile_radius(0.0), topology(HEX_ODD_ROWS)
+		, statistics(), version(0)
 	{
 	}
 
 	TileMap::TileMap(TileMap const& copy)
 		: row_count(copy.row_count), column_count(copy.column_count)
 		, tiles(new Tile*[row_count * column_count]), tile_radius(copy.tile_radius)
-		, weight_sum_squared(copy.weight_sum_squared)
+		, topology(copy.topology), statistics(copy.statistics), version(copy.version)
 	{
 		int n = row_count * column_count;
 
@@ -42,7 +43,9 @@ namespace fullsail_ai {
 			column_count = copy.row_count;
 			tiles = new Tile*[row_count * column_count];
 			tile_radius = copy.tile_radius;
-			weight_sum_squared = copy.weight_sum_squared;
+			topology = copy.topology;
+			statistics = copy.statistics;
+			version = copy.version + 1;
 
 			int n = row_count * column_count;
 
@@ -80,7 +83,8 @@ namespace fullsail_ai {
 			tiles = 0;
 		}
 
-		weight_sum_squared = 0;
+		statistics.reset(0, 0);
+		++version;
 	}
 
 	void TileMap::setRadius(double radius)
@@ -95,23 +99,52 @@ namespace fullsail_ai {
 			{
 				if (tiles[--n])
 				{
-					tiles[n]->setRadius(tile_radius);
+					tiles[n]->setRadius(tile_radius, topology);
 				}
 			}
 		}
 	}
 
+	void TileMap::setTopology(TileTopology new_topology)
+	{
+		if (topology == new_topology)
+		{
+			return;
+		}
+
+		topology = new_topology;
+		++version;
+		setRadius(tile_radius);
+	}
+
 	void TileMap::createTileArray(int num_rows, int num_columns)
 	{
 		reset();
-		tiles = new Tile*[num_rows * num_columns];
+		tiles = new Tile*[num_rows * num_columns]();
 		row_count = num_rows;
 		column_count = num_columns;
+		statistics.reset(num_rows, num_columns);
 	}
 
 	void TileMap::addTile(int row, int column, unsigned char data)
 	{
-		tiles[row * column_count + column] = new Tile(row, column, tile_radius, data);
+		Tile*& tile = tiles[row * column_count + column];
+		Tile* const old_tile = tile;
+
+		tile = new Tile(row, column, tile_radius, data, topology);
+
+		if (old_tile)
+		{
+			statistics.removeWeight(getView(), row, column, old_tile->getWeight());
+			statistics.addWeight(row, column, data);
+			delete old_tile;
+		}
+		else
+		{
+			statistics.addTile(row, column, data);
+		}
+
+		++version;
 	}
 
 	Tile* TileMap::getTile(int row, int column) const
@@ -127,16 +160,20 @@ namespace fullsail_ai {
 		}
 	}
 
-	void TileMap::computeWeightSumSquared()
+	unsigned char TileMap::setTileWeight(int row, int column, unsigned char data)
 	{
-		unsigned int i = row_count * column_count;
+		Tile* tile = tiles[row * column_count + column];
+		unsigned char old_weight = tile->weight;
 
-		while (i)
+		if (old_weight != data)
 		{
-			weight_sum_squared += tiles[--i]->getWeight();
+			tile->weight = data;
+			statistics.removeWeight(getView(), row, column, old_weight);
+			statistics.addWeight(row, column, data);
+			++version;
 		}
 
-		weight_sum_squared *= weight_sum_squared;
+		return old_weight;
 	}
 
 	void TileMap::resetTileDrawing()
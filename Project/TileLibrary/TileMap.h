@@ -6,6 +6,8 @@
 
 #include "../platform.h"
 #include "Tile.h"
+#include "TileMapStatistics.h"
+#include "TileMapView.h"
 
 namespace fullsail_ai {
 
@@ -19,7 +21,9 @@ namespace fullsail_ai {
 		int column_count;
 		Tile** tiles;
 		double tile_radius;
-		unsigned int weight_sum_squared;
+		TileTopology topology;
+		TileMapStatistics statistics;
+		unsigned int version;
 
 	public:
 		//! \brief Constructs a new <code>%TileMap</code> object.
@@ -43,7 +47,7 @@ namespace fullsail_ai {
 		DLLEXPORT ~TileMap();
 
 		//! \brief Cleans up the underlying tiles and array memory.  Also zeroes the row count,
-		//! the column count, and the tile radius.
+		//! the column count, and the tile radius.  Keeps the topology.
 		//!
 		//! The application must reset any search algorithms using this tile map after invoking
 		//! this method.
@@ -61,6 +65,12 @@ namespace fullsail_ai {
 		//! reset any search algorithms using this tile map after invoking this method.
 		DLLEXPORT void setRadius(double radius);
 
+		//! \brief Sets the layout of the tiles, and so which tiles are adjacent.
+		//!
+		//! Also moves any tiles previously created.  The application must therefore reset any
+		//! search algorithms using this tile map after invoking this method.
+		DLLEXPORT void setTopology(TileTopology topology);
+
 		//! \brief Creates a <code>Tile</code> object and adds it to the appropriate location in
 		//! the array.
 		//!
@@ -83,14 +93,20 @@ namespace fullsail_ai {
 		//!          coordinates are out of bounds.
 		DLLEXPORT Tile* getTile(int row, int column) const;
 
-		//! \brief Computes the square of all tile weights added together.
+		//! \brief Changes the terrain weight of the tile at the specified location.
 		//!
-		//! The application must reset any search algorithms using this tile map after invoking
-		//! this method.
+		//! Increments the map version, so any search results or cached fields computed
+		//! against the previous weights can tell that they are stale, and updates the
+		//! statistics returned by <code>getStatistics()</code>.
+		//!
+		//! \param   row     the row-coordinate of the tile's location.
+		//! \param   column  the column-coordinate of the tile's location.
+		//! \param   data    the new weight of the tile, or zero to make it impassable.
+		//! \return  the previous weight of the tile.
 		//!
 		//! \pre
-		//!   - The underlying tile array must not be <code>NULL</code>.
-		DLLEXPORT void computeWeightSumSquared();
+		//!   - The coordinates must be in bounds.
+		DLLEXPORT unsigned char setTileWeight(int row, int column, unsigned char data);
 
 		//! \brief Resets all drawing colors set in the tiles to transparent black (0x00000000).
 		//!
@@ -98,10 +114,26 @@ namespace fullsail_ai {
 		//!   - The underlying tile array must not be <code>NULL</code>.
 		DLLEXPORT void resetTileDrawing();
 
-		//! \brief Returns the square of all tile weights added together.
-		inline unsigned int getWeightSumSquared() const
+		//! \brief Returns a view through which other modules can look tiles up inline.
+		//!
+		//! The view does not copy the tiles.  It is invalidated by <code>reset()</code>,
+		//! <code>createTileArray()</code> and assignment.
+		inline TileMapView getView() const
+		{
+			return TileMapView(tiles, row_count, column_count);
+		}
+
+		//! \brief Returns the weight sum, histogram, extremes and obstacle bounds of the tiles,
+		//! which are kept up to date as tiles are added and reweighted.
+		inline TileMapStatistics const& getStatistics() const
 		{
-			return weight_sum_squared;
+			return statistics;
+		}
+
+		//! \brief Returns a counter that changes whenever the tiles or their weights change.
+		inline unsigned int getVersion() const
+		{
+			return version;
 		}
 
 		//! \brief Returns one past the upper bound of a tile's row coordinate.
@@ -121,5 +153,11 @@ namespace fullsail_ai {
 		{
 			return tile_radius;
 		}
+
+		//! \brief Returns the layout of the tiles.
+		inline TileTopology getTopology() const
+		{
+			return topology;
+		}
 	};
 }  // namespace fullsail_ai
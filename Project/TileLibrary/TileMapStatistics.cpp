@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "TileMapStatistics.h"
+
+namespace fullsail_ai {
+
+	namespace {
+
+		TileBounds const EMPTY_BOUNDS = { 0, 0, -1, -1 };
+
+		void extend(TileBounds& bounds, int row, int column)
+		{
+			if (bounds.isEmpty())
+			{
+				bounds.top_row = bounds.bottom_row = row;
+				bounds.left_column = bounds.right_column = column;
+				return;
+			}
+
+			bounds.top_row = (std::min)(bounds.top_row, row);
+			bounds.bottom_row = (std::max)(bounds.bottom_row, row);
+			bounds.left_column = (std::min)(bounds.left_column, column);
+			bounds.right_column = (std::max)(bounds.right_column, column);
+		}
+
+		bool isOnEdge(TileBounds const& bounds, int row, int column)
+		{
+			return (row == bounds.top_row) || (row == bounds.bottom_row)
+			    || (column == bounds.left_column) || (column == bounds.right_column);
+		}
+
+		// Returns true if every edge of the outer bounds through the specified tile is also
+		// an edge of the inner bounds.
+		bool isHeldOut(TileBounds const& outer, TileBounds const& inner, int row, int column)
+		{
+			return !inner.isEmpty()
+			    && ((row != outer.top_row) || (inner.top_row == outer.top_row))
+			    && ((row != outer.bottom_row) || (inner.bottom_row == outer.bottom_row))
+			    && ((column != outer.left_column) || (inner.left_column == outer.left_column))
+			    && ((column != outer.right_column) || (inner.right_column == outer.right_column));
+		}
+
+		bool hasObstacle(TileMapView const& view, int top_row, int left_column, int bottom_row,
+		                 int right_column)
+		{
+			for (int row = top_row; row <= bottom_row; ++row)
+			{
+				for (int column = left_column; column <= right_column; ++column)
+				{
+					Tile const* const tile = view.getTile(row, column);
+
+					// Tiles not added yet are not counted.
+					if (tile && !tile->getWeight())
+					{
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+	}
+
+	int const TileMapStatistics::SECTOR_SIZE;
+
+	TileMapStatistics::TileMapStatistics()
+		: weight_sum(0), tile_count(0), minimum_weight(0), maximum_weight(0), sector_row_count(0)
+		, sector_column_count(0), sector_obstacle_counts(), sector_bounds()
+		, obstacle_bounds(EMPTY_BOUNDS)
+	{
+		std::fill(weight_counts, weight_counts + 256, 0u);
+	}
+
+	void TileMapStatistics::reset(int row_count, int column_count)
+	{
+		weight_sum = 0;
+		std::fill(weight_counts, weight_counts + 256, 0u);
+		tile_count = 0;
+		minimum_weight = maximum_weight = 0;
+		sector_row_count = (row_count + SECTOR_SIZE - 1) / SECTOR_SIZE;
+		sector_column_count = (column_count + SECTOR_SIZE - 1) / SECTOR_SIZE;
+		sector_obstacle_counts.assign(sector_row_count * sector_column_count, 0);
+		sector_bounds.assign(sector_obstacle_counts.size(), EMPTY_BOUNDS);
+		obstacle_bounds = EMPTY_BOUNDS;
+	}
+
+	void TileMapStatistics::addTile(int row, int column, unsigned char weight)
+	{
+		++tile_count;
+		addWeight(row, column, weight);
+	}
+
+	void TileMapStatistics::addWeight(int row, int column, unsigned char weight)
+	{
+		weight_sum += weight;
+		++weight_counts[weight];
+
+		if (weight)
+		{
+			if (!minimum_weight || (weight < minimum_weight))
+			{
+				minimum_weight = weight;
+			}
+
+			if (maximum_weight < weight)
+			{
+				maximum_weight = weight;
+			}
+
+			return;
+		}
+
+		int const sector = row / SECTOR_SIZE * sector_column_count + column / SECTOR_SIZE;
+
+		++sector_obstacle_counts[sector];
+		extend(sector_bounds[sector], row, column);
+		extend(obstacle_bounds, row, column);
+	}
+
+	void TileMapStatistics::removeWeight(TileMapView const& view, int row, int column,
+	                                     unsigned char weight)
+	{
+		weight_sum -= weight;
+		--weight_counts[weight];
+
+		if (weight)
+		{
+			if (!weight_counts[weight]
+			 && ((weight == minimum_weight) || (weight == maximum_weight)))
+			{
+				updateExtremes();
+			}
+
+			return;
+		}
+
+		int const sector_row = row / SECTOR_SIZE;
+		int const sector_column = column / SECTOR_SIZE;
+		int const sector = sector_row * sector_column_count + sector_column;
+		TileBounds& bounds = sector_bounds[sector];
+
+		// Only an obstacle on an edge of the bounds can have been holding that edge out.
+		if (!--sector_obstacle_counts[sector])
+		{
+			bounds = EMPTY_BOUNDS;
+		}
+		else if (isOnEdge(bounds, row, column))
+		{
+			// An obstacle is left, so every edge stops before crossing the opposite one.
+			while (!hasObstacle(view, bounds.top_row, bounds.left_column, bounds.top_row,
+			                    bounds.right_column))
+			{
+				++bounds.top_row;
+			}
+
+			while (!hasObstacle(view, bounds.bottom_row, bounds.left_column, bounds.bottom_row,
+			                    bounds.right_column))
+			{
+				--bounds.bottom_row;
+			}
+
+			while (!hasObstacle(view, bounds.top_row, bounds.left_column, bounds.bottom_row,
+			                    bounds.left_column))
+			{
+				++bounds.left_column;
+			}
+
+			while (!hasObstacle(view, bounds.top_row, bounds.right_column, bounds.bottom_row,
+			                    bounds.right_column))
+			{
+				--bounds.right_column;
+			}
+		}
+
+		if (!weight_counts[0])
+		{
+			obstacle_bounds = EMPTY_BOUNDS;
+		}
+		else if (isOnEdge(obstacle_bounds, row, column)
+		      && !isHeldOut(obstacle_bounds, bounds, row, column))
+		{
+			obstacle_bounds = EMPTY_BOUNDS;
+
+			for (std::size_t i = 0; i < sector_bounds.size(); ++i)
+			{
+				if (!sector_bounds[i].isEmpty())
+				{
+					extend(obstacle_bounds, sector_bounds[i].top_row, sector_bounds[i].left_column);
+					extend(obstacle_bounds, sector_bounds[i].bottom_row,
+					       sector_bounds[i].right_column);
+				}
+			}
+		}
+	}
+
+	void TileMapStatistics::updateExtremes()
+	{
+		int weight = 1;
+
+		while ((weight < 256) && !weight_counts[weight])
+		{
+			++weight;
+		}
+
+		minimum_weight = static_cast<unsigned char>((weight < 256) ? weight : 0);
+		weight = 255;
+
+		while (weight && !weight_counts[weight])
+		{
+			--weight;
+		}
+
+		maximum_weight = static_cast<unsigned char>(weight);
+	}
+}  // namespace fullsail_ai
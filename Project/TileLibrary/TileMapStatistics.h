@@ -0,0 +1,149 @@
+//! \file TileMapStatistics.h
+//! \brief Defines the <code>fullsail_ai::TileMapStatistics</code> class.
+#pragma once
+
+#include <vector>
+
+#include "../platform.h"
+#include "TileMapView.h"
+
+namespace fullsail_ai {
+
+	//! \brief Inclusive rectangle of tile coordinates.
+	struct TileBounds
+	{
+		int top_row;
+		int left_column;
+		int bottom_row;
+		int right_column;
+
+		//! \brief Returns <code>true</code> if the rectangle holds no tile, <code>false</code>
+		//! otherwise.
+		inline bool isEmpty() const
+		{
+			return bottom_row < top_row;
+		}
+
+		//! \brief Returns <code>true</code> if the specified location lies in the rectangle,
+		//! <code>false</code> otherwise.
+		inline bool contains(int row, int column) const
+		{
+			return (top_row <= row) && (row <= bottom_row) && (left_column <= column)
+			    && (column <= right_column);
+		}
+	};
+
+	//! \brief Summary of the weights of a <code>TileMap</code>, kept up to date by the map as
+	//! tiles are added and reweighted.
+	//!
+	//! Every value is read in constant time.  An edit costs constant time too, except that
+	//! clearing an obstacle on the edge of its sector's bounds pulls that edge in a line of the
+	//! sector at a time, and clearing one that leaves its sector short of an edge of the map's
+	//! bounds looks at every sector's bounds.
+	//!
+	//! The obstacles are bounded per square sector of <code>SECTOR_SIZE</code> tiles a side
+	//! rather than per connected region: which tiles touch depends on the topology, and finding
+	//! regions is the business of SearchLibrary.
+	class TileMapStatistics
+	{
+		friend class TileMap;
+
+	public:
+		//! \brief The number of tiles along each side of a sector.
+		static int const SECTOR_SIZE = 16;
+
+	private:
+		unsigned long long weight_sum;
+		unsigned int weight_counts[256];
+		unsigned int tile_count;
+		unsigned char minimum_weight;
+		unsigned char maximum_weight;
+		int sector_row_count;
+		int sector_column_count;
+		std::vector<unsigned int> sector_obstacle_counts;
+		std::vector<TileBounds> sector_bounds;
+		TileBounds obstacle_bounds;
+
+		void reset(int row_count, int column_count);
+		void addTile(int row, int column, unsigned char weight);
+		void addWeight(int row, int column, unsigned char weight);
+		void removeWeight(TileMapView const& view, int row, int column, unsigned char weight);
+		void updateExtremes();
+
+	public:
+		//! \brief Constructs the statistics of a map without tiles.
+		DLLEXPORT TileMapStatistics();
+
+		//! \brief Returns the sum of the weights of every tile.
+		inline unsigned long long getWeightSum() const
+		{
+			return weight_sum;
+		}
+
+		//! \brief Returns the number of tiles of the specified weight, zero counting the
+		//! impassable ones.
+		inline unsigned int getWeightCount(unsigned char weight) const
+		{
+			return weight_counts[weight];
+		}
+
+		//! \brief Returns the number of tiles added to the map.
+		inline unsigned int getTileCount() const
+		{
+			return tile_count;
+		}
+
+		//! \brief Returns the number of tiles with a non-zero weight.
+		inline unsigned int getPassableCount() const
+		{
+			return tile_count - weight_counts[0];
+		}
+
+		//! \brief Returns the smallest non-zero weight, or zero if no tile is passable.
+		//!
+		//! Every step costs at least this much, so a heuristic that counts steps stays
+		//! admissible when scaled by it.
+		inline unsigned char getMinimumWeight() const
+		{
+			return minimum_weight;
+		}
+
+		//! \brief Returns the largest weight, or zero if no tile is passable.
+		inline unsigned char getMaximumWeight() const
+		{
+			return maximum_weight;
+		}
+
+		//! \brief Returns the smallest rectangle holding every impassable tile, which is empty
+		//! if there are none.
+		inline TileBounds const& getObstacleBounds() const
+		{
+			return obstacle_bounds;
+		}
+
+		//! \brief Returns the number of sector rows, the last of which may be short.
+		inline int getSectorRowCount() const
+		{
+			return sector_row_count;
+		}
+
+		//! \brief Returns the number of sector columns, the last of which may be narrow.
+		inline int getSectorColumnCount() const
+		{
+			return sector_column_count;
+		}
+
+		//! \brief Returns the number of impassable tiles in the specified sector.
+		inline unsigned int getSectorObstacleCount(int sector_row, int sector_column) const
+		{
+			return sector_obstacle_counts[sector_row * sector_column_count + sector_column];
+		}
+
+		//! \brief Returns the smallest rectangle holding every impassable tile of the specified
+		//! sector, which is empty if there are none.
+		inline TileBounds const& getSectorObstacleBounds(int sector_row, int sector_column) const
+		{
+			return sector_bounds[sector_row * sector_column_count + sector_column];
+		}
+	};
+}  // namespace fullsail_ai
@@ -0,0 +1,81 @@
+//! \file TileMapView.h
+//! \brief Defines the <code>fullsail_ai::TileMapView</code> class.
+#pragma once
+
+#include "Tile.h"
+
+namespace fullsail_ai {
+
+	//! \brief Non-owning, header-only view of the tiles of a <code>TileMap</code>.
+	//!
+	//! <code>TileMap::getTile()</code> is exported from TileLibrary, so every call to it from
+	//! another module goes through the import table and cannot be inlined.  A view holds the
+	//! map's tile array and dimensions, so the same lookups compile down to a bounds check and
+	//! a load in the caller.  Obtain one with <code>TileMap::getView()</code>; it stays valid
+	//! until the map's tile array is created, reset or reassigned.
+	class TileMapView
+	{
+		Tile* const* tiles;
+		int row_count;
+		int column_count;
+
+	public:
+		//! \brief Constructs a view of an empty map.
+		inline TileMapView() : tiles(0), row_count(0), column_count(0)
+		{
+		}
+
+		//! \brief Constructs a view of the specified row-major tile array.
+		inline TileMapView(Tile* const* tile_array, int rows, int columns)
+			: tiles(tile_array), row_count(rows), column_count(columns)
+		{
+		}
+
+		//! \brief Returns <code>true</code> if the specified location lies on the map,
+		//! <code>false</code> otherwise.
+		inline bool contains(int row, int column) const
+		{
+			// One unsigned comparison per coordinate also rejects negative values.
+			return (static_cast<unsigned int>(row) < static_cast<unsigned int>(row_count))
+			    && (static_cast<unsigned int>(column) < static_cast<unsigned int>(column_count));
+		}
+
+		//! \brief Returns the tile at the specified location, or <code>NULL</code> if either of
+		//! the coordinates are out of bounds, as <code>TileMap::getTile()</code> does.
+		inline Tile* getTile(int row, int column) const
+		{
+			return contains(row, column) ? tiles[row * column_count + column] : 0;
+		}
+
+		//! \brief Returns the tile at the specified row-major index, without a bounds check.
+		inline Tile* getTile(int index) const
+		{
+			return tiles[index];
+		}
+
+		//! \brief Returns the weight of the tile at the specified location, or zero if the
+		//! location is off the map.
+		inline unsigned char getWeight(int row, int column) const
+		{
+			return contains(row, column) ? tiles[row * column_count + column]->getWeight() : 0;
+		}
+
+		//! \brief Returns the row-major index of the specified location.
+		inline int getIndex(int row, int column) const
+		{
+			return row * column_count + column;
+		}
+
+		//! \brief Returns one past the upper bound of a tile's row coordinate.
+		inline int getRowCount() const
+		{
+			return row_count;
+		}
+
+		//! \brief Returns one past the upper bound of a tile's column coordinate.
+		inline int getColumnCount() const
+		{
+			return column_count;
+		}
+	};
+}  // namespace fullsail_ai
@@ -0,0 +1,556 @@
+// Generates large synthetic maps in the "rows columns / weights" text format read by load().
+//
+// usage: map-generator [--family noise|dungeon|maze|open] [--rows R] [--columns C] [--seed S]
+//                      [--density D] [--bands B] [--scale N] [--rooms N] [--topology T]
+//                      <map file|->
+//
+// Families:
+//   noise    smooth value-noise terrain.  The lowest D fraction of tiles is impassable and the
+//            rest is split into B equally common bands with weights 1, 2, 4, ...
+//   dungeon  about N rectangular rooms of mixed terrain, joined by corridors of weight 1, on
+//            solid rock.
+//   maze     a perfect maze carved by a depth-first walk, with passages of weight 1.
+//   open     weight 1 everywhere, with a D fraction of tiles blocked at random.
+//
+// The topology is one of the names accepted by load(), hex-odd-r by default.  Only maps of
+// another topology name it in the file, so default maps stay readable by older builds.
+//
+// The output depends only on the options, so a seed names a map as well as the file does.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "RandomDraw.h"
+
+using namespace std;
+using namespace fullsail_ai;
+
+typedef chrono::high_resolution_clock Clock;
+
+static int const MAX_SIDE = 16384;
+static int const MAX_BAND_COUNT = 8;
+static int const OCTAVE_COUNT = 4;
+
+struct Options
+{
+	string family;
+	int row_count;
+	int column_count;
+	unsigned long long seed;
+	double density;
+	int band_count;
+	int scale;
+	int room_count;
+	TileTopology topology;
+	string map_file;
+};
+
+struct Room
+{
+	int row;
+	int column;
+	int row_count;
+	int column_count;
+};
+
+static inline size_t getIndex(Options const& options, int row, int column)
+{
+	return static_cast<size_t>(row) * options.column_count + column;
+}
+
+// A well-mixed hash of a lattice point, so noise does not depend on the order tiles are visited.
+static inline unsigned long long hashLattice(unsigned long long seed, int octave, int x, int y)
+{
+	unsigned long long h = seed ^ (static_cast<unsigned long long>(octave) << 56);
+
+	h ^= static_cast<unsigned int>(x) * 0x9E3779B97F4A7C15ull;
+	h ^= static_cast<unsigned long long>(static_cast<unsigned int>(y)) * 0xC2B2AE3D27D4EB4Full;
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDull;
+	h ^= h >> 33;
+	h *= 0xC4CEB9FE1A85EC53ull;
+	h ^= h >> 33;
+	return h;
+}
+
+static inline double getLatticeValue(unsigned long long seed, int octave, int x, int y)
+{
+	return (hashLattice(seed, octave, x, y) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline double smooth(double t)
+{
+	return t * t * (3.0 - 2.0 * t);
+}
+
+static void generateNoise(Options const& options, vector<unsigned char>& weights)
+{
+	// Quantize first, then pick band thresholds from the histogram, so that the impassable
+	// fraction and the band shares hold exactly whatever the noise distribution looks like.
+	unsigned long long histogram[256] = {};
+	vector<double> sums(options.column_count);
+
+	for (int row = 0; row < options.row_count; ++row)
+	{
+		double amplitude = 1.0;
+		double total_amplitude = 0.0;
+		int period = options.scale;
+
+		fill(sums.begin(), sums.end(), 0.0);
+
+		// Walk each octave a lattice cell at a time, so each corner is hashed once per cell
+		// rather than once per tile.
+		for (int octave = 0; octave < OCTAVE_COUNT; ++octave)
+		{
+			int const y = row / period;
+			double const v = smooth((row % period) / static_cast<double>(period));
+
+			for (int x = 0; x * period < options.column_count; ++x)
+			{
+				double const left = getLatticeValue(options.seed, octave, x, y) * (1.0 - v)
+				                  + getLatticeValue(options.seed, octave, x, y + 1) * v;
+				double const right = getLatticeValue(options.seed, octave, x + 1, y) * (1.0 - v)
+				                   + getLatticeValue(options.seed, octave, x + 1, y + 1) * v;
+				int const end = min((x + 1) * period, options.column_count);
+
+				for (int column = x * period; column < end; ++column)
+				{
+					double const u = smooth((column - x * period) / static_cast<double>(period));
+
+					sums[column] += (left * (1.0 - u) + right * u) * amplitude;
+				}
+			}
+
+			total_amplitude += amplitude;
+			amplitude *= 0.5;
+			period = max(period / 2, 1);
+		}
+
+		for (int column = 0; column < options.column_count; ++column)
+		{
+			int const level = min(static_cast<int>(sums[column] / total_amplitude * 256.0), 255);
+
+			weights[getIndex(options, row, column)] = static_cast<unsigned char>(level);
+			++histogram[level];
+		}
+	}
+
+	unsigned long long const tile_count = weights.size();
+	unsigned long long const blocked_count
+		= static_cast<unsigned long long>(options.density * tile_count);
+	unsigned char level_weights[256];
+	unsigned long long below = 0;
+
+	for (int level = 0; level < 256; ++level)
+	{
+		if (below < blocked_count)
+		{
+			level_weights[level] = 0;
+		}
+		else
+		{
+			unsigned long long const passable_count = tile_count - blocked_count;
+			int const band = passable_count ? static_cast<int>((below - blocked_count)
+			                                  * options.band_count / passable_count) : 0;
+
+			level_weights[level] = static_cast<unsigned char>(1 << min(band, options.band_count - 1));
+		}
+
+		below += histogram[level];
+	}
+
+	for (size_t i = 0; i < weights.size(); ++i)
+	{
+		weights[i] = level_weights[weights[i]];
+	}
+}
+
+static void carveCorridor(Options const& options, vector<unsigned char>& weights, int from_row,
+                          int from_column, int to_row, int to_column)
+{
+	// Runs along a row and down a column are both connected in the hex layout: (r, c) and
+	// (r + 1, c) are always neighbours, whatever the parity of r.
+	int const step = (from_column < to_column) ? 1 : -1;
+
+	for (int column = from_column; column != to_column; column += step)
+	{
+		unsigned char& weight = weights[getIndex(options, from_row, column)];
+
+		weight = weight ? weight : 1;
+	}
+
+	int const row_step = (from_row < to_row) ? 1 : -1;
+
+	for (int row = from_row; row != to_row + row_step; row += row_step)
+	{
+		unsigned char& weight = weights[getIndex(options, row, to_column)];
+
+		weight = weight ? weight : 1;
+	}
+}
+
+static void generateDungeon(Options const& options, vector<unsigned char>& weights,
+                            mt19937_64& generator)
+{
+	// The map is cut into square sectors, one per requested room, and each sector holds at most
+	// one room with rock on every side.  Rooms then never overlap, and corridors only join
+	// rooms in neighbouring sectors, so the work stays linear in the map size.
+	int const sector_side = max(5, static_cast<int>(sqrt(static_cast<double>(options.row_count)
+	                                                     * options.column_count / options.room_count)));
+	int const sector_row_count = max(1, options.row_count / sector_side);
+	int const sector_column_count = max(1, options.column_count / sector_side);
+	int const sector_height = options.row_count / sector_row_count;
+	int const sector_width = options.column_count / sector_column_count;
+	vector<int> sector_rooms(static_cast<size_t>(sector_row_count) * sector_column_count, -1);
+	vector<Room> rooms;
+
+	fill(weights.begin(), weights.end(), 0);
+
+	for (int sector_row = 0; sector_row < sector_row_count; ++sector_row)
+	{
+		for (int sector_column = 0; sector_column < sector_column_count; ++sector_column)
+		{
+			if (drawChance(generator, 0.2) || (sector_height < 3) || (sector_width < 3))
+			{
+				continue;
+			}
+
+			Room room;
+
+			room.row_count = drawInt(generator, 1, sector_height - 2);
+			room.column_count = drawInt(generator, 1, sector_width - 2);
+			room.row = sector_row * sector_height
+			         + drawInt(generator, 1, sector_height - room.row_count - 1);
+			room.column = sector_column * sector_width
+			            + drawInt(generator, 1, sector_width - room.column_count - 1);
+
+			unsigned char const terrain = static_cast<unsigned char>(drawInt(generator, 1, 4));
+
+			for (int row = room.row; row < room.row + room.row_count; ++row)
+			{
+				for (int column = room.column; column < room.column + room.column_count; ++column)
+				{
+					weights[getIndex(options, row, column)] = terrain;
+				}
+			}
+
+			// Join the room to its western and northern neighbours, or failing both to the last
+			// room placed, so that every room is reachable from the first.
+			size_t const sector = static_cast<size_t>(sector_row) * sector_column_count + sector_column;
+			int const west = sector_column ? sector_rooms[sector - 1] : -1;
+			int const north = sector_row ? sector_rooms[sector - sector_column_count] : -1;
+			int neighbors[2] = { west, north };
+
+			if ((west < 0) && (north < 0))
+			{
+				neighbors[0] = static_cast<int>(rooms.size()) - 1;
+			}
+
+			for (int i = 0; i < 2; ++i)
+			{
+				if (neighbors[i] < 0)
+				{
+					continue;
+				}
+
+				Room const& other = rooms[neighbors[i]];
+
+				carveCorridor(options, weights, room.row + room.row_count / 2,
+				              room.column + room.column_count / 2, other.row + other.row_count / 2,
+				              other.column + other.column_count / 2);
+			}
+
+			sector_rooms[sector] = static_cast<int>(rooms.size());
+			rooms.push_back(room);
+		}
+	}
+}
+
+static void generateMaze(Options const& options, vector<unsigned char>& weights,
+                         mt19937_64& generator)
+{
+	// Cells sit on even rows and columns, and walls between them are knocked out on the way.
+	// Each visited cell temporarily holds the direction back to its parent (1 for the root), so
+	// the walk needs no stack beyond the map itself.
+	static int const CELL_OFFSETS[4][2] = { { 0, 2 }, { -2, 0 }, { 0, -2 }, { 2, 0 } };
+	static unsigned char const ROOT = 1;
+	static unsigned char const PASSAGE = 6;
+	int const cell_row_count = (options.row_count + 1) / 2;
+	int const cell_column_count = (options.column_count + 1) / 2;
+
+	fill(weights.begin(), weights.end(), 0);
+
+	int row = 2 * drawInt(generator, 0, cell_row_count - 1);
+	int column = 2 * drawInt(generator, 0, cell_column_count - 1);
+
+	weights[getIndex(options, row, column)] = ROOT;
+
+	for (;;)
+	{
+		int candidates[4];
+		int candidate_count = 0;
+
+		for (int direction = 0; direction < 4; ++direction)
+		{
+			int const next_row = row + CELL_OFFSETS[direction][0];
+			int const next_column = column + CELL_OFFSETS[direction][1];
+
+			if ((0 <= next_row) && (next_row < options.row_count) && (0 <= next_column)
+			 && (next_column < options.column_count) && !weights[getIndex(options, next_row, next_column)])
+			{
+				candidates[candidate_count++] = direction;
+			}
+		}
+
+		if (candidate_count)
+		{
+			int const direction = candidates[drawInt(generator, 0, candidate_count - 1)];
+
+			weights[getIndex(options, row + CELL_OFFSETS[direction][0] / 2,
+			                 column + CELL_OFFSETS[direction][1] / 2)] = PASSAGE;
+			row += CELL_OFFSETS[direction][0];
+			column += CELL_OFFSETS[direction][1];
+
+			// Store the direction back: opposite directions are two apart.
+			weights[getIndex(options, row, column)]
+				= static_cast<unsigned char>(2 + (direction + 2) % 4);
+			continue;
+		}
+
+		unsigned char const back = weights[getIndex(options, row, column)];
+
+		if (back == ROOT)
+		{
+			break;
+		}
+
+		row += CELL_OFFSETS[back - 2][0];
+		column += CELL_OFFSETS[back - 2][1];
+	}
+
+	for (size_t i = 0; i < weights.size(); ++i)
+	{
+		weights[i] = weights[i] ? 1 : 0;
+	}
+}
+
+static void generateOpen(Options const& options, vector<unsigned char>& weights,
+                         mt19937_64& generator)
+{
+	for (size_t i = 0; i < weights.size(); ++i)
+	{
+		weights[i] = drawChance(generator, options.density) ? 0 : 1;
+	}
+}
+
+static bool save(ostream& output, Options const& options, vector<unsigned char> const& weights)
+{
+	// Formatting by hand keeps a 16k x 16k map to seconds rather than minutes.
+	vector<char> line;
+
+	line.reserve(static_cast<size_t>(options.column_count) * 4 + 2);
+	if (options.topology != HEX_ODD_ROWS)
+	{
+		output << getTopologyName(options.topology) << '\n';
+	}
+
+	output << options.row_count << ' ' << options.column_count << '\n';
+
+	for (int row = 0; row < options.row_count; ++row)
+	{
+		line.clear();
+
+		// Rows drawn half a tile to the right are indented.
+		if (((options.topology == HEX_ODD_ROWS) && (row & 1))
+		 || ((options.topology == HEX_EVEN_ROWS) && !(row & 1)))
+		{
+			line.push_back(' ');
+		}
+
+		for (int column = 0; column < options.column_count; ++column)
+		{
+			unsigned int const weight = weights[getIndex(options, row, column)];
+
+			if (column)
+			{
+				line.push_back(' ');
+			}
+
+			if (100 <= weight)
+			{
+				line.push_back(static_cast<char>('0' + weight / 100));
+			}
+
+			if (10 <= weight)
+			{
+				line.push_back(static_cast<char>('0' + weight / 10 % 10));
+			}
+
+			line.push_back(static_cast<char>('0' + weight % 10));
+		}
+
+		line.push_back('\n');
+		output.write(&line[0], line.size());
+	}
+
+	return static_cast<bool>(output.flush());
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options)
+{
+	options.family = "noise";
+	options.row_count = 1024;
+	options.column_count = 1024;
+	options.seed = 2016;
+	options.density = -1.0;
+	options.band_count = 4;
+	options.scale = 64;
+	options.room_count = -1;
+	options.topology = HEX_ODD_ROWS;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--family") && (i + 1 < argc))
+		{
+			options.family = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--rows") && (i + 1 < argc))
+		{
+			options.row_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--columns") && (i + 1 < argc))
+		{
+			options.column_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--seed") && (i + 1 < argc))
+		{
+			options.seed = strtoull(argv[++i], 0, 10);
+		}
+		else if (!strcmp(argv[i], "--density") && (i + 1 < argc))
+		{
+			options.density = atof(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--bands") && (i + 1 < argc))
+		{
+			options.band_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--scale") && (i + 1 < argc))
+		{
+			options.scale = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--rooms") && (i + 1 < argc))
+		{
+			options.room_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--topology") && (i + 1 < argc))
+		{
+			if (!parseTopology(string(argv[++i]), options.topology))
+			{
+				return false;
+			}
+		}
+		else if ((argv[i][0] == '-') && argv[i][1])
+		{
+			return false;
+		}
+		else if (options.map_file.empty())
+		{
+			options.map_file = argv[i];
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	if (options.density < 0.0)
+	{
+		options.density = (options.family == "open") ? 0.2 : 0.15;
+	}
+
+	if (options.room_count < 0)
+	{
+		// Roughly one room per 40 x 40 tiles.
+		options.room_count = max(2, static_cast<int>(static_cast<long long>(options.row_count)
+		                                             * options.column_count / 1600));
+	}
+
+	return !options.map_file.empty() && (0 < options.row_count) && (options.row_count <= MAX_SIDE)
+	    && (0 < options.column_count) && (options.column_count <= MAX_SIDE)
+	    && (0.0 <= options.density) && (options.density < 1.0) && (0 < options.band_count)
+	    && (options.band_count <= MAX_BAND_COUNT) && (0 < options.scale) && (0 < options.room_count)
+	    && ((options.family == "noise") || (options.family == "dungeon")
+	     || (options.family == "maze") || (options.family == "open"));
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		cerr << "usage: " << argv[0] << " [--family noise|dungeon|maze|open] [--rows R]"
+		     << " [--columns C] [--seed S] [--density D] [--bands B] [--scale N] [--rooms N]"
+		     << " [--topology hex-odd-r|hex-even-r|square-4|square-8] <map file|->" << endl
+		     << "Sides are at most " << MAX_SIDE << "; D is in [0, 1); B is at most "
+		     << MAX_BAND_COUNT << "." << endl;
+		return EXIT_FAILURE;
+	}
+
+	Clock::time_point const start_time = Clock::now();
+	vector<unsigned char> weights(static_cast<size_t>(options.row_count) * options.column_count);
+	mt19937_64 generator(options.seed);
+
+	if (options.family == "noise")
+	{
+		generateNoise(options, weights);
+	}
+	else if (options.family == "dungeon")
+	{
+		generateDungeon(options, weights, generator);
+	}
+	else if (options.family == "maze")
+	{
+		generateMaze(options, weights, generator);
+	}
+	else
+	{
+		generateOpen(options, weights, generator);
+	}
+
+	double const generate_time = chrono::duration<double, milli>(Clock::now() - start_time).count();
+	bool is_saved;
+
+	if (options.map_file == "-")
+	{
+		is_saved = save(cout, options, weights);
+	}
+	else
+	{
+		ofstream output(options.map_file.c_str(), ios::binary);
+
+		is_saved = output && save(output, options, weights);
+	}
+
+	if (!is_saved)
+	{
+		cerr << "Could not write " << options.map_file << endl;
+		return EXIT_FAILURE;
+	}
+
+	size_t const passable_count = weights.size() - count(weights.begin(), weights.end(), 0);
+
+	cerr << options.map_file << ": " << options.family << ' ' << options.row_count << 'x'
+	     << options.column_count << ", " << passable_count << " passable tiles; generate "
+	     << generate_time << " ms, total "
+	     << chrono::duration<double, milli>(Clock::now() - start_time).count() << " ms" << endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+//! \file RandomDraw.h
+//! \brief Draws reduced from the raw output of <code>std::mt19937_64</code>, shared by the
+//! generator tools.
+//!
+//! The standard distributions may map the same engine output to different values on different
+//! standard libraries, but the engine's own sequence is fixed by the standard.  Reducing that
+//! sequence by hand makes a seed name the same output on every toolchain.
+#pragma once
+
+#include <random>
+
+namespace fullsail_ai {
+
+	//! \brief Returns a uniform integer in [0, high].
+	inline unsigned long long drawUnsigned(std::mt19937_64& generator, unsigned long long high)
+	{
+		if (high == ~0ull)
+		{
+			return generator();
+		}
+
+		unsigned long long const range = high + 1;
+
+		// Reject the few outputs below 2^64 mod range, so every remainder is equally common.
+		unsigned long long const threshold = (0 - range) % range;
+		unsigned long long draw = generator();
+
+		while (draw < threshold)
+		{
+			draw = generator();
+		}
+
+		return draw % range;
+	}
+
+	//! \brief Returns a uniform integer in [low, high].
+	inline int drawInt(std::mt19937_64& generator, int low, int high)
+	{
+		return low + static_cast<int>(drawUnsigned(generator, static_cast<unsigned long long>(
+			static_cast<long long>(high) - low)));
+	}
+
+	//! \brief Returns <code>true</code> with the specified probability.
+	inline bool drawChance(std::mt19937_64& generator, double probability)
+	{
+		return (generator() >> 11) * (1.0 / 9007199254740992.0) < probability;
+	}
+}  // namespace fullsail_ai
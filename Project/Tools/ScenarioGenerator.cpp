@@ -0,0 +1,459 @@
+// Generates scenario files with reference optimal costs for a map.
+//
+// usage: scenario-generator [--count N] [--goals-per-start K] [--bucket-width W] [--seed S]
+//                           [--threads T] <map file> [scenario file]
+//
+// Starts are drawn from passable tiles whose connected component holds at least two tiles.
+// Each start gets one exact single-source Dijkstra over the whole map.  Its goals are then
+// drawn from the tiles it reached, spread evenly over the non-empty cost buckets, so that
+// every pair is reachable and short and long queries are equally represented.  Starts run
+// in parallel, but every start draws from its own seeded generator, so the output depends
+// only on the map and the options.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Application/PathSearchUtility.h"
+#include "../SearchLibrary/ComponentIndex.h"
+#include "../SearchLibrary/GridTopology.h"
+#include "../SearchLibrary/Scenario.h"
+#include "RandomDraw.h"
+
+using namespace std;
+using namespace fullsail_ai;
+using namespace algorithms;
+
+typedef chrono::high_resolution_clock Clock;
+
+static unsigned int const UNREACHED = ~0u;
+
+// Weights fit in a byte, so a ring of this many buckets always covers the distances that are
+// still pending (Dial's algorithm).
+static int const BUCKET_RING_SIZE = 256;
+
+// Tile weights surrounded by a border of impassable tiles, so that neighbours never need
+// bounds checks.
+struct Grid
+{
+	int row_count;
+	int column_count;
+	int stride;
+	vector<unsigned char> weights;
+	int direction_count;
+	int offsets[2][MAX_DIRECTION_COUNT];
+
+	inline int getIndex(int row, int column) const
+	{
+		return (row + 1) * stride + column + 1;
+	}
+
+	inline int getRow(int index) const
+	{
+		return index / stride - 1;
+	}
+
+	inline int getColumn(int index) const
+	{
+		return index % stride - 1;
+	}
+};
+
+struct Options
+{
+	int count;
+	int goals_per_start;
+	unsigned int bucket_width;
+	unsigned long long seed;
+	unsigned int thread_count;
+	string map_file;
+	string scenario_file;
+};
+
+static double millisecondsSince(Clock::time_point const& start)
+{
+	return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Exact single-source costs, where entering a tile costs its weight.
+static void computeCosts(Grid const& grid, int start, vector<unsigned int>& costs,
+                         vector<vector<int> >& buckets)
+{
+	costs.assign(grid.weights.size(), UNREACHED);
+	buckets.resize(BUCKET_RING_SIZE);
+	costs[start] = 0;
+	buckets[0].assign(1, start);
+
+	size_t pending = 1;
+
+	for (unsigned int cost = 0; pending; ++cost)
+	{
+		vector<int>& bucket = buckets[cost % BUCKET_RING_SIZE];
+
+		// Relaxing a zero-cost edge cannot happen, so this bucket does not grow while it is read.
+		for (size_t i = 0; i < bucket.size(); ++i)
+		{
+			int const tile = bucket[i];
+
+			if (costs[tile] != cost)
+			{
+				continue;
+			}
+
+			int const* offsets = grid.offsets[grid.getRow(tile) & 1];
+
+			for (int direction = 0; direction < grid.direction_count; ++direction)
+			{
+				int const neighbor = tile + offsets[direction];
+				unsigned int const weight = grid.weights[neighbor];
+
+				if (weight && (cost + weight < costs[neighbor]))
+				{
+					costs[neighbor] = cost + weight;
+					buckets[(cost + weight) % BUCKET_RING_SIZE].push_back(neighbor);
+					++pending;
+				}
+			}
+		}
+
+		pending -= bucket.size();
+		bucket.clear();
+	}
+}
+
+// Draws goals for one start from the tiles it reached, spread evenly over the cost buckets.
+static void pickGoals(Grid const& grid, int start, vector<unsigned int> const& costs,
+                      Options const& options, mt19937_64& generator, vector<Scenario>& scenarios)
+{
+	vector<unsigned long long> histogram;
+
+	for (size_t tile = 0; tile < costs.size(); ++tile)
+	{
+		if ((costs[tile] != UNREACHED) && costs[tile])
+		{
+			size_t const bucket = costs[tile] / options.bucket_width;
+
+			if (histogram.size() <= bucket)
+			{
+				histogram.resize(bucket + 1, 0);
+			}
+
+			++histogram[bucket];
+		}
+	}
+
+	vector<size_t> non_empty;
+
+	for (size_t bucket = 0; bucket < histogram.size(); ++bucket)
+	{
+		if (histogram[bucket])
+		{
+			non_empty.push_back(bucket);
+		}
+	}
+
+	if (non_empty.empty())
+	{
+		return;
+	}
+
+	// Ask each chosen bucket for a number of goals, then fill every request in one pass with
+	// reservoir sampling.
+	vector<int> requests(histogram.size(), 0);
+	for (int i = 0; i < options.goals_per_start; ++i)
+	{
+		++requests[non_empty[drawUnsigned(generator, non_empty.size() - 1)]];
+	}
+
+	vector<vector<int> > reservoirs(histogram.size());
+	vector<unsigned long long> seen(histogram.size(), 0);
+
+	for (size_t tile = 0; tile < costs.size(); ++tile)
+	{
+		if ((costs[tile] == UNREACHED) || !costs[tile])
+		{
+			continue;
+		}
+
+		size_t const bucket = costs[tile] / options.bucket_width;
+
+		if (!requests[bucket])
+		{
+			continue;
+		}
+
+		unsigned long long const index = seen[bucket]++;
+
+		if (reservoirs[bucket].size() < static_cast<size_t>(requests[bucket]))
+		{
+			reservoirs[bucket].push_back(static_cast<int>(tile));
+		}
+		else
+		{
+			unsigned long long const slot = drawUnsigned(generator, index);
+
+			if (slot < static_cast<unsigned long long>(requests[bucket]))
+			{
+				reservoirs[bucket][slot] = static_cast<int>(tile);
+			}
+		}
+	}
+
+	size_t const slash = options.map_file.find_last_of("/\\");
+	string const map_name = (slash == string::npos) ? options.map_file
+	                                                 : options.map_file.substr(slash + 1);
+
+	for (size_t bucket = 0; bucket < reservoirs.size(); ++bucket)
+	{
+		for (size_t i = 0; i < reservoirs[bucket].size(); ++i)
+		{
+			Scenario scenario;
+			int const goal = reservoirs[bucket][i];
+
+			scenario.bucket = static_cast<int>(bucket);
+			scenario.map_name = map_name;
+			scenario.column_count = grid.column_count;
+			scenario.row_count = grid.row_count;
+			scenario.start_row = grid.getRow(start);
+			scenario.start_column = grid.getColumn(start);
+			scenario.goal_row = grid.getRow(goal);
+			scenario.goal_column = grid.getColumn(goal);
+			scenario.optimal_cost = costs[goal];
+			scenarios.push_back(scenario);
+		}
+	}
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options)
+{
+	options.count = 1000;
+	options.goals_per_start = 10;
+	options.bucket_width = 4;
+	options.seed = 2016;
+	options.thread_count = thread::hardware_concurrency();
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--count") && (i + 1 < argc))
+		{
+			options.count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--goals-per-start") && (i + 1 < argc))
+		{
+			options.goals_per_start = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--bucket-width") && (i + 1 < argc))
+		{
+			options.bucket_width = static_cast<unsigned int>(atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--seed") && (i + 1 < argc))
+		{
+			options.seed = strtoull(argv[++i], 0, 10);
+		}
+		else if (!strcmp(argv[i], "--threads") && (i + 1 < argc))
+		{
+			options.thread_count = static_cast<unsigned int>(atoi(argv[++i]));
+		}
+		else if (argv[i][0] == '-')
+		{
+			return false;
+		}
+		else if (options.map_file.empty())
+		{
+			options.map_file = argv[i];
+		}
+		else if (options.scenario_file.empty())
+		{
+			options.scenario_file = argv[i];
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	if (options.scenario_file.empty())
+	{
+		options.scenario_file = options.map_file + ".scen";
+	}
+
+	if (!options.thread_count)
+	{
+		options.thread_count = 1;
+	}
+
+	return !options.map_file.empty() && (0 < options.count) && (0 < options.goals_per_start)
+	    && options.bucket_width;
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		cerr << "usage: " << argv[0] << " [--count N] [--goals-per-start K] [--bucket-width W]"
+		     << " [--seed S] [--threads T] <map file> [scenario file]" << endl;
+		return EXIT_FAILURE;
+	}
+
+	Clock::time_point const start_time = Clock::now();
+	Grid grid;
+	vector<int> component_sizes;
+	size_t component_count;
+
+	{
+		ifstream map_input(options.map_file.c_str());
+		TileMap tile_map;
+
+		if (!load(map_input, tile_map))
+		{
+			cerr << "Could not load " << options.map_file << endl;
+			return EXIT_FAILURE;
+		}
+
+		grid.row_count = tile_map.getRowCount();
+		grid.column_count = tile_map.getColumnCount();
+		grid.stride = grid.column_count + 2;
+		grid.direction_count = getDirectionCount(tile_map.getTopology());
+		grid.weights.assign(static_cast<size_t>(grid.row_count + 2) * grid.stride, 0);
+
+		for (int parity = 0; parity < 2; ++parity)
+		{
+			int const (*offsets)[2] = getGridOffsets(tile_map.getTopology(), parity);
+
+			for (int direction = 0; direction < grid.direction_count; ++direction)
+			{
+				grid.offsets[parity][direction] = offsets[direction][0] * grid.stride
+				                                + offsets[direction][1];
+			}
+		}
+
+		for (int row = 0; row < grid.row_count; ++row)
+		{
+			for (int column = 0; column < grid.column_count; ++column)
+			{
+				grid.weights[grid.getIndex(row, column)] = tile_map.getTile(row, column)->getWeight();
+			}
+		}
+
+		ComponentIndex components(tile_map);
+
+		components.build(options.thread_count);
+		component_count = components.getComponentCount();
+		component_sizes.assign(grid.weights.size(), 0);
+
+		for (int row = 0; row < grid.row_count; ++row)
+		{
+			for (int column = 0; column < grid.column_count; ++column)
+			{
+				component_sizes[grid.getIndex(row, column)] = static_cast<int>(
+					components.getComponentSize(row * grid.column_count + column));
+			}
+		}
+	}
+
+	double const load_time = millisecondsSince(start_time);
+	long long candidate_count = 0;
+
+	for (size_t tile = 0; tile < component_sizes.size(); ++tile)
+	{
+		if (1 < component_sizes[tile])
+		{
+			++candidate_count;
+		}
+	}
+
+	if (!candidate_count)
+	{
+		cerr << options.map_file << " has no two connected passable tiles" << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Starts are drawn up front so that they do not depend on the thread count.
+	int const start_count = (options.count + options.goals_per_start - 1) / options.goals_per_start;
+	vector<int> starts(start_count);
+	mt19937_64 generator(options.seed);
+
+	for (int i = 0; i < start_count; ++i)
+	{
+		size_t tile;
+
+		do
+		{
+			tile = static_cast<size_t>(drawUnsigned(generator, component_sizes.size() - 1));
+		}
+		while (component_sizes[tile] < 2);
+
+		starts[i] = static_cast<int>(tile);
+	}
+
+	vector<vector<Scenario> > results(start_count);
+	atomic<int> next_start(0);
+	vector<thread> workers;
+
+	for (unsigned int i = 0; i < options.thread_count; ++i)
+	{
+		workers.push_back(thread([&]()
+		{
+			vector<unsigned int> costs;
+			vector<vector<int> > buckets;
+
+			for (int index = next_start++; index < start_count; index = next_start++)
+			{
+				seed_seq sequence = { static_cast<unsigned int>(options.seed),
+				                      static_cast<unsigned int>(options.seed >> 32),
+				                      static_cast<unsigned int>(index) };
+				mt19937_64 start_generator(sequence);
+
+				computeCosts(grid, starts[index], costs, buckets);
+				pickGoals(grid, starts[index], costs, options, start_generator, results[index]);
+			}
+		}));
+	}
+
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		workers[i].join();
+	}
+
+	vector<Scenario> scenarios;
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		scenarios.insert(scenarios.end(), results[i].begin(), results[i].end());
+	}
+
+	if (static_cast<int>(scenarios.size()) > options.count)
+	{
+		scenarios.resize(options.count);
+	}
+
+	stable_sort(scenarios.begin(), scenarios.end(), [](Scenario const& lhs, Scenario const& rhs)
+	{
+		return lhs.bucket < rhs.bucket;
+	});
+
+	ofstream output(options.scenario_file.c_str());
+
+	saveScenarios(output, scenarios);
+
+	if (!output)
+	{
+		cerr << "Could not write " << options.scenario_file << endl;
+		return EXIT_FAILURE;
+	}
+
+	cout << options.scenario_file << ": " << scenarios.size() << " scenarios, "
+	     << component_count << " components, " << start_count << " starts on "
+	     << options.thread_count << " threads; load " << load_time << " ms, total "
+	     << millisecondsSince(start_time) << " ms" << endl;
+	return EXIT_SUCCESS;
+}